@@ -27,6 +27,190 @@
   */
 #define BRIDGE2_DEFAULT_COMPUTER_BAUDRATE           9600
 
+/**
+  * \def BRIDGE2_MIN_COMPUTER_BAUDRATE
+  * The lowest baudrate the computer can ask for with a baud block (see #BRIDGE2_BAUD_REQUEST_SIZE).
+  */
+#define BRIDGE2_MIN_COMPUTER_BAUDRATE               1200
+
+/**
+  * \def BRIDGE2_MAX_COMPUTER_BAUDRATE
+  * The highest baudrate the computer can ask for with a baud block (see #BRIDGE2_BAUD_REQUEST_SIZE).
+  */
+#define BRIDGE2_MAX_COMPUTER_BAUDRATE               2000000
+
+/**
+  * \def BRIDGE2_BAUD_CONFIRM_TIMEOUT
+  * Time in milliseconds given to the computer to send a block at the new baudrate after a switch. Without it the previous baudrate is restored.
+  */
+#define BRIDGE2_BAUD_CONFIRM_TIMEOUT                1000
+
+/**
+  * \def BRIDGE2_SEQ_ENTRY_HEADER_SIZE
+  * Size in bytes of the header of each answer entry in the reply to a sequence block (status byte and two bytes of length, see #BRIDGE2_SeqStatus).
+  */
+#define BRIDGE2_SEQ_ENTRY_HEADER_SIZE               3
+
+/**
+  * \def BRIDGE2_PROTOCOL_VERSION
+  * Version of the computer-to-bridge protocol implemented by this firmware, reported in the answer to a hello block.
+  */
+#define BRIDGE2_PROTOCOL_VERSION                    4
+
+/**
+  * \def BRIDGE2_HELLO_REQUEST_SIZE
+  * Size in bytes of the payload of a hello block sent by the computer to ask for new link parameters : protocol version of the computer, check type (#SM_CheckType, or #BRIDGE2_HELLO_KEEP to keep the current one) and window size (0 to keep the current one).
+  * A hello block without payload only queries the capabilities of the bridge.
+  */
+#define BRIDGE2_HELLO_REQUEST_SIZE                  3
+
+/**
+  * \def BRIDGE2_HELLO_KEEP
+  * Value of a field of a hello request meaning that the current value of the parameter has to be kept.
+  */
+#define BRIDGE2_HELLO_KEEP                          0xFF
+
+/**
+  * \def BRIDGE2_HELLO_ANSWER_SIZE
+  * Size in bytes of the payload of the hello block sent back by the bridge : protocol version, maximum payload size (3 bytes), bitmap of the supported check types (bit n set for #SM_CheckType n), maximum window size, current baudrate (4 bytes), check type and window size in use once the answer has been acknowledged.
+  * Multi-bytes fields are most significant byte first.
+  */
+#define BRIDGE2_HELLO_ANSWER_SIZE                   12
+
+/**
+  * \def BRIDGE2_BAUD_REQUEST_SIZE
+  * Size in bytes of the payload of a baud block : the baudrate asked for by the computer (most significant byte first).
+  * The bridge answers with a baud block carrying the baudrate used once the answer has been acknowledged, on the same number of bytes. A baud block without payload only queries the current baudrate.
+  * After the switch the computer has #BRIDGE2_BAUD_CONFIRM_TIMEOUT milliseconds to send a block at the new baudrate, typically the same baud block again. Otherwise the bridge goes back to the previous baudrate.
+  */
+#define BRIDGE2_BAUD_REQUEST_SIZE                   4
+
+/**
+  * \def BRIDGE2_ATR_MAX_SIZE
+  * Maximum size (in bytes) of an Answer To Reset, TS included. See ISO/IEC7816-3 section 8.2.1.
+  */
+#define BRIDGE2_ATR_MAX_SIZE                        33
+
+/**
+  * \def BRIDGE2_DEFAULT_CWI
+  * Character Waiting Integer used when the ATR does not give one for T=1 (first TB for T=1). See ISO/IEC7816-3 section 11.4.3.
+  */
+#define BRIDGE2_DEFAULT_CWI                         13
+
+/**
+  * \def BRIDGE2_DEFAULT_BWI
+  * Block Waiting Integer used when the ATR does not give one for T=1 (first TB for T=1). See ISO/IEC7816-3 section 11.4.3.
+  */
+#define BRIDGE2_DEFAULT_BWI                         4
+
+/**
+  * \def BRIDGE2_TIMING_REQUEST_SIZE
+  * Size in bytes of the payload of a timing block sent by the computer to override the waiting times used with the card : wait for the first byte of an answer and wait between two bytes, in milliseconds (4 bytes each, most significant byte first).
+  * A field set to 0 keeps the current value, both fields set to 0 go back to the values derived from the ATR. A timing block without payload only queries the current values.
+  */
+#define BRIDGE2_TIMING_REQUEST_SIZE                 8
+
+/**
+  * \def BRIDGE2_TIMING_ANSWER_SIZE
+  * Size in bytes of the payload of the timing block sent back by the bridge : wait for the first byte and wait between two bytes in milliseconds (4 bytes each, most significant byte first), TA1, CWI and BWI read in the ATR, and a flags byte (bit 0 set when the last ATR has been parsed, bit 1 set when the waiting times have been overridden by the computer).
+  */
+#define BRIDGE2_TIMING_ANSWER_SIZE                  12
+
+/**
+  * \def BRIDGE2_RESET_ANSWER_HEADER_SIZE
+  * Size in bytes of the header of the ATR block sent back by the bridge after a cold or a warm reset : status byte (see #BRIDGE2_ResetStatus), time between the release of the RST line and the end of the ATR in milliseconds (4 bytes, most significant byte first), the waiting times now in use (same layout as the answer to a timing block, see #BRIDGE2_TIMING_ANSWER_SIZE), outcome of the PPS exchange (see #BRIDGE2_PpsStatus), and Fi (2 bytes, most significant byte first) and Di now in use with the card.
+  * The bytes of the ATR follow this header.
+  */
+#define BRIDGE2_RESET_ANSWER_HEADER_SIZE            (9 + BRIDGE2_TIMING_ANSWER_SIZE)
+
+/**
+  * \def BRIDGE2_WARM_RESET_LOW_TIME
+  * Time in milliseconds during which the RST line is held low for a warm reset. ISO/IEC7816-3 section 6.2.3 asks for at least 400 clock cycles.
+  */
+#define BRIDGE2_WARM_RESET_LOW_TIME                 1
+
+/**
+  * \def BRIDGE2_DEFAULT_FI
+  * Clock rate conversion integer used by the card after a reset, until a PPS exchange. See ISO/IEC7816-3 section 7.1.
+  */
+#define BRIDGE2_DEFAULT_FI                          372
+
+/**
+  * \def BRIDGE2_DEFAULT_DI
+  * Baud rate adjustment integer used by the card after a reset, until a PPS exchange. See ISO/IEC7816-3 section 7.1.
+  */
+#define BRIDGE2_DEFAULT_DI                          1
+
+/**
+  * \def BRIDGE2_DEFAULT_FMAX
+  * Maximum clock frequency (in Hz) accepted by the card when its ATR does not give one in TA1. See ISO/IEC7816-3 section 8.3.
+  */
+#define BRIDGE2_DEFAULT_FMAX                        5000000
+
+/**
+  * \def BRIDGE2_CLOCK_REQUEST_SIZE
+  * Size in bytes of the payload of a clock block sent by the computer to change the clock of the card : the frequency asked for in Hz (most significant byte first).
+  * It is limited to the maximum frequency given by the TA1 of the ATR, 0 asks for this maximum. A clock block without payload only queries the current clock.
+  * The clock set by the reader library is restored before the next reset.
+  */
+#define BRIDGE2_CLOCK_REQUEST_SIZE                  4
+
+/**
+  * \def BRIDGE2_CLOCK_ANSWER_SIZE
+  * Size in bytes of the payload of the clock block sent back by the bridge : clock frequency of the card now in use, maximum frequency given by the ATR (#BRIDGE2_DEFAULT_FMAX when absent) in Hz and resulting duration of an ETU in nanoseconds (4 bytes each, most significant byte first).
+  */
+#define BRIDGE2_CLOCK_ANSWER_SIZE                   12
+
+/**
+  * \def BRIDGE2_RTS_ROOM_MARGIN
+  * With RTS/CTS flow control (see BRIDGE2_SetRtsFlowCtrl()), RTS is deasserted when less than this number of bytes is left in the reception buffer (windowed mode).
+  * It covers the bytes the computer may still send after the deassertion (FIFO of a USB to serial adapter).
+  */
+#define BRIDGE2_RTS_ROOM_MARGIN                     64
+
+/**
+  * \def BRIDGE2_RX_ERR_PARITY
+  * Flag given to BRIDGE2_ProcessRxError() for a parity error. The flags can be combined.
+  */
+#define BRIDGE2_RX_ERR_PARITY                       ((uint32_t)(0x00000001))
+
+/**
+  * \def BRIDGE2_RX_ERR_FRAMING
+  * Flag given to BRIDGE2_ProcessRxError() for a framing error (no stop bit).
+  */
+#define BRIDGE2_RX_ERR_FRAMING                      ((uint32_t)(0x00000002))
+
+/**
+  * \def BRIDGE2_RX_ERR_NOISE
+  * Flag given to BRIDGE2_ProcessRxError() when noise has been detected on a received byte.
+  */
+#define BRIDGE2_RX_ERR_NOISE                        ((uint32_t)(0x00000004))
+
+/**
+  * \def BRIDGE2_RX_ERR_OVERRUN
+  * Flag given to BRIDGE2_ProcessRxError() when a byte has been received before the previous one has been read.
+  */
+#define BRIDGE2_RX_ERR_OVERRUN                      ((uint32_t)(0x00000008))
+
+/**
+  * \def BRIDGE2_RX_ERR_OTHER
+  * Flag given to BRIDGE2_ProcessRxError() for any other reception error (DMA transfer error ...).
+  */
+#define BRIDGE2_RX_ERR_OTHER                        ((uint32_t)(0x00000010))
+
+/**
+  * \def BRIDGE2_RX_RING_SIZE
+  * Size (in bytes) of the ring in which BRIDGE2_PushRxByte() stores the bytes received from the computer until BRIDGE2_ProcessRxRing() parses them. It has to be a power of two.
+  */
+#define BRIDGE2_RX_RING_SIZE                        1024
+
+
+/**
+  * \def BRIDGE2_OUT_QUEUE_SIZE
+  * Maximum number of blocks waiting for the transmission state machine to be free (see BRIDGE2_OutQueue).
+  */
+#define BRIDGE2_OUT_QUEUE_SIZE                      4
+
 
 /**
  * \enum BRIDGE2_Status
@@ -42,6 +226,143 @@ enum BRIDGE2_Status{
 };
 
 
+/**
+ * \enum BRIDGE2_SeqStatus
+ * This type is used to encode the outcome of each card exchange of a sequence block (#SM_SEQUENCE_BLOCK).
+ * The payload of a sequence block is a list of commands, each one is two bytes of length (most significant byte first) followed by the bytes to be sent to the card.
+ * The bridge executes them in order and answers with a single sequence block whose payload is a list of entries : one status byte, two bytes of length (most significant byte first) and the bytes received from the card.
+ */
+typedef enum BRIDGE2_SeqStatus BRIDGE2_SeqStatus;
+enum BRIDGE2_SeqStatus{
+	BRIDGE2_SEQ_OK                   = (uint8_t)(0x00),         /*!< The command has been sent and the card has answered.                                                  */
+	BRIDGE2_SEQ_NO_ANSWER            = (uint8_t)(0x01),         /*!< The command has been sent but the card has not answered before the timeout.                           */
+	BRIDGE2_SEQ_CARD_ERR             = (uint8_t)(0x02),         /*!< The reader library reported an error while exchanging with the card.                                  */
+	BRIDGE2_SEQ_TRUNCATED            = (uint8_t)(0x03),         /*!< The answer of the card does not fit in the reply, only its beginning is returned.                     */
+	BRIDGE2_SEQ_MALFORMED            = (uint8_t)(0x04)          /*!< The remaining bytes of the sequence can not be parsed as a command, they have not been sent. Always the last entry.  */
+};
+
+
+/**
+ * \enum BRIDGE2_ResetStatus
+ * This type is used to encode the outcome of a cold or a warm reset of the card, reported in the first byte of the ATR block sent back by the bridge (see #BRIDGE2_RESET_ANSWER_HEADER_SIZE).
+ */
+typedef enum BRIDGE2_ResetStatus BRIDGE2_ResetStatus;
+enum BRIDGE2_ResetStatus{
+	BRIDGE2_RST_OK                   = (uint8_t)(0x00),         /*!< The card has answered with a complete ATR, the waiting times are derived from it.                     */
+	BRIDGE2_RST_NO_ATR               = (uint8_t)(0x01),         /*!< The card has not answered to the reset.                                                               */
+	BRIDGE2_RST_MALFORMED            = (uint8_t)(0x02),         /*!< The card has answered but the ATR is malformed or incomplete, the default waiting times are used.     */
+	BRIDGE2_RST_CARD_ERR             = (uint8_t)(0x03)          /*!< The reader library reported an error while resetting the card or receiving the ATR.                   */
+};
+
+
+/**
+ * \enum BRIDGE2_PpsStatus
+ * This type is used to encode the outcome of the PPS exchange performed after a reset when it is enabled (see BRIDGE2_SetAutoPps()). See ISO/IEC7816-3 section 9.
+ */
+typedef enum BRIDGE2_PpsStatus BRIDGE2_PpsStatus;
+enum BRIDGE2_PpsStatus{
+	BRIDGE2_PPS_NONE                 = (uint8_t)(0x00),         /*!< No PPS has been attempted (disabled, no ATR, no TA1 or TA1 with reserved values), the default Fi and Di are used.  */
+	BRIDGE2_PPS_OK                   = (uint8_t)(0x01),         /*!< The card has accepted the Fi and Di of its TA1, they are now used.                                    */
+	BRIDGE2_PPS_SPECIFIC             = (uint8_t)(0x02),         /*!< The card is in specific mode (TA2 present), the Fi and Di of its TA1 are used without any PPS.        */
+	BRIDGE2_PPS_REFUSED              = (uint8_t)(0x03),         /*!< The card has answered the PPS request keeping the default Fi and Di.                                  */
+	BRIDGE2_PPS_FAILED               = (uint8_t)(0x04)          /*!< The card has not answered the PPS request or its answer is wrong. The computer should reset the card. */
+};
+
+
+/**
+ * \enum BRIDGE2_CardFraming
+ * This type selects how the bridge detects the end of an answer from the card (see BRIDGE2_SetCardFraming()).
+ * With a T=1 framing, the prologue (NAD, PCB, LEN) is parsed as the bytes arrive and the reception stops right after the epilogue. The silence timeout is kept for malformed answers (LEN of 0xFF, missing bytes).
+ */
+typedef enum BRIDGE2_CardFraming BRIDGE2_CardFraming;
+enum BRIDGE2_CardFraming{
+	BRIDGE2_CARD_FRAMING_NONE        = (uint32_t)(0x00000000),  /*!< The answer ends when the card has been silent for #BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT milliseconds.  */
+	BRIDGE2_CARD_FRAMING_T1_LRC      = (uint32_t)(0x00000001),  /*!< The answer is a T=1 block with a one byte LRC epilogue.                                            */
+	BRIDGE2_CARD_FRAMING_T1_CRC      = (uint32_t)(0x00000002)   /*!< The answer is a T=1 block with a two bytes CRC epilogue.                                          */
+};
+
+
+/**
+ * \def BRIDGE2_T1_PROLOGUE_SIZE
+ * Size (in bytes) of the prologue of a T=1 block : NAD, PCB and LEN. See ISO/IEC7816-3 section 11.3.1.
+ */
+#define BRIDGE2_T1_PROLOGUE_SIZE                    3
+
+
+/**
+ * \struct BRIDGE2_CardTiming
+ * Parameters read in the ATR of the card and waiting times derived from them (see BRIDGE2_GetCardTiming()).
+ * The Character Waiting Time (CWT) is the wait between two bytes of an answer, the Block Waiting Time (BWT) is the wait for its first byte. See ISO/IEC7816-3 section 11.4.3.
+ */
+typedef struct BRIDGE2_CardTiming BRIDGE2_CardTiming;
+struct BRIDGE2_CardTiming{
+	uint32_t flagAtrParsed;                                     /*!< Set when the ATR received after the last reset has been parsed, the default values are used otherwise.  */
+	uint8_t ta1;                                                /*!< TA1 byte (Fi and Di offered by the card), 0x11 when absent.                                    */
+	uint32_t flagSpecificMode;                                  /*!< Set when TA2 is present, the card does not accept a PPS request.                              */
+	uint8_t ta2;                                                /*!< TA2 byte, only meaningful when #flagSpecificMode is set.                                      */
+	uint8_t protocol;                                           /*!< First protocol offered by the card (in TD1), 0 when absent.                                   */
+	uint8_t cwi;                                                /*!< Character Waiting Integer, #BRIDGE2_DEFAULT_CWI when absent.                                  */
+	uint8_t bwi;                                                /*!< Block Waiting Integer, #BRIDGE2_DEFAULT_BWI when absent.                                      */
+	uint32_t flagOverridden;                                    /*!< Set when the waiting times have been given by the computer in a timing block.                 */
+	uint32_t firstByteTimeout;                                  /*!< Wait in milliseconds for the first byte of an answer (BWT).                                   */
+	uint32_t interByteTimeout;                                  /*!< Wait in milliseconds between two bytes of an answer (CWT), and to send one byte.              */
+};
+
+
+/**
+ * \struct BRIDGE2_RxErrorCounters
+ * Number of reception errors reported on the serial link with the computer since BRIDGE2_Init() (see BRIDGE2_GetRxErrorCounters()).
+ */
+typedef struct BRIDGE2_RxErrorCounters BRIDGE2_RxErrorCounters;
+struct BRIDGE2_RxErrorCounters{
+	uint32_t nbParityErrors;                                    /*!< Number of parity errors (#BRIDGE2_RX_ERR_PARITY).                                             */
+	uint32_t nbFramingErrors;                                   /*!< Number of framing errors (#BRIDGE2_RX_ERR_FRAMING).                                           */
+	uint32_t nbNoiseErrors;                                     /*!< Number of noise errors (#BRIDGE2_RX_ERR_NOISE).                                               */
+	uint32_t nbOverrunErrors;                                   /*!< Number of overrun errors (#BRIDGE2_RX_ERR_OVERRUN).                                           */
+	uint32_t nbOtherErrors;                                     /*!< Number of other reception errors (#BRIDGE2_RX_ERR_OTHER).                                     */
+	uint32_t nbResyncs;                                         /*!< Number of times the block being received has been dropped, after an error or bytes which could not be parsed.  */
+};
+
+
+/**
+ * \struct BRIDGE2_RxRing
+ * Single producer / single consumer ring between the UART reception interrupt (BRIDGE2_PushRxByte()) and the context parsing the bytes (BRIDGE2_ProcessRxRing()).
+ * Each index is written by one side only, so that no lock is needed. The indexes are free running, they are reduced modulo #BRIDGE2_RX_RING_SIZE when accessing the array.
+ */
+typedef struct BRIDGE2_RxRing BRIDGE2_RxRing;
+struct BRIDGE2_RxRing{
+	uint8_t array[BRIDGE2_RX_RING_SIZE];                        /*!< Bytes received from the computer and not parsed yet.                                           */
+	volatile uint32_t writeIndex;                               /*!< Number of bytes pushed since BRIDGE2_Init(), only written by the producer.                     */
+	volatile uint32_t readIndex;                                /*!< Number of bytes parsed since BRIDGE2_Init(), only written by the consumer.                     */
+	volatile uint32_t flagOverflow;                             /*!< Set by the producer when a byte has been lost because the ring was full, cleared by the consumer.  */
+};
+
+
+/**
+ * \struct BRIDGE2_OutBlock
+ * Block waiting in the #BRIDGE2_OutQueue to be handed over to the transmission state machine.
+ */
+typedef struct BRIDGE2_OutBlock BRIDGE2_OutBlock;
+struct BRIDGE2_OutBlock{
+	SM_CtrlBlockType type;                                      /*!< Type of the block.                                                                             */
+	BUFF_Buffer *pBuffer;                                       /*!< Payload of the block, NULL if there is none. It must not be modified until the block is sent.  */
+	BRIDGE2_Status (*onStarted)(void);                          /*!< Called once the state machine has started to send the block, NULL if nothing has to be done.   */
+};
+
+
+/**
+ * \struct BRIDGE2_OutQueue
+ * Blocks to be sent to the computer, in order. They are handed over to the state machine by BRIDGE2_ProcessTimerInterrupt() when it is free instead of waiting for it.
+ * It is only accessed from the processing context, the transmission interrupt only asks for the processing to run again (see SM_BlockSentCallback()).
+ */
+typedef struct BRIDGE2_OutQueue BRIDGE2_OutQueue;
+struct BRIDGE2_OutQueue{
+	BRIDGE2_OutBlock blocks[BRIDGE2_OUT_QUEUE_SIZE];            /*!< Circular array of the waiting blocks.                                                          */
+	uint32_t readIndex;                                         /*!< Index of the oldest waiting block.                                                             */
+	volatile uint32_t nbBlocks;                                 /*!< Number of waiting blocks.                                                                      */
+};
+
+
 /**
  * \enum BRIDGE2_State
  */
@@ -63,32 +384,89 @@ struct BRIDGE2_Handle{
 	BRIDGE2_State state;                                        /*!<  */
 	SEM_Handle processBusyMutex;                                /*!< Mutex used to lock the context when we are already processing a received block. */
 	BUFF_Buffer cardRcvdBytes;                                  /*!< Buffer used to store the data received from the card. */
-	BUFF_Buffer computerRcvdBytes;                              /*!< Buffer used to store the data received from the computer. */
+	BUFF_Buffer computerRcvdBytes;                              /*!< Buffer used to store the data received from the computer (windowed mode). */
+	uint8_t computerRcvdData[BUFF_MAX_SIZE];                    /*!< Array in which the payload of a block received from the computer is made contiguous before being sent to the card. */
+	SM_LinearBuffer computerRcvdBlock;                          /*!< Descriptor of #computerRcvdData, the payload of the data blocks received from the computer in stop-and-wait mode directly lands in it. */
+	uint8_t cardRcvdData[BUFF_MAX_SIZE];                        /*!< Array used to collect the answer of the card to each command of a sequence block. */
 	uint32_t flagDataBlockReceived;                             /*!< Flag used to indicate that a data block has been received. If 0 no data block received.  */
 	uint32_t flagCtrlBlockReceived;                             /*!< Flag used to indicate that a control block has been received. If 0 no data block received.  */
 	uint32_t flagAckExpected;                                   /*!< Flag used to indicate that we are waiting for an ACK block after having sent the data back to the computer. */
 	uint32_t flagAckReceived;                                   /*!< Flag used to indicate that we have received the ACK from the computer (after having sent the data back to the computer). */
 	SM_CtrlBlockType rcvdBlockType;                             /*!< Type of the last received Block.  */
+	uint32_t computerBaudrate;                                  /*!< Baudrate currently used for the serial communication with the computer. */
+	uint32_t flagLinkSettingsPending;                           /*!< Set when a hello block has asked for new link parameters, they are applied once the answer has been acknowledged (stop-and-wait mode). */
+	SM_CheckType pendingCheckType;                              /*!< Check type to be applied when #flagLinkSettingsPending is set. */
+	uint32_t pendingWindowSize;                                 /*!< Window size to be applied when #flagLinkSettingsPending is set. */
+	uint32_t flagBaudratePending;                               /*!< Set when a baud block has asked for a new baudrate, it is applied once the answer has been acknowledged (stop-and-wait mode). */
+	uint32_t pendingBaudrate;                                   /*!< Baudrate to be applied when #flagBaudratePending is set. */
+	uint32_t previousBaudrate;                                  /*!< Baudrate restored if the current one is not confirmed in time. */
+	uint32_t baudrateConfirmCountdown;                          /*!< Time in milliseconds left to the computer to confirm the current baudrate. 0 when it is confirmed. */
+	uint32_t flagBaudrateRevertPending;                         /*!< Set by the tick when the current baudrate has not been confirmed in time, the previous one is restored on the next processing. */
+	uint32_t flagRtsFlowCtrl;                                   /*!< If 0, RTS/CTS flow control is not used and the RTS line is never driven. */
+	uint32_t flagRtsAsserted;                                   /*!< Current state of the RTS line given to BRIDGE2_SetRts_Callback(). */
+	uint32_t flagCardExchangeOngoing;                           /*!< Set while the bridge is exchanging with the card, RTS is then deasserted. */
+	BRIDGE2_RxErrorCounters rxErrors;                           /*!< Reception errors on the serial link with the computer. */
+	uint32_t flagResyncPending;                                 /*!< Set when the block being received has to be dropped but the reception context was busy, it is done on the next byte or processing. */
+	BRIDGE2_CardFraming cardFraming;                            /*!< How the end of the answers from the card is detected. */
+	uint8_t cardAtr[BRIDGE2_ATR_MAX_SIZE];                      /*!< ATR received after the last reset of the card. */
+	uint32_t cardAtrSize;                                       /*!< Size of #cardAtr, 0 if the card has not answered. */
+	BRIDGE2_CardTiming cardTiming;                              /*!< Waiting times used when receiving from the card. */
+	BRIDGE2_RxRing rxRing;                                      /*!< Bytes received from the computer waiting to be parsed (see BRIDGE2_PushRxByte()). */
+	uint32_t flagCutThrough;                                    /*!< If 0, a data block is sent to the card once it has been completely received (see BRIDGE2_SetCutThrough()). */
+	volatile uint32_t flagCutThroughOngoing;                    /*!< Set while the payload of the data block being received is forwarded to the card. */
+	volatile uint32_t flagCutThroughRestart;                    /*!< Set when the payload of a new data block starts, the forwarding starts again from its first byte. */
+	uint32_t cutThroughNbExpected;                              /*!< Size of the payload being forwarded. */
+	uint32_t cutThroughNbSent;                                  /*!< Number of payload bytes already sent to the card. */
+	uint32_t flagAnswerStreaming;                               /*!< If 0, the answer of the card is sent to the computer once it has been completely received (see BRIDGE2_SetAnswerStreaming()). */
+	uint32_t flagAutoPps;                                       /*!< If 0, the card keeps the default Fi and Di after a reset (see BRIDGE2_SetAutoPps()). */
+	BRIDGE2_PpsStatus ppsStatus;                                /*!< Outcome of the PPS exchange following the last reset. */
+	uint32_t cardFi;                                            /*!< Fi currently used with the card. */
+	uint32_t cardDi;                                            /*!< Di currently used with the card. */
+	uint32_t cardDefaultFreq;                                   /*!< Clock frequency of the card set by the reader library, 0 as long as it has not been changed by a clock block. */
+	BRIDGE2_OutQueue outQueue;                                  /*!< Blocks waiting for the transmission state machine to be free. */
+	uint32_t flagReceptionPending;                              /*!< Set when the next reception could not be started because the reception context was busy, it is started on the next processing. */
 };
 
 
 /* Public functions definitions ... */
 BRIDGE2_Status BRIDGE2_Init(READER_HAL_CommSettings *pCommSettings);
+BRIDGE2_Status BRIDGE2_SetWindowSize(uint32_t windowSize);
+BRIDGE2_Status BRIDGE2_SetCheckType(SM_CheckType checkType);
+BRIDGE2_Status BRIDGE2_SetComputerBaudrate(uint32_t baudrate);
+BRIDGE2_Status BRIDGE2_SetRtsFlowCtrl(uint32_t flagEnable);
+BRIDGE2_Status BRIDGE2_SetCardFraming(BRIDGE2_CardFraming framing);
+BRIDGE2_Status BRIDGE2_SetCutThrough(uint32_t flagEnable);
+BRIDGE2_Status BRIDGE2_SetAnswerStreaming(uint32_t flagEnable);
+BRIDGE2_Status BRIDGE2_SetAutoPps(uint32_t flagEnable);
+BRIDGE2_Status BRIDGE2_GetNbDroppedBytes(uint32_t *pNbDroppedBytes);
+BRIDGE2_Status BRIDGE2_GetRxErrorCounters(BRIDGE2_RxErrorCounters *pCounters);
+BRIDGE2_Status BRIDGE2_GetCardTiming(BRIDGE2_CardTiming *pTiming);
 BRIDGE2_Status BRIDGE2_Run(void);
 BRIDGE2_Status BRIDGE2_Stop(void);
 
+BRIDGE2_Status BRIDGE2_ProcessTick(uint32_t nbElapsedMs);
 BRIDGE2_Status BRIDGE2_ProcessTimerInterrupt(void);
+BRIDGE2_Status BRIDGE2_RequestProcessing_Callback(void);
 BRIDGE2_Status BRIDGE2_EnableTimerInterrupt_Callback(void);
 BRIDGE2_Status BRIDGE2_DisableTimerInterrupt_Callback(void);
 
 BRIDGE2_Status BRIDGE2_ProcessTxeInterrupt(uint8_t *pByteToSend);
+BRIDGE2_Status BRIDGE2_ProcessTxeBytes(uint8_t *pBytesToSend, uint32_t maxNbBytes, uint32_t *pNbBytes);
+BRIDGE2_Status BRIDGE2_ProcessTxComplete(void);
 BRIDGE2_Status BRIDGE2_EnableTxeInterrupt_Callback(void);
 BRIDGE2_Status BRIDGE2_DisableTxeInterrupt_Callback(void);
 
 BRIDGE2_Status BRIDGE2_ProcessRxneInterrupt(uint8_t rcvdByte);
+BRIDGE2_Status BRIDGE2_ProcessRxBytes(const uint8_t *pRcvdBytes, uint32_t nbBytes);
+BRIDGE2_Status BRIDGE2_ProcessRxError(uint32_t errorFlags);
+BRIDGE2_Status BRIDGE2_PushRxByte(uint8_t rcvdByte);
+BRIDGE2_Status BRIDGE2_ProcessRxRing(uint32_t maxNbBytes);
 BRIDGE2_Status BRIDGE2_EnableRxneInterrupt_Callback(void);
 BRIDGE2_Status BRIDGE2_DisableRxneInterrupt_Callback(void);
 
+BRIDGE2_Status BRIDGE2_SetComputerBaudrate_Callback(uint32_t baudrate);
+BRIDGE2_Status BRIDGE2_SetRts_Callback(uint32_t flagReady);
+
 
 BRIDGE2_Status BRIDGE2_Sleep_Callback(void);
 
@@ -58,7 +58,11 @@ BUFF_Status BUFF_Init(BUFF_Buffer *pBuffer);
 BUFF_Status BUFF_IsEmpty(BUFF_Buffer *pBuffer);
 BUFF_Status BUFF_IsFull(BUFF_Buffer *pBuffer);
 BUFF_Status BUFF_Enqueue(BUFF_Buffer *pBuffer, uint8_t byte);
+BUFF_Status BUFF_EnqueueBytes(BUFF_Buffer *pBuffer, const uint8_t *pBytes, uint32_t nbBytes);
 BUFF_Status BUFF_Dequeue(BUFF_Buffer *pBuffer, uint8_t *pByte);
+BUFF_Status BUFF_DequeueBytes(BUFF_Buffer *pBuffer, uint8_t *pBytes, uint32_t nbBytes);
+BUFF_Status BUFF_Rewind(BUFF_Buffer *pBuffer, uint32_t nbBytes);
+BUFF_Status BUFF_DropLast(BUFF_Buffer *pBuffer, uint32_t nbBytes);
 BUFF_Status BUFF_GetCurrentSize(BUFF_Buffer *pBuffer, uint32_t *pCurrentSize);
 BUFF_Status BUFF_EmptyIt(BUFF_Buffer *pBuffer);
 BUFF_Status BUFF_Move(BUFF_Buffer *pBuffDest, BUFF_Buffer *pBuffSrc);
@@ -15,6 +15,51 @@
 
 
 
+/**
+ * \def SM_MAX_WINDOW_SIZE
+ * Maximum number of blocks which can be in flight (sent and not yet acknowledged) when the state machine runs in windowed mode.
+ * This is also the maximum number of received blocks which can be queued in the reception context, waiting to be released by the application.
+ */
+#define SM_MAX_WINDOW_SIZE                     ((uint32_t)(8))
+
+/**
+ * \def SM_DEFAULT_WINDOW_SIZE
+ * Window size set by #SM_Init(). A window size of 1 selects the legacy stop-and-wait protocol (no sequence numbers on the wire, every block is acknowledged before the next one can be sent).
+ */
+#define SM_DEFAULT_WINDOW_SIZE                 ((uint32_t)(1))
+
+/**
+ * \def SM_INITIAL_ACK_TIMEOUT
+ * Retransmission timeout (in milliseconds) used while waiting for an ACK, before any round trip time has been measured.
+ */
+#define SM_INITIAL_ACK_TIMEOUT                 ((uint32_t)(500))
+
+/**
+ * \def SM_MIN_ACK_TIMEOUT
+ * Lower bound (in milliseconds) of the retransmission timeout computed from the round trip time estimation.
+ */
+#define SM_MIN_ACK_TIMEOUT                     ((uint32_t)(20))
+
+/**
+ * \def SM_MAX_ACK_TIMEOUT
+ * Upper bound (in milliseconds) of the retransmission timeout, including its exponential backoff.
+ */
+#define SM_MAX_ACK_TIMEOUT                     ((uint32_t)(4000))
+
+/**
+ * \def SM_MAX_NB_RETRIES
+ * Number of times a block is sent again (on timeout or on NACK) before the transmission is given up and #SM_AckTimeoutCallback() is called.
+ */
+#define SM_MAX_NB_RETRIES                      ((uint32_t)(3))
+
+/**
+ * \def SM_RESUME_QUIET_TIME
+ * Time (in milliseconds) without any dropped byte after which a READY block is sent to the computer to end the pause requested by a BUSY block (see #SM_PauseReception()).
+ */
+#define SM_RESUME_QUIET_TIME                   ((uint32_t)(10))
+
+
+
 /**
  * \enum SM_Status
  * This type is used to encode the returned execution code of all the functions interacting with the state machine.
@@ -45,7 +90,10 @@ enum SM_RcvState{
 	SM_RCVSTATE_TRANSMITTED_ACK          = (uint32_t)(0x00000006),       /*!< State where we go when the transmission state machine has sent the ACK.    */
 	SM_RCVSTATE_ACK_CTRL_BYTE            = (uint32_t)(0x00000007),       /*!< State where we receive the control block of the ACK we are receiving the for transmission state machine.   */
 	SM_RCVSTATE_ACK_CHECK                = (uint32_t)(0x00000008),       /*!< State where we receive the check byte of the ACK we are receiving the for transmission state machine.          */
-	SM_RCVSTATE_CHECK                    = (uint32_t)(0x00000009)        /*!< State when receiving CEHCK byte of the current block                     */
+	SM_RCVSTATE_CHECK                    = (uint32_t)(0x00000009),       /*!< State when receiving CEHCK byte of the current block                     */
+	SM_RCVSTATE_SEQ                      = (uint32_t)(0x0000000A),       /*!< State when receiving the sequence number of the current block (windowed mode only).       */
+	SM_RCVSTATE_CHECK_MSB                = (uint32_t)(0x0000000B),       /*!< State when receiving the first CHECK byte of the current block (CRC-16 only).              */
+	SM_RCVSTATE_ACK_CHECK_MSB            = (uint32_t)(0x0000000C)        /*!< State when receiving the first CHECK byte of the ACK following the current block (CRC-16 only).   */
 };
 
 
@@ -64,7 +112,10 @@ enum SM_SendState{
 	SM_SENDSTATE_RCVD_ACK                = (uint32_t)(0x00000006),       /*!< State where we go when the ACK has been received by the reception state machine      */
 	SM_SENDSTATE_ACK_CTRL_BYTE           = (uint32_t)(0x00000007),       /*!< State where we transmit the control byte of the ACK we are transmitting for the reception state machine.      */
 	SM_SENDSTATE_ACK_CHECK               = (uint32_t)(0x00000008),       /*!< State where we transmit the check byte of the ACK we are transmitting for the reception state machine.      */
-	SM_SENDSTATE_CHECK                   = (uint32_t)(0x00000009)        /*!< State when sending CHECK byte of the current block.                        */
+	SM_SENDSTATE_CHECK                   = (uint32_t)(0x00000009),       /*!< State when sending CHECK byte of the current block.                        */
+	SM_SENDSTATE_SEQ                     = (uint32_t)(0x0000000A),       /*!< State when sending the sequence number of the current block (windowed mode only).         */
+	SM_SENDSTATE_CHECK_MSB               = (uint32_t)(0x0000000B),       /*!< State when sending the first CHECK byte of the current block (CRC-16 only).                */
+	SM_SENDSTATE_ACK_CHECK_MSB           = (uint32_t)(0x0000000C)        /*!< State when sending the first CHECK byte of the ACK we are transmitting for the reception state machine (CRC-16 only).   */
 };
 
 
@@ -80,7 +131,51 @@ enum SM_CtrlBlockType{
 	SM_WARM_RST_BLOCK                  = (uint8_t)(0x03),
 	SM_BUSY_BLOCK                      = (uint8_t)(0x04),
 	SM_ACK_BLOCK                       = (uint8_t)(0x05),
-	SM_NACK_BLOCK                      = (uint8_t)(0x06)
+	SM_NACK_BLOCK                      = (uint8_t)(0x06),
+	SM_READY_BLOCK                     = (uint8_t)(0x07),
+	SM_SEQUENCE_BLOCK                  = (uint8_t)(0x08),
+	SM_HELLO_BLOCK                     = (uint8_t)(0x09),
+	SM_BAUD_BLOCK                      = (uint8_t)(0x0A),
+	SM_TIMING_BLOCK                    = (uint8_t)(0x0B),
+	SM_ATR_BLOCK                       = (uint8_t)(0x0C),
+	SM_CLOCK_BLOCK                     = (uint8_t)(0x0D)
+};
+
+
+/**
+ * \enum SM_CheckType
+ * This type is used to encode the integrity check carried by the CHECK field of the blocks.
+ * The check covers all the bytes of the block from the control byte to the last payload byte.
+ */
+typedef enum SM_CheckType SM_CheckType;
+enum SM_CheckType{
+	SM_CHECK_NONE                      = (uint32_t)(0x00000000),       /*!< The CHECK field is a single 0x00 byte and it is not verified (legacy behavior, default).    */
+	SM_CHECK_LRC                       = (uint32_t)(0x00000001),       /*!< The CHECK field is a single byte, exclusive-or of all the bytes of the block.                */
+	SM_CHECK_CRC16                     = (uint32_t)(0x00000002)        /*!< The CHECK field is a CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF), most significant byte first.  */
+};
+
+
+/**
+ * \struct SM_RcvdBlockInfo
+ * This structure describes a block which has been completely received in windowed mode and which is waiting to be released by the application (see #SM_ReleaseRcvdBlock()).
+ */
+typedef struct SM_RcvdBlockInfo SM_RcvdBlockInfo;
+struct SM_RcvdBlockInfo{
+	SM_CtrlBlockType type;                  /*!< Type of the received block.                                                                            */
+	uint8_t seq;                            /*!< Sequence number of the received block.                                                                 */
+	uint32_t size;                          /*!< Number of payload bytes of the block. They are stored in the reception buffer, right after the payloads of the previous queued blocks.  */
+};
+
+
+/**
+ * \struct SM_LinearBuffer
+ * This structure describes a caller-provided contiguous array in which the payload of a received data block is written (see #SM_ReceiveBlockLinear()).
+ */
+typedef struct SM_LinearBuffer SM_LinearBuffer;
+struct SM_LinearBuffer{
+	uint8_t *pData;                         /*!< Pointer on the array receiving the payload bytes.                                                      */
+	uint32_t maxSize;                       /*!< Size in bytes of the array pointed by #pData.                                                          */
+	uint32_t size;                          /*!< Number of payload bytes currently stored in the array, starting at #pData[0].                          */
 };
 
 
@@ -93,6 +188,7 @@ typedef struct SM_RcvHandle SM_RcvHandle;
 struct SM_RcvHandle{
 	SM_RcvState currentState;               /*!< Storing the current state of the communication protocol state machine.                                */
 	BUFF_Buffer *pBuffer;                   /*!< Pointer on a cyclic static buffer structure (defined in bytes_buffer.h) in order to store the received bytes.      */
+	SM_LinearBuffer *pLinearBuffer;         /*!< Pointer on a linear buffer used instead of #pBuffer to store the received bytes (see #SM_ReceiveBlockLinear()). NULL if not used.  */
 	uint32_t nbDataExpected;                /*!< Number of data bytes expected to be received for the current block of informations. This information is fed with the LEN field of teh current block. */
 	uint32_t nbDataRcvd;                    /*!< Number of data bytes currently received for the current block.                                        */
 	SM_CtrlBlockType currentBlockType;      /*!< Type of the block being currently received by the state machine.                                      */
@@ -102,6 +198,21 @@ struct SM_RcvHandle{
 	uint32_t flagAckTransmitted;            /*!< This is a flag used by the transmission state machine to notify the reception state machine that an ACK block has been transmitted. If value is 0, it means that no ACK has been transmitted. Any other value indicates that an ACK block has been transmitted by the reception state machine.  */
 	uint32_t flagRcptOngoing;               /*!< This flag is used to indicate that a reception process in ongoing (ie : a reception process has been initiated with the #SM_ReceiveBlock() function). This flag is only relevant and defined after a call to #SM_Init() function. If value is 0, no reception has been initiated. For any other value a reception process in ongoing. */
 	uint32_t flagAckRcptOccurred;           /*!< This flag is used to indicate that a ACK block reception occured during the reception process. If 0, not ACK reception occured during the reception process. If any other value, this has occurred. */
+	uint8_t currentSeq;                     /*!< Sequence number of the block being currently received (windowed mode only).                          */
+	uint8_t expectedSeq;                    /*!< Sequence number of the next block we accept from the computer (windowed mode only).                   */
+	uint32_t flagDiscardBlock;              /*!< If not 0, the block being currently received is going to be dropped (out of sequence or no room to queue it). Windowed mode only. */
+	SM_RcvdBlockInfo blocksQueue[SM_MAX_WINDOW_SIZE];   /*!< Circular queue of the received blocks waiting to be released by the application (windowed mode only).   */
+	uint32_t blocksQueueHead;               /*!< Index of the oldest block in #blocksQueue.                                                             */
+	uint32_t nbBlocksQueued;                /*!< Number of blocks currently stored in #blocksQueue.                                                     */
+	uint16_t checkValue;                    /*!< Check value computed on the fly over the bytes of the block being currently received (see #SM_CheckType).   */
+	uint8_t rcvdCheckMsb;                   /*!< First received CHECK byte of the current block (CRC-16 only).                                          */
+	SM_CtrlBlockType chainedBlockType;      /*!< Type of the ACK or NACK block received right after the current block, while an ACK was expected.      */
+	uint32_t flagPaused;                    /*!< Set when a byte had to be dropped. Every received byte is then dropped until the line has been quiet for #SM_RESUME_QUIET_TIME.   */
+	uint32_t flagPauseRequested;            /*!< Set by #SM_PauseReception(), the computer is asked to stop sending until #SM_ResumeReception() is called.        */
+	uint32_t flagNoRoom;                    /*!< Set when a block had to be discarded because the queue or the buffer is full (windowed mode only). Cleared when a block is released.  */
+	uint32_t flagHostPaused;                /*!< Set when a BUSY block has been issued to the computer and no READY block since.                                  */
+	uint32_t nbDroppedBytes;                /*!< Number of received bytes dropped because the context was locked or the reception was paused (see #SM_GetNbDroppedBytes()).      */
+	uint32_t lastDropTime;                  /*!< Time (see #SM_AdvanceTime()) of the last dropped byte.                                                           */
 };
 
 
@@ -121,6 +232,39 @@ struct SM_SendHandle{
 	uint32_t flagAckExpected;                   /*!< Flag used to indicate whether an ACK is expected to be sent to the computer. If 0, no ACK is expected to be sent. Any other value, sending ACK to the computer is expected.     */
 	uint32_t flagEmpty;                         /*!< Flag used to indicate that the transmission process is over (ie: we went through all the steps, there is nothing more to to until a new process is started). If flag is 0, the process is not over. Any other value, the process is done.     */
 	uint32_t flagSendOngoing;                   /*!< This flag is used to indicate that a transmission process in ongoing (ie : a transmission process has been initiated with the #SM_SendBlock() function). This flag is only relevant and defined after a call to #SM_Init() function. If value is 0, no transmission has been initiated. For any other value a transmission process in ongoing. */
+	uint8_t nextSeq;                            /*!< Sequence number given to the next block needing an ACK (windowed mode only).                                   */
+	uint32_t nbBlocksInFlight;                  /*!< Number of blocks sent and not yet acknowledged by the computer (windowed mode only).                          */
+	uint8_t ackSeqToSend;                       /*!< Sequence number of the last released block, to be sent in the next cumulative ACK (windowed mode only).       */
+	uint8_t ackSeqSent;                         /*!< Sequence number carried by the ACK block currently being sent (windowed mode only).                           */
+	uint32_t flagNackExpected;                  /*!< Flag used to indicate that a NACK block has to be sent to the computer because the last received block was corrupted. If 0, no NACK has to be sent.   */
+	uint8_t nackSeqToSend;                      /*!< Sequence number carried by the NACK block, it is the sequence number of the block we expect from the computer (windowed mode only).   */
+	SM_CtrlBlockType chainedBlockType;          /*!< Type of the block (ACK or NACK) being sent right after the current block.                                 */
+	uint32_t nbDataToSend;                      /*!< Payload size of the current block. Used to send it again when the computer answers with a NACK.            */
+	uint32_t nbDataSent;                        /*!< Number of payload bytes of the current block already sent.                                                 */
+	uint32_t flagStreamed;                      /*!< Flag indicating that the payload of the current block is pushed while it is being sent (see #SM_SendBlockStreamed()).  */
+	uint32_t flagStalled;                       /*!< Flag indicating that the transmission of a streamed block waits for its next payload bytes.                */
+	uint16_t checkValue;                        /*!< Check value computed on the fly over the bytes of the block being currently sent (see #SM_CheckType).      */
+	uint32_t flagFlowCtrlExpected;              /*!< Flag used to indicate that a BUSY or READY block is waiting for the transmission state machine to be free.  */
+	SM_CtrlBlockType flowCtrlBlockToSend;       /*!< Type of the flow control block (BUSY or READY) waiting to be sent.                                        */
+};
+
+
+/**
+ * \struct SM_AckTimer
+ * Retransmission timer armed while waiting for an ACK from the computer.
+ * The timeout is derived from a smoothed estimation of the round trip time (SRTT/RTTVAR, as in RFC 6298). The time base is advanced by #SM_AdvanceTime().
+ */
+typedef struct SM_AckTimer SM_AckTimer;
+struct SM_AckTimer{
+	uint32_t flagArmed;                         /*!< If 0, the timer is not running. Any other value, we are waiting for an ACK since startTime.                */
+	uint32_t startTime;                         /*!< Time (in milliseconds) at which the timer has been armed.                                                    */
+	uint32_t timeout;                           /*!< Current retransmission timeout in milliseconds.                                                             */
+	uint32_t nbRetries;                         /*!< Number of times the current block has been sent again.                                                       */
+	uint32_t flagRetransmitted;                 /*!< Set when the current block has been sent again. Its ACK is then not used to measure the round trip time (Karn's algorithm).  */
+	uint32_t flagRttMeasured;                   /*!< If 0, no round trip time has been measured yet.                                                             */
+	uint32_t srtt;                              /*!< Smoothed round trip time, in milliseconds scaled by 8.                                                      */
+	uint32_t rttvar;                            /*!< Round trip time variation, in milliseconds scaled by 4.                                                      */
+	uint32_t flagStartOnCompletion;             /*!< Set when the timer has been armed by bytes still queued in the transmitter. It is armed again when they are out (see #SM_EvolveStateOnTransmissionComplete()).  */
 };
 
 
@@ -134,25 +278,52 @@ typedef struct SM_Handle SM_Handle;
 struct SM_Handle{
 	SM_RcvHandle rcvHandle;                       /*!<Reception state machine communication context.     */
 	SM_SendHandle sendHandle;                     /*!<Transmission state machine communication context.  */
+	uint32_t windowSize;                          /*!<Maximum number of blocks in flight. 1 means stop-and-wait (default), any greater value enables the windowed mode with sequence numbers and cumulative ACKs. */
+	SM_CheckType checkType;                       /*!<Integrity check carried by the CHECK field of the blocks, in both directions.  */
+	uint32_t currentTime;                         /*!<Time base in milliseconds, advanced by #SM_AdvanceTime().                        */
+	SM_AckTimer ackTimer;                         /*!<Retransmission timer of the blocks waiting for an ACK.                            */
 };
 
 
 
 SM_Status SM_Init(SM_Handle *pHandle);
+SM_Status SM_SetWindowSize(SM_Handle *pHandle, uint32_t windowSize);
+SM_Status SM_GetWindowSize(SM_Handle *pHandle, uint32_t *pWindowSize);
+SM_Status SM_SetCheckType(SM_Handle *pHandle, SM_CheckType checkType);
+SM_Status SM_GetCheckType(SM_Handle *pHandle, SM_CheckType *pCheckType);
+SM_Status SM_ProcessTick(SM_Handle *pHandle, uint32_t nbElapsedMs);
+SM_Status SM_AdvanceTime(SM_Handle *pHandle, uint32_t nbElapsedMs);
+SM_Status SM_ProcessTimerEvents(SM_Handle *pHandle);
+SM_Status SM_GetAckTimeout(SM_Handle *pHandle, uint32_t *pTimeout);
+SM_Status SM_AckTimeoutCallback(SM_Handle *pHandle);
+SM_Status SM_PauseReception(SM_Handle *pHandle);
+SM_Status SM_ResumeReception(SM_Handle *pHandle);
+SM_Status SM_GetNbDroppedBytes(SM_Handle *pHandle, uint32_t *pNbDroppedBytes);
+SM_Status SM_DiscardRcvdBlock(SM_Handle *pHandle);
 
 /*  Public functions definitions for reception ...  */
 SM_Status SM_ReceiveBlock(SM_Handle *pHandle, BUFF_Buffer *pBuffer);
+SM_Status SM_ReceiveBlockLinear(SM_Handle *pHandle, SM_LinearBuffer *pLinearBuffer);
 SM_Status SM_EvolveStateOnByteReception(SM_Handle *pHandle, uint8_t rcvdByte);
+SM_Status SM_EvolveStateOnBytesReception(SM_Handle *pHandle, const uint8_t *pRcvdBytes, uint32_t nbBytes);
 SM_Status SM_GetRcptBufferPtr(SM_Handle *pHandle, BUFF_Buffer **ppBuffer);
 SM_Status SM_IsDataAvail(SM_Handle *pHandle);
 SM_Status SM_IsAllDataRecieved(SM_Handle *pHandle);
+SM_Status SM_GetRcvdBlockInfo(SM_Handle *pHandle, SM_CtrlBlockType *pType, uint32_t *pSize);
+SM_Status SM_ReleaseRcvdBlock(SM_Handle *pHandle);
 
 SM_Status SM_BlockRecievedCallback(SM_Handle *pHandle);
 SM_Status SM_CtrlBlockRecievedCallback(SM_Handle *pHandle);
 SM_Status SM_DataBlockRecievedCallback(SM_Handle *pHandle);
+SM_Status SM_DataPayloadStartedCallback(SM_Handle *pHandle);
 SM_Status SM_COLD_RST_BLOCK_Callback(SM_Handle *pHandle);
 SM_Status SM_WARM_RST_BLOCK_Callback(SM_Handle *pHandle);
 SM_Status SM_UNKNOWN_BLOCK_Callback(SM_Handle *pHandle);
+SM_Status SM_SEQUENCE_BLOCK_Callback(SM_Handle *pHandle);
+SM_Status SM_HELLO_BLOCK_Callback(SM_Handle *pHandle);
+SM_Status SM_BAUD_BLOCK_Callback(SM_Handle *pHandle);
+SM_Status SM_TIMING_BLOCK_Callback(SM_Handle *pHandle);
+SM_Status SM_CLOCK_BLOCK_Callback(SM_Handle *pHandle);
 SM_Status SM_ACK_BLOCK_ReceivedCallback(SM_Handle *pHandle);
 
 SM_Status SM_EnableRxneInterrupt_Callback(SM_Handle *pHandle);
@@ -161,8 +332,13 @@ SM_Status SM_DisableRxneInterrupt_Callback(SM_Handle *pHandle);
 
 /* Public functions definitions for transmission */
 SM_Status SM_SendBlock(SM_Handle *pHandle, BUFF_Buffer *pBuffer, SM_CtrlBlockType type);
+SM_Status SM_SendBlockStreamed(SM_Handle *pHandle, BUFF_Buffer *pBuffer, SM_CtrlBlockType type, uint32_t nbDataToSend);
+SM_Status SM_StreamBytes(SM_Handle *pHandle, const uint8_t *pBytes, uint32_t nbBytes);
 SM_Status SM_EvolveStateOnByteTransmission(SM_Handle *pHandle, uint8_t *pByteToSend);
+SM_Status SM_EvolveStateOnBytesTransmission(SM_Handle *pHandle, uint8_t *pBytesToSend, uint32_t maxNbBytes, uint32_t *pNbBytes);
+SM_Status SM_EvolveStateOnTransmissionComplete(SM_Handle *pHandle);
 SM_Status SM_GetSendBufferPtr(SM_Handle *pHandle, BUFF_Buffer **ppBuffer);
+SM_Status SM_IsReadyToSend(SM_Handle *pHandle, SM_CtrlBlockType type);
 
 SM_Status SM_BlockSentCallback(SM_Handle *pHandle);
 SM_Status SM_ACK_BLOCK_TransmittedCallback(SM_Handle *pHandle);
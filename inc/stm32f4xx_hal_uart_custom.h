@@ -7,3 +7,6 @@ void HAL_UART_RxCpltCallback_continuous(UART_HandleTypeDef *huart, uint16_t data
 HAL_StatusTypeDef HAL_UART_Receive_IT_continuous(UART_HandleTypeDef *huart);
 void HAL_UART_Transmit_IT_PrechargeCallback(UART_HandleTypeDef *huart, uint8_t *byteToSend, uint8_t *dataAvailable);
 HAL_StatusTypeDef HAL_UART_Transmit_IT_continuous(UART_HandleTypeDef *huart, uint8_t *pData);
+HAL_StatusTypeDef HAL_UART_Receive_DMA_continuous(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_AbortReceive_DMA_continuous(UART_HandleTypeDef *huart);
+void HAL_UART_RxEventCallback_continuous(UART_HandleTypeDef *huart);
@@ -39,12 +39,50 @@ static BRIDGE2_Handle globalBridgeHandle;  /* TODO: Put USART context into bridg
 
 
 /* Private functions definitions (functions local to this file) ...  */
-static BRIDGE2_Status BRIDGE2_SendBufferToCard(BUFF_Buffer *pBuffer);
+static BRIDGE2_Status BRIDGE2_SendBytesToCard(const uint8_t *pBytes, uint32_t nbBytes, uint32_t timeout);
 static BRIDGE2_Status BRIDGE2_RcvBufferFromCard(BUFF_Buffer *pBuffer);
+static BRIDGE2_Status BRIDGE2_RcvBytesFromCard(uint8_t *pBytes, uint32_t maxNbBytes, uint32_t *pNbBytes);
+static BRIDGE2_Status BRIDGE2_IsCardFrameComplete(const uint8_t *pPrologue, uint32_t nbRcvdBytes);
+static BRIDGE2_Status BRIDGE2_ExchangeWithCard(SM_CtrlBlockType type, const uint8_t *pBytes, uint32_t nbBytes);
+static BRIDGE2_Status BRIDGE2_RunCardExchange(SM_CtrlBlockType type, const uint8_t *pBytes, uint32_t nbBytes);
+static BRIDGE2_Status BRIDGE2_ExchangeWithCardStreamed(const uint8_t *pBytes, uint32_t nbBytes);
+static BRIDGE2_Status BRIDGE2_StreamAnswerFromCard(void);
+static BRIDGE2_Status BRIDGE2_ExecuteSequence(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer);
+static BRIDGE2_Status BRIDGE2_AppendSequenceEntry(BUFF_Buffer *pAnswer, BRIDGE2_SeqStatus status, const uint8_t *pBytes, uint32_t nbBytes);
+static BRIDGE2_Status BRIDGE2_SendAnswerToComputer(SM_CtrlBlockType type);
+static BRIDGE2_Status BRIDGE2_AnswerStarted(void);
+static BRIDGE2_Status BRIDGE2_QueueBlock(SM_CtrlBlockType type, BUFF_Buffer *pBuffer, BRIDGE2_Status (*onStarted)(void));
+static BRIDGE2_Status BRIDGE2_FlushOutQueue(void);
+static BRIDGE2_Status BRIDGE2_BuildAnswer(SM_CtrlBlockType type, const uint8_t *pBytes, uint32_t nbBytes);
+static BRIDGE2_Status BRIDGE2_ProcessHelloBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer);
+static BRIDGE2_Status BRIDGE2_ApplyPendingLinkSettings(void);
+static BRIDGE2_Status BRIDGE2_ProcessBaudBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer);
+static BRIDGE2_Status BRIDGE2_ApplyPendingBaudrate(void);
+static BRIDGE2_Status BRIDGE2_CountDownBaudrateConfirm(uint32_t nbElapsedMs);
+static BRIDGE2_Status BRIDGE2_ApplyBaudrateRevert(void);
 static BRIDGE2_Status BRIDGE2_ApplyRcvdDataBlock(void);
+static BRIDGE2_Status BRIDGE2_ForwardRcvdPayload(void);
 static BRIDGE2_Status BRIDGE2_ApplyRcvdCtrlBlock(void);
-static BRIDGE2_Status BRIDGE2_ApplyColdReset(void);
+static BRIDGE2_Status BRIDGE2_GetAnswerType(SM_CtrlBlockType type, SM_CtrlBlockType *pAnswerType);
+static BRIDGE2_Status BRIDGE2_ProcessResetBlock(SM_CtrlBlockType type, BUFF_Buffer *pAnswer);
+static BRIDGE2_Status BRIDGE2_ApplyReset(SM_CtrlBlockType type, BRIDGE2_ResetStatus *pStatus, uint32_t *pDuration);
+static BRIDGE2_Status BRIDGE2_ResetCard(SM_CtrlBlockType type, BRIDGE2_ResetStatus *pStatus, uint32_t *pDuration);
+static READER_Status BRIDGE2_DoWarmReset(void);
+static BRIDGE2_Status BRIDGE2_NegotiatePps(BRIDGE2_PpsStatus *pStatus);
+static BRIDGE2_Status BRIDGE2_DecodeTa1(uint8_t ta1, uint32_t *pFi, uint32_t *pDi, uint32_t *pFmax);
+static BRIDGE2_Status BRIDGE2_RcvAtrFromCard(void);
+static BRIDGE2_Status BRIDGE2_ParseAtr(const uint8_t *pAtr, uint32_t atrSize, BRIDGE2_CardTiming *pTiming);
+static BRIDGE2_Status BRIDGE2_UpdateCardTiming(void);
+static BRIDGE2_Status BRIDGE2_EncodeCardTiming(uint8_t *pDest);
+static BRIDGE2_Status BRIDGE2_ProcessTimingBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer);
+static BRIDGE2_Status BRIDGE2_ProcessClockBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer);
 static BRIDGE2_Status BRIDGE2_StartNewReception(void);
+static BRIDGE2_Status BRIDGE2_ProcessRcvdBlocksQueue(void);
+static BRIDGE2_Status BRIDGE2_IsWindowedMode(void);
+static BRIDGE2_Status BRIDGE2_SetCardExchangeOngoing(uint32_t flagOngoing);
+static BRIDGE2_Status BRIDGE2_UpdateRts(void);
+static BRIDGE2_Status BRIDGE2_Resync(void);
+static BRIDGE2_Status BRIDGE2_ProcessTimerEvents(void);
 
 
 
@@ -75,6 +113,55 @@ BRIDGE2_Status BRIDGE2_Init(READER_HAL_CommSettings *pCommSettings){
 	globalBridgeHandle.flagCtrlBlockReceived = 0;
 	globalBridgeHandle.flagAckExpected = 0;
 	globalBridgeHandle.flagAckReceived = 0;
+	globalBridgeHandle.computerBaudrate = BRIDGE2_DEFAULT_COMPUTER_BAUDRATE;
+	globalBridgeHandle.flagLinkSettingsPending = 0;
+	globalBridgeHandle.flagBaudratePending = 0;
+	globalBridgeHandle.previousBaudrate = BRIDGE2_DEFAULT_COMPUTER_BAUDRATE;
+	globalBridgeHandle.baudrateConfirmCountdown = 0;
+	globalBridgeHandle.flagBaudrateRevertPending = 0;
+	globalBridgeHandle.flagRtsFlowCtrl = 0;
+	globalBridgeHandle.flagRtsAsserted = 0;
+	globalBridgeHandle.flagCardExchangeOngoing = 0;
+	globalBridgeHandle.rxErrors.nbParityErrors = 0;
+	globalBridgeHandle.rxErrors.nbFramingErrors = 0;
+	globalBridgeHandle.rxErrors.nbNoiseErrors = 0;
+	globalBridgeHandle.rxErrors.nbOverrunErrors = 0;
+	globalBridgeHandle.rxErrors.nbOtherErrors = 0;
+	globalBridgeHandle.rxErrors.nbResyncs = 0;
+	globalBridgeHandle.flagResyncPending = 0;
+	globalBridgeHandle.cardFraming = BRIDGE2_CARD_FRAMING_NONE;
+	globalBridgeHandle.cardAtrSize = 0;
+	globalBridgeHandle.cardTiming.flagAtrParsed = 0;
+	globalBridgeHandle.cardTiming.ta1 = 0x11;
+	globalBridgeHandle.cardTiming.flagSpecificMode = 0;
+	globalBridgeHandle.cardTiming.ta2 = 0x00;
+	globalBridgeHandle.cardTiming.protocol = 0;
+	globalBridgeHandle.cardTiming.cwi = BRIDGE2_DEFAULT_CWI;
+	globalBridgeHandle.cardTiming.bwi = BRIDGE2_DEFAULT_BWI;
+	globalBridgeHandle.cardTiming.flagOverridden = 0;
+	globalBridgeHandle.cardTiming.firstByteTimeout = BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT;
+	globalBridgeHandle.cardTiming.interByteTimeout = BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT;
+	globalBridgeHandle.rxRing.writeIndex = 0;
+	globalBridgeHandle.rxRing.readIndex = 0;
+	globalBridgeHandle.rxRing.flagOverflow = 0;
+	globalBridgeHandle.flagCutThrough = 0;
+	globalBridgeHandle.flagAnswerStreaming = 0;
+	globalBridgeHandle.flagAutoPps = 0;
+	globalBridgeHandle.ppsStatus = BRIDGE2_PPS_NONE;
+	globalBridgeHandle.cardFi = BRIDGE2_DEFAULT_FI;
+	globalBridgeHandle.cardDi = BRIDGE2_DEFAULT_DI;
+	globalBridgeHandle.cardDefaultFreq = 0;
+	globalBridgeHandle.flagCutThroughOngoing = 0;
+	globalBridgeHandle.flagCutThroughRestart = 0;
+	globalBridgeHandle.cutThroughNbExpected = 0;
+	globalBridgeHandle.cutThroughNbSent = 0;
+	globalBridgeHandle.outQueue.readIndex = 0;
+	globalBridgeHandle.outQueue.nbBlocks = 0;
+	globalBridgeHandle.flagReceptionPending = 0;
+	
+	globalBridgeHandle.computerRcvdBlock.pData = globalBridgeHandle.computerRcvdData;
+	globalBridgeHandle.computerRcvdBlock.maxSize = BUFF_MAX_SIZE;
+	globalBridgeHandle.computerRcvdBlock.size = 0;
 	
 	smRv = SM_Init(&globalUsartHandle);
 	if(smRv != SM_OK) return BRIDGE2_ERR;
@@ -84,6 +171,251 @@ BRIDGE2_Status BRIDGE2_Init(READER_HAL_CommSettings *pCommSettings){
 }
 
 
+/**
+ * \fn BRIDGE2_Status BRIDGE2_SetWindowSize(uint32_t windowSize)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param windowSize is the number of blocks the computer and the bridge are allowed to send without waiting for their ACK. It has to be between 1 and #SM_MAX_WINDOW_SIZE.
+ * This function selects the serial protocol used with the computer. A window size of 1 (default) selects the stop-and-wait protocol, any greater value selects the windowed protocol (see #SM_SetWindowSize()).
+ * It has to be called after BRIDGE2_Init() and before BRIDGE2_Run().
+ * Warning : this function operates on the globalUsartHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_SetWindowSize(uint32_t windowSize){
+	SM_Status smRv;
+	
+	
+	if((globalBridgeHandle.state) != BRIDGE2_IDLE){
+		return BRIDGE2_ERR;
+	}
+	
+	smRv = SM_SetWindowSize(&globalUsartHandle, windowSize);
+	if(smRv != SM_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_SetCheckType(SM_CheckType checkType)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param checkType is the integrity check carried by the blocks exchanged with the computer (see #SM_CheckType).
+ * This function selects the integrity check of the serial protocol used with the computer. With #SM_CHECK_LRC or #SM_CHECK_CRC16, a corrupted block is answered with a NACK and a NACKed block is sent again (see #SM_SetCheckType()).
+ * It has to be called after BRIDGE2_Init() and before BRIDGE2_Run().
+ * Warning : this function operates on the globalUsartHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_SetCheckType(SM_CheckType checkType){
+	SM_Status smRv;
+	
+	
+	if((globalBridgeHandle.state) != BRIDGE2_IDLE){
+		return BRIDGE2_ERR;
+	}
+	
+	smRv = SM_SetCheckType(&globalUsartHandle, checkType);
+	if(smRv != SM_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_SetComputerBaudrate(uint32_t baudrate)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param baudrate is the baudrate of the serial communication with the computer. It has to be between #BRIDGE2_MIN_COMPUTER_BAUDRATE and #BRIDGE2_MAX_COMPUTER_BAUDRATE.
+ * This function selects the baudrate used when the bridge starts, the UART peripheral is reconfigured through BRIDGE2_SetComputerBaudrate_Callback(). The computer can change it afterwards with a baud block (see #BRIDGE2_BAUD_REQUEST_SIZE).
+ * It has to be called after BRIDGE2_Init() and before BRIDGE2_Run().
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_SetComputerBaudrate(uint32_t baudrate){
+	BRIDGE2_Status rv;
+	
+	
+	if((globalBridgeHandle.state) != BRIDGE2_IDLE){
+		return BRIDGE2_ERR;
+	}
+	
+	if((baudrate < BRIDGE2_MIN_COMPUTER_BAUDRATE) || (baudrate > BRIDGE2_MAX_COMPUTER_BAUDRATE)){
+		return BRIDGE2_ERR;
+	}
+	
+	rv = BRIDGE2_SetComputerBaudrate_Callback(baudrate);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	globalBridgeHandle.computerBaudrate = baudrate;
+	globalBridgeHandle.previousBaudrate = baudrate;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_SetRtsFlowCtrl(uint32_t flagEnable)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param flagEnable If 0, the RTS line is not driven by the bridge (default). Any other value enables the RTS/CTS flow control.
+ * With the flow control, RTS is deasserted through BRIDGE2_SetRts_Callback() while the bridge exchanges with the card and when the reception buffer is close to full (see #BRIDGE2_RTS_ROOM_MARGIN).
+ * The computer can then send at full rate without any byte being dropped. The CTS line is handled by the UART peripheral.
+ * It has to be called after BRIDGE2_Init() and before BRIDGE2_Run().
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_SetRtsFlowCtrl(uint32_t flagEnable){
+	BRIDGE2_Status rv;
+	
+	
+	if((globalBridgeHandle.state) != BRIDGE2_IDLE){
+		return BRIDGE2_ERR;
+	}
+	
+	globalBridgeHandle.flagRtsFlowCtrl = (flagEnable != 0);
+	
+	/* The line is asserted right away, the computer is allowed to send ...  */
+	if(flagEnable != 0){
+		globalBridgeHandle.flagRtsAsserted = 0;
+		
+		rv = BRIDGE2_UpdateRts();
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_SetCardFraming(BRIDGE2_CardFraming framing)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param framing selects how the end of the answers from the card is detected (see #BRIDGE2_CardFraming). Default is #BRIDGE2_CARD_FRAMING_NONE.
+ * With a T=1 framing, an answer is forwarded to the computer as soon as its last byte has been received instead of after #BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT milliseconds of silence.
+ * It has to be called after BRIDGE2_Init() and before BRIDGE2_Run().
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_SetCardFraming(BRIDGE2_CardFraming framing){
+	if((globalBridgeHandle.state) != BRIDGE2_IDLE){
+		return BRIDGE2_ERR;
+	}
+	
+	if((framing != BRIDGE2_CARD_FRAMING_NONE) && (framing != BRIDGE2_CARD_FRAMING_T1_LRC) && (framing != BRIDGE2_CARD_FRAMING_T1_CRC)){
+		return BRIDGE2_ERR;
+	}
+	
+	globalBridgeHandle.cardFraming = framing;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_SetCutThrough(uint32_t flagEnable)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param flagEnable if not 0, the payload of a data block is forwarded to the card while it is still being received from the computer. Default is 0.
+ * The transfer of a command then takes about the time of the slower of the two links instead of their sum. It only applies in stop-and-wait mode.
+ * The block is checked once it has been forwarded : a block dropped by the bridge (wrong check, lost bytes) has already been partially or completely sent to the card. The answer of the card to this command is dropped when the block is sent again.
+ * It has to be called after BRIDGE2_Init() and before BRIDGE2_Run().
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_SetCutThrough(uint32_t flagEnable){
+	if((globalBridgeHandle.state) != BRIDGE2_IDLE){
+		return BRIDGE2_ERR;
+	}
+	
+	globalBridgeHandle.flagCutThrough = (flagEnable != 0) ? 1 : 0;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_SetAnswerStreaming(uint32_t flagEnable)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param flagEnable if not 0, the answer of the card to a data block is sent to the computer while it is still being received from the card. Default is 0.
+ * It only applies with a T=1 framing (see BRIDGE2_SetCardFraming()) : the size of the block sent to the computer is taken from the LEN byte of the answer. If the card stops before the end of its block, the missing bytes are sent as 0x00 and the T=1 epilogue tells the computer that the answer is corrupted.
+ * Answers shorter than the T=1 prologue or with a reserved LEN byte are sent once completely received, as without this option.
+ * It has to be called after BRIDGE2_Init() and before BRIDGE2_Run().
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_SetAnswerStreaming(uint32_t flagEnable){
+	if((globalBridgeHandle.state) != BRIDGE2_IDLE){
+		return BRIDGE2_ERR;
+	}
+	
+	globalBridgeHandle.flagAnswerStreaming = (flagEnable != 0) ? 1 : 0;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_SetAutoPps(uint32_t flagEnable)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param flagEnable if not 0, the bridge asks the card for the Fi and Di offered in its TA1 right after each reset (PPS exchange, see ISO/IEC7816-3 section 9). Default is 0.
+ * The outcome and the Fi and Di in use are reported in the ATR block sent back to the computer (see #BRIDGE2_RESET_ANSWER_HEADER_SIZE). The default ones are restored before the next reset.
+ * It has to be called after BRIDGE2_Init() and before BRIDGE2_Run().
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_SetAutoPps(uint32_t flagEnable){
+	if((globalBridgeHandle.state) != BRIDGE2_IDLE){
+		return BRIDGE2_ERR;
+	}
+	
+	globalBridgeHandle.flagAutoPps = (flagEnable != 0) ? 1 : 0;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_GetNbDroppedBytes(uint32_t *pNbDroppedBytes)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pNbDroppedBytes is a pointer on the place where to write the number of bytes received from the computer and dropped since BRIDGE2_Init().
+ * Each drop makes the bridge send a BUSY block, the computer then pauses and sends the block again after the READY block (see #SM_PauseReception()).
+ * Warning : this function operates on the globalUsartHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_GetNbDroppedBytes(uint32_t *pNbDroppedBytes){
+	SM_Status smRv;
+	
+	
+	smRv = SM_GetNbDroppedBytes(&globalUsartHandle, pNbDroppedBytes);
+	if(smRv != SM_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_GetRxErrorCounters(BRIDGE2_RxErrorCounters *pCounters)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pCounters is a pointer on the place where to copy the reception error counters.
+ * The errors are reported by the target with BRIDGE2_ProcessRxError(). Each one costs the block being received, which is sent again by the computer.
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_GetRxErrorCounters(BRIDGE2_RxErrorCounters *pCounters){
+	*pCounters = globalBridgeHandle.rxErrors;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_GetCardTiming(BRIDGE2_CardTiming *pTiming)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pTiming is a pointer on the place where to copy the waiting times currently used with the card and the ATR parameters they are derived from.
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_GetCardTiming(BRIDGE2_CardTiming *pTiming){
+	*pTiming = globalBridgeHandle.cardTiming;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
 /**
  * \fn BRIDGE2_Status BRIDGE2_Run
  * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
@@ -124,12 +456,56 @@ BRIDGE2_Status BRIDGE2_Stop(void){
 }
 
 
+/**
+ * \fn BRIDGE2_Status BRIDGE2_ProcessTick(uint32_t nbElapsedMs)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param nbElapsedMs is the number of milliseconds elapsed since the previous call.
+ * This function is designed to be called from a millisecond tick interrupt routine (typically SysTick). It drives the ACK timeouts of the serial protocol (see #SM_AdvanceTime()).
+ * A lost ACK is then recovered by sending the block again, and after too many attempts the bridge goes back to waiting for a new command from the computer.
+ * It also restores the previous baudrate when a new one has not been confirmed in time (see #BRIDGE2_BAUD_CONFIRM_TIMEOUT).
+ * Only the countdowns are done here, the work itself (retransmissions, resynchronization, ...) is deferred to #BRIDGE2_ProcessTimerInterrupt() with BRIDGE2_RequestProcessing_Callback().
+ * The tick interrupt can therefore have any priority. On the STM32 target it has to stay the highest one, because the reader library relies on HAL_GetTick() while a card exchange runs from the processing interrupt, which has the lowest priority.
+ * Warning : this function operates on the globalUsartHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_ProcessTick(uint32_t nbElapsedMs){
+	BRIDGE2_Status rv;
+	SM_Status smRv;
+	uint32_t flagProcessingNeeded;
+	
+	
+	if((globalBridgeHandle.state) == BRIDGE2_IDLE){
+		return BRIDGE2_OK;
+	}
+	
+	smRv = SM_AdvanceTime(&globalUsartHandle, nbElapsedMs);
+	if((smRv != SM_OK) && (smRv != SM_NO)) return BRIDGE2_ERR;
+	
+	flagProcessingNeeded = (smRv == SM_OK);
+	
+	rv = BRIDGE2_CountDownBaudrateConfirm(nbElapsedMs);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	if(((globalBridgeHandle.flagResyncPending) != 0) || ((globalBridgeHandle.flagReceptionPending) != 0) || ((globalBridgeHandle.flagBaudrateRevertPending) != 0)){
+		flagProcessingNeeded = 1;
+	}
+	
+	if(flagProcessingNeeded != 0){
+		rv = BRIDGE2_RequestProcessing_Callback();
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
 /**
  * \fn BRIDGE2_Status BRIDGE2_ProcessTimerInterrupt(void)
  * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
  * This function is designed to be called from a periodic timer interrupt routine. It is aimed to periodically check for events/data reception from the usart interface.
  * When implementing the bridge for a specific target, the developper is in charge of configuring the timer interruption and to place a call to this function inside.
  * There is no strong requisites about the period of the interruption, few miliseconds are fine for example.
+ * The bridge also asks for an immediate call with BRIDGE2_RequestProcessing_Callback() each time there is something to process, the timer is then only a safety net.
  * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
  */
 BRIDGE2_Status BRIDGE2_ProcessTimerInterrupt(void){
@@ -141,7 +517,35 @@ BRIDGE2_Status BRIDGE2_ProcessTimerInterrupt(void){
 	if((mutexRv != SEM_LOCKED) && (mutexRv != SEM_UNLOCKED)) return BRIDGE2_ERR;
 	
 	
+	/* The timer events counted down by BRIDGE2_ProcessTick(), then the blocks and the reception which had to wait for the state machine are handled first ...  */
 	if(mutexRv == SEM_UNLOCKED){
+		rv = BRIDGE2_ProcessTimerEvents();
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		rv = BRIDGE2_FlushOutQueue();
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		if((globalBridgeHandle.flagReceptionPending) != 0){
+			rv = BRIDGE2_StartNewReception();
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		}
+	}
+	
+	if((mutexRv == SEM_UNLOCKED) && (BRIDGE2_IsWindowedMode() == BRIDGE2_OK)){
+		/* In windowed mode, the received blocks are queued by the state machine, we process all of them ...  */
+		rv = BRIDGE2_ProcessRcvdBlocksQueue();
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		mutexRv = SEM_Release(&(globalBridgeHandle.processBusyMutex));
+		if(mutexRv != SEM_OK) return BRIDGE2_ERR;
+	}
+	else if(mutexRv == SEM_UNLOCKED){
+		/* The payload of the data block being received is forwarded to the card as it arrives ...  */
+		if(((globalBridgeHandle.flagCutThroughOngoing) != 0) || ((globalBridgeHandle.flagCutThroughRestart) != 0)){
+			rv = BRIDGE2_ForwardRcvdPayload();
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		}
+		
 		/* If we have received a data block from the computer ...  */
 		if((globalBridgeHandle.flagDataBlockReceived) != 0){
 			rv = BRIDGE2_ApplyRcvdDataBlock();
@@ -151,6 +555,13 @@ BRIDGE2_Status BRIDGE2_ProcessTimerInterrupt(void){
 		}
 		
 		if((globalBridgeHandle.flagAckReceived) != 0){
+			/* The link parameters asked for in a hello block are changed between the acknowledgement of the answer and the next block ...  */
+			rv = BRIDGE2_ApplyPendingLinkSettings();
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+			
+			rv = BRIDGE2_ApplyPendingBaudrate();
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+			
 			rv = BRIDGE2_StartNewReception();
 			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
 			
@@ -178,6 +589,18 @@ BRIDGE2_Status BRIDGE2_ProcessTimerInterrupt(void){
 }
 
 
+/**
+ * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_RequestProcessing_Callback(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * The implementer of the bridge for a specific target should make its own implementation of this function because its code might be hardware dependent.
+ * It is called from the UART and tick interrupt routines when a block has been received or acknowledged. The implementation has to trigger a call to BRIDGE2_ProcessTimerInterrupt() as soon as possible, typically by pending the timer interrupt by software.
+ * Without it the block waits for the next period of the timer.
+ */
+__attribute__((weak)) BRIDGE2_Status BRIDGE2_RequestProcessing_Callback(void){
+	return BRIDGE2_OK;
+}
+
+
 /**
  * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_EnableTimerInterrupt_Callback(void)
  * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
@@ -211,38 +634,1946 @@ __attribute__((weak)) BRIDGE2_Status BRIDGE2_DisableTimerInterrupt_Callback(void
  * Warning : this function operates on the globalUsartHandle global data structure which is local to this file.
  */
 BRIDGE2_Status BRIDGE2_ProcessRxneInterrupt(uint8_t rcvdByte){
+	BRIDGE2_Status bridgeRv;
 	SM_Status rv;
 	
 	
+	if((globalBridgeHandle.flagResyncPending) != 0){
+		bridgeRv = BRIDGE2_Resync();
+		if(bridgeRv != BRIDGE2_OK) return BRIDGE2_ERR;
+	}
+	
+	/* SM_BUSY means the byte has been dropped, the computer has been asked to pause and to send the block again ...  */
 	rv = SM_EvolveStateOnByteReception(&globalUsartHandle, rcvdByte);
-	if(rv != SM_OK) return BRIDGE2_ERR;
+	
+	/* A byte which can not be parsed (corrupted byte, computer still sending at the previous baudrate ...) costs the block being received, we wait for a well-formed block ...  */
+	/* The unexpected byte may be the control byte of the next block, it is given again to the state machine once the partial block is dropped.  */
+	if(rv == SM_ERR){
+		bridgeRv = BRIDGE2_Resync();
+		if(bridgeRv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		rv = SM_BUSY;
+		if((globalBridgeHandle.flagResyncPending) == 0){
+			rv = SM_EvolveStateOnByteReception(&globalUsartHandle, rcvdByte);
+			
+			if(rv == SM_ERR){
+				bridgeRv = BRIDGE2_Resync();
+				if(bridgeRv != BRIDGE2_OK) return BRIDGE2_ERR;
+				
+				rv = SM_OK;
+			}
+		}
+	}
+	
+	if((rv != SM_OK) && (rv != SM_BUSY)) return BRIDGE2_ERR;
+	
+	/* The new payload bytes are forwarded to the card from the timer interrupt routine ...  */
+	if((globalBridgeHandle.flagCutThroughOngoing) != 0){
+		bridgeRv = BRIDGE2_RequestProcessing_Callback();
+		if(bridgeRv != BRIDGE2_OK) return BRIDGE2_ERR;
+	}
+	
+	if((globalBridgeHandle.flagRtsFlowCtrl) != 0){
+		return BRIDGE2_UpdateRts();
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_ProcessRxBytes(const uint8_t *pRcvdBytes, uint32_t nbBytes)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pRcvdBytes is a pointer on the bytes received from the computer, in their reception order.
+ * \param nbBytes is the number of received bytes.
+ * This function is the counterpart of BRIDGE2_ProcessRxneInterrupt() for the receivers delivering a whole span of bytes at once (circular DMA with idle line detection, FIFO ...).
+ * The reception interruption callbacks (BRIDGE2_EnableRxneInterrupt_Callback() and BRIDGE2_DisableRxneInterrupt_Callback()) then have to mask and unmask the delivery of the spans, the bytes received in the meantime being kept by the receiver.
+ * Warning : this function operates on the globalUsartHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_ProcessRxBytes(const uint8_t *pRcvdBytes, uint32_t nbBytes){
+	BRIDGE2_Status bridgeRv;
+	SM_Status rv;
+	
+	
+	if(nbBytes == 0){
+		return BRIDGE2_OK;
+	}
+	
+	if((globalBridgeHandle.flagResyncPending) != 0){
+		bridgeRv = BRIDGE2_Resync();
+		if(bridgeRv != BRIDGE2_OK) return BRIDGE2_ERR;
+	}
+	
+	/* SM_BUSY means the bytes have been dropped, the computer has been asked to pause and to send the block again ...  */
+	rv = SM_EvolveStateOnBytesReception(&globalUsartHandle, pRcvdBytes, nbBytes);
+	
+	/* A span which can not be parsed (corrupted bytes, computer still sending at the previous baudrate ...) is dropped with the block being received ...  */
+	if(rv == SM_ERR){
+		bridgeRv = BRIDGE2_Resync();
+		if(bridgeRv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		rv = SM_OK;
+	}
+	
+	if((rv != SM_OK) && (rv != SM_BUSY)) return BRIDGE2_ERR;
+	
+	/* The new payload bytes are forwarded to the card from the timer interrupt routine ...  */
+	if((globalBridgeHandle.flagCutThroughOngoing) != 0){
+		bridgeRv = BRIDGE2_RequestProcessing_Callback();
+		if(bridgeRv != BRIDGE2_OK) return BRIDGE2_ERR;
+	}
+	
+	if((globalBridgeHandle.flagRtsFlowCtrl) != 0){
+		return BRIDGE2_UpdateRts();
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_ProcessRxError(uint32_t errorFlags)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param errorFlags is a combination of the BRIDGE2_RX_ERR_* flags (see #BRIDGE2_RX_ERR_PARITY) describing the error.
+ * This function is designed to be called from the UART error interrupt routine, once the byte in error (if any) has been given to the bridge.
+ * The error is counted (see BRIDGE2_GetRxErrorCounters()) and the block being received is dropped. The computer sends it again as it is not acknowledged.
+ * The reception is not stopped, it is up to the implementer to keep the UART receiving (or to restart it) after an error.
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_ProcessRxError(uint32_t errorFlags){
+	BRIDGE2_RxErrorCounters *pCounters;
+	
+	
+	pCounters = &(globalBridgeHandle.rxErrors);
+	
+	if((errorFlags & BRIDGE2_RX_ERR_PARITY) != 0){
+		pCounters->nbParityErrors++;
+	}
+	if((errorFlags & BRIDGE2_RX_ERR_FRAMING) != 0){
+		pCounters->nbFramingErrors++;
+	}
+	if((errorFlags & BRIDGE2_RX_ERR_NOISE) != 0){
+		pCounters->nbNoiseErrors++;
+	}
+	if((errorFlags & BRIDGE2_RX_ERR_OVERRUN) != 0){
+		pCounters->nbOverrunErrors++;
+	}
+	if((errorFlags & BRIDGE2_RX_ERR_OTHER) != 0){
+		pCounters->nbOtherErrors++;
+	}
+	
+	
+	return BRIDGE2_Resync();
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_PushRxByte(uint8_t rcvdByte)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param rcvdByte is the value of the early received byte in the UART interrupt routine.
+ * This function is an alternative to BRIDGE2_ProcessRxneInterrupt() keeping the reception interrupt as short as possible : the byte is only stored in a ring, it is parsed later by BRIDGE2_ProcessRxRing().
+ * It does not touch the protocol state machine and takes no lock. It has to be called from a single context (the producer).
+ * When the ring is full the byte is lost, the bytes received afterwards are discarded until BRIDGE2_ProcessRxRing() has parsed the ring and dropped the block being received (counted as an overrun error).
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_PushRxByte(uint8_t rcvdByte){
+	BRIDGE2_RxRing *pRing;
+	uint32_t writeIndex;
+	
+	
+	pRing = &(globalBridgeHandle.rxRing);
+	writeIndex = pRing->writeIndex;
+	
+	if((pRing->flagOverflow) != 0){
+		return BRIDGE2_OK;
+	}
+	
+	if((writeIndex - (pRing->readIndex)) >= BRIDGE2_RX_RING_SIZE){
+		pRing->flagOverflow = 1;
+		return BRIDGE2_OK;
+	}
+	
+	pRing->array[writeIndex & (BRIDGE2_RX_RING_SIZE - 1)] = rcvdByte;
+	
+	/* The byte has to be in the array before the consumer can see the new index ...  */
+	__asm__ __volatile__("" ::: "memory");
+	pRing->writeIndex = writeIndex + 1;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_ProcessRxRing(uint32_t maxNbBytes)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK when the ring has been emptied, BRIDGE2_NO when bytes are left in it (the function has to be called again).
+ * \param maxNbBytes is the maximum number of bytes parsed by this call. It bounds the time spent in the function, 0 means no limit.
+ * This function parses the bytes stored by BRIDGE2_PushRxByte(), in spans given to BRIDGE2_ProcessRxBytes().
+ * It is designed to be called from a context with a lower priority than the reception interrupt (typically a software triggered interrupt pended by the reception interrupt) but which is not blocked by the exchanges with the card.
+ * It must never run concurrently with the transmission interrupt routine (same priority), exactly as BRIDGE2_ProcessRxneInterrupt().
+ * Warning : this function operates on the globalBridgeHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_ProcessRxRing(uint32_t maxNbBytes){
+	BRIDGE2_RxRing *pRing;
+	BRIDGE2_Status rv;
+	uint32_t readIndex, writeIndex, offset, nbBytes, nbParsedBytes, flagOverflow;
+	
+	
+	pRing = &(globalBridgeHandle.rxRing);
+	
+	/* Once the flag is set the producer does not push anymore, all the bytes in the ring have been received before the lost one ...  */
+	flagOverflow = pRing->flagOverflow;
+	
+	readIndex = pRing->readIndex;
+	writeIndex = pRing->writeIndex;
+	__asm__ __volatile__("" ::: "memory");
+	
+	nbParsedBytes = 0;
+	while((readIndex != writeIndex) && ((maxNbBytes == 0) || (nbParsedBytes < maxNbBytes))){
+		/* The bytes are given in contiguous spans, a second one is needed when they wrap around the end of the array ...  */
+		offset = readIndex & (BRIDGE2_RX_RING_SIZE - 1);
+		nbBytes = writeIndex - readIndex;
+		if(nbBytes > (BRIDGE2_RX_RING_SIZE - offset)){
+			nbBytes = BRIDGE2_RX_RING_SIZE - offset;
+		}
+		if((maxNbBytes != 0) && (nbBytes > (maxNbBytes - nbParsedBytes))){
+			nbBytes = maxNbBytes - nbParsedBytes;
+		}
+		
+		rv = BRIDGE2_ProcessRxBytes(pRing->array + offset, nbBytes);
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		readIndex += nbBytes;
+		nbParsedBytes += nbBytes;
+		
+		/* The bytes have to be parsed before the producer can overwrite them ...  */
+		__asm__ __volatile__("" ::: "memory");
+		pRing->readIndex = readIndex;
+	}
+	
+	if(readIndex != (pRing->writeIndex)){
+		return BRIDGE2_NO;
+	}
+	
+	/* The ring is empty, the block the lost byte belonged to is dropped and the producer can push again ...  */
+	if(flagOverflow != 0){
+		rv = BRIDGE2_ProcessRxError(BRIDGE2_RX_ERR_OVERRUN);
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		pRing->flagOverflow = 0;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_ProcessTxeInterrupt(uint8_t *pByteToSend)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pByteToSend is a pointer on an uint8_t value. The location will be filled with the next byte that has to be sent by the UART interrupt routine.
+ * This function is designed to be called from a UART buffer empty interrupt routine. It is aimed to transmitthe next byte ready to be sent back to the computer and to evolve bridge's state consequently.
+ * When implementing the bridge for a specific target, the developper is in charge of configuring the UART interruption and to place a call to this function inside.
+ * Warning : this function operates on the globalUsartHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_ProcessTxeInterrupt(uint8_t *pByteToSend){
+	SM_Status smRv;
+	BRIDGE2_Status rv;
+	
+	
+	smRv = SM_EvolveStateOnByteTransmission(&globalUsartHandle, pByteToSend);
+	if((smRv != SM_OK) && (smRv != SM_EMPTY)) return BRIDGE2_ERR;
+	
+	if(smRv == SM_EMPTY){
+		rv = BRIDGE2_DisableTxeInterrupt_Callback();
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		return BRIDGE2_EMPTY;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_ProcessTxeBytes(uint8_t *pBytesToSend, uint32_t maxNbBytes, uint32_t *pNbBytes)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pBytesToSend is a pointer on a buffer of at least maxNbBytes bytes. It is filled with the next bytes that have to be sent to the computer.
+ * \param maxNbBytes is the maximum number of bytes the transmitter can take at once.
+ * \param *pNbBytes is a pointer on an uint32_t value. It is filled with the number of bytes actually written in pBytesToSend.
+ * This function is the counterpart of BRIDGE2_ProcessTxeInterrupt() for the transmitters able to send a whole span of bytes at once (DMA, FIFO ...).
+ * Warning : this function operates on the globalUsartHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_ProcessTxeBytes(uint8_t *pBytesToSend, uint32_t maxNbBytes, uint32_t *pNbBytes){
+	SM_Status rv;
+	
+	
+	rv = SM_EvolveStateOnBytesTransmission(&globalUsartHandle, pBytesToSend, maxNbBytes, pNbBytes);
+	if(rv != SM_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn BRIDGE2_Status BRIDGE2_ProcessTxComplete(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * This function has to be called once the bytes given by BRIDGE2_ProcessTxeBytes() have actually been sent, typically in the transfer complete interrupt of a DMA.
+ * The ACK timer of a block ending in these bytes then starts from the end of the transfer and not from the moment the frame has been staged.
+ * Warning : this function operates on the globalUsartHandle global data structure which is local to this file.
+ */
+BRIDGE2_Status BRIDGE2_ProcessTxComplete(void){
+	SM_Status rv;
+	
+	
+	/* If the transmission context is busy the timer keeps its first start time, the retransmission may only come a bit early ...  */
+	rv = SM_EvolveStateOnTransmissionComplete(&globalUsartHandle);
+	if((rv != SM_OK) && (rv != SM_BUSY)) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_EnableTxeInterrupt_Callback(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * The implementer of the bridge for a specific target has to make its own implementation of this function because its code might be hardware dependent.
+ * The implementation of this function has to enable the TX Empty interruption of the UART peripheral.
+ * The developper has to make sure to return a BRIDGE2_OK execution code if the interruption is correctly activated.
+ */
+__attribute__((weak)) BRIDGE2_Status BRIDGE2_EnableTxeInterrupt_Callback(void){
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_DisableTxeInterrupt_Callback(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * The implementer of the bridge for a specific target has to make its own implementation of this function because its code might be hardware dependent.
+ * The implementation of this function has to disable the TX Empty interruption of the UART peripheral.
+ * The developper has to make sure to return a BRIDGE2_OK execution code if the interruption is correctly activated.
+ */
+__attribute__((weak)) BRIDGE2_Status BRIDGE2_DisableTxeInterrupt_Callback(void){
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_EnableTxeInterrupt_Callback(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * The implementer of the bridge for a specific target has to make its own implementation of this function because its code might be hardware dependent.
+ * The implementation of this function has to enable the RX Not Empty interruption of the UART peripheral.
+ * The developper has to make sure to return a BRIDGE2_OK execution code if the interruption is correctly activated.
+ */
+__attribute__((weak)) BRIDGE2_Status BRIDGE2_EnableRxneInterrupt_Callback(void){
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_DisableRxneInterrupt_Callback(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * The implementer of the bridge for a specific target has to make its own implementation of this function because its code might be hardware dependent.
+ * The implementation of this function has to diable the RX Not Empty interruption of the UART peripheral.
+ * The developper has to make sure to return a BRIDGE2_OK execution code if the interruption is correctly activated.
+ */
+__attribute__((weak)) BRIDGE2_Status BRIDGE2_DisableRxneInterrupt_Callback(void){
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_SetComputerBaudrate_Callback(uint32_t baudrate)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param baudrate is the new baudrate of the serial communication with the computer.
+ * The implementer of the bridge for a specific target has to make its own implementation of this function because its code might be hardware dependent.
+ * The implementation of this function has to reconfigure the UART peripheral with the given baudrate and to restart the reception if it was enabled. It is never called while a block is being sent.
+ * The developper has to make sure to return a BRIDGE2_OK execution code if the baudrate is correctly changed.
+ */
+__attribute__((weak)) BRIDGE2_Status BRIDGE2_SetComputerBaudrate_Callback(uint32_t baudrate){
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_SetRts_Callback(uint32_t flagReady)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param flagReady If 0, the computer has to stop sending and the RTS line has to be deasserted. Any other value, RTS has to be asserted.
+ * The implementer of the bridge for a specific target has to make its own implementation of this function when the RTS/CTS flow control is enabled (see BRIDGE2_SetRtsFlowCtrl()).
+ * It is called from the reception interrupt routine and from the timer interrupt routine, it should only drive the line.
+ */
+__attribute__((weak)) BRIDGE2_Status BRIDGE2_SetRts_Callback(uint32_t flagReady){
+	return BRIDGE2_OK;
+}
+
+
+__attribute__((weak)) BRIDGE2_Status BRIDGE2_Sleep_Callback(void){
+	return BRIDGE2_OK;
+}
+
+
+
+/* Private functions declarations ...  */
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_SendBytesToCard(const uint8_t *pBytes, uint32_t nbBytes, uint32_t timeout)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pBytes is a pointer on the contiguous bytes of data to be sent to the smartcard on the I/O half-duplex transmission line.
+ * \param nbBytes is the number of bytes to be sent.
+ * \param timeout is the time (in milliseconds) given to each character to go out. The exchanges use the Character Waiting Time (see BRIDGE2_UpdateCardTiming()), so that the timeout follows the ETU and the clock of the card.
+ * This function transmists an array of bytes to the smartcard by making use of the iso7816 reader librairy.
+ */
+static BRIDGE2_Status BRIDGE2_SendBytesToCard(const uint8_t *pBytes, uint32_t nbBytes, uint32_t timeout){
+	READER_Status readerRv;
+	READER_HAL_CommSettings *pSettings;
+	uint32_t i;
+	
+	
+	pSettings = globalBridgeHandle.pCommSettings;
+	
+	for(i=0; i<nbBytes; i++){
+		readerRv = READER_HAL_SendChar(pSettings, READER_HAL_PROTOCOL_T1, pBytes[i], timeout);
+		if(readerRv != READER_OK) return BRIDGE2_ERR;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_RcvBufferFromCard(BUFF_Buffer *pBuffer)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pBuffer is a pointer to a BUFF_Buffer data structure where the received bytes (from the smartcard) are going to be placed in. The buffer will be reset by this function before putting the bytes in.
+ * This function receives characters from the smartcard on the I/O transmission line. It stops when timeout, when the buffer overflows or at the end of the T=1 block (see BRIDGE2_SetCardFraming()).
+ * The first character is waited for the Block Waiting Time, the next ones for the Character Waiting Time (see BRIDGE2_UpdateCardTiming()).
+ */
+static BRIDGE2_Status BRIDGE2_RcvBufferFromCard(BUFF_Buffer *pBuffer){
+	BUFF_Status buffRv;
+	READER_Status readerRv;
+	READER_HAL_CommSettings *pSettings;
+	uint8_t byte, prologue[BRIDGE2_T1_PROLOGUE_SIZE];
+	uint32_t nbRcvdBytes, timeout;
+	
+	
+	pSettings = globalBridgeHandle.pCommSettings;
+	nbRcvdBytes = 0;
+	timeout = globalBridgeHandle.cardTiming.firstByteTimeout;
+	
+	buffRv = BUFF_Init(pBuffer);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	do{
+		readerRv = READER_HAL_RcvChar(pSettings, READER_HAL_PROTOCOL_T1, &byte, timeout);
+		if((readerRv != READER_OK) && (readerRv != READER_TIMEOUT)) return BRIDGE2_ERR;
+		
+		if(readerRv != READER_TIMEOUT){
+			buffRv = BUFF_Enqueue(pBuffer, byte);
+			if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+			
+			if(nbRcvdBytes < BRIDGE2_T1_PROLOGUE_SIZE){
+				prologue[nbRcvdBytes] = byte;
+			}
+			nbRcvdBytes++;
+			timeout = globalBridgeHandle.cardTiming.interByteTimeout;
+			
+			if(BRIDGE2_IsCardFrameComplete(prologue, nbRcvdBytes) == BRIDGE2_OK){
+				break;
+			}
+		}
+		
+	}while(readerRv != READER_TIMEOUT);
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_RcvBytesFromCard(uint8_t *pBytes, uint32_t maxNbBytes, uint32_t *pNbBytes)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function. BRIDGE2_NO indicates that the card has sent more than maxNbBytes bytes, the extra ones are dropped.
+ * \param *pBytes is a pointer on the array where the received bytes (from the smartcard) are going to be placed in.
+ * \param maxNbBytes is the size of this array.
+ * \param *pNbBytes is a pointer on a uint32_t, it is updated with the number of bytes placed in the array.
+ * Same as BRIDGE2_RcvBufferFromCard() but for a linear array. The line is listened until timeout or until the end of the T=1 block even when the array is full, so that an overflowing answer does not leak in the next exchange.
+ */
+static BRIDGE2_Status BRIDGE2_RcvBytesFromCard(uint8_t *pBytes, uint32_t maxNbBytes, uint32_t *pNbBytes){
+	READER_Status readerRv;
+	READER_HAL_CommSettings *pSettings;
+	uint32_t nbBytes, nbRcvdBytes, flagOverflow, timeout;
+	uint8_t byte, prologue[BRIDGE2_T1_PROLOGUE_SIZE];
+	
+	
+	pSettings = globalBridgeHandle.pCommSettings;
+	nbBytes = 0;
+	nbRcvdBytes = 0;
+	flagOverflow = 0;
+	timeout = globalBridgeHandle.cardTiming.firstByteTimeout;
+	
+	do{
+		readerRv = READER_HAL_RcvChar(pSettings, READER_HAL_PROTOCOL_T1, &byte, timeout);
+		if((readerRv != READER_OK) && (readerRv != READER_TIMEOUT)) return BRIDGE2_ERR;
+		
+		if((readerRv != READER_TIMEOUT) && (nbBytes < maxNbBytes)){
+			pBytes[nbBytes] = byte;
+			nbBytes++;
+		}
+		else if(readerRv != READER_TIMEOUT){
+			flagOverflow = 1;
+		}
+		
+		if(readerRv != READER_TIMEOUT){
+			if(nbRcvdBytes < BRIDGE2_T1_PROLOGUE_SIZE){
+				prologue[nbRcvdBytes] = byte;
+			}
+			nbRcvdBytes++;
+			timeout = globalBridgeHandle.cardTiming.interByteTimeout;
+			
+			if(BRIDGE2_IsCardFrameComplete(prologue, nbRcvdBytes) == BRIDGE2_OK){
+				break;
+			}
+		}
+		
+	}while(readerRv != READER_TIMEOUT);
+	
+	*pNbBytes = nbBytes;
+	
+	if(flagOverflow != 0){
+		return BRIDGE2_NO;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_IsCardFrameComplete(const uint8_t *pPrologue, uint32_t nbRcvdBytes)
+ * \return BRIDGE2_OK when the answer of the card is a complete T=1 block, BRIDGE2_NO when more bytes are expected (or when the end can only be detected by the silence timeout).
+ * \param *pPrologue is a pointer on the first received bytes of the answer, only the ones already received are read.
+ * \param nbRcvdBytes is the number of bytes of the answer received so far.
+ * The size of the block is given by its LEN byte (see #BRIDGE2_T1_PROLOGUE_SIZE) and by the epilogue selected with BRIDGE2_SetCardFraming().
+ */
+static BRIDGE2_Status BRIDGE2_IsCardFrameComplete(const uint8_t *pPrologue, uint32_t nbRcvdBytes){
+	uint32_t epilogueSize;
+	
+	
+	if((globalBridgeHandle.cardFraming) == BRIDGE2_CARD_FRAMING_T1_LRC){
+		epilogueSize = 1;
+	}
+	else if((globalBridgeHandle.cardFraming) == BRIDGE2_CARD_FRAMING_T1_CRC){
+		epilogueSize = 2;
+	}
+	else{
+		return BRIDGE2_NO;
+	}
+	
+	if(nbRcvdBytes < BRIDGE2_T1_PROLOGUE_SIZE){
+		return BRIDGE2_NO;
+	}
+	
+	/* LEN 0xFF is reserved (ISO/IEC7816-3 section 11.3.2.3), such an answer is received until the card is silent ...  */
+	if(pPrologue[2] == 0xFF){
+		return BRIDGE2_NO;
+	}
+	
+	if(nbRcvdBytes < (BRIDGE2_T1_PROLOGUE_SIZE + (uint32_t)(pPrologue[2]) + epilogueSize)){
+		return BRIDGE2_NO;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ProcessResetBlock(SM_CtrlBlockType type, BUFF_Buffer *pAnswer)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function. A silent card or a reader error is not an error, it is reported in the answer.
+ * \param type is the type of the block received from the computer (#SM_COLD_RST_BLOCK or #SM_WARM_RST_BLOCK).
+ * \param *pAnswer is a pointer on the BUFF_Buffer where the answer is built (see #BRIDGE2_RESET_ANSWER_HEADER_SIZE). It is reset by this function.
+ * This function resets the card and builds the ATR block sent back to the computer, so that it learns in a single round trip whether the card came back.
+ */
+static BRIDGE2_Status BRIDGE2_ProcessResetBlock(SM_CtrlBlockType type, BUFF_Buffer *pAnswer){
+	BUFF_Status buffRv;
+	BRIDGE2_Status rv;
+	BRIDGE2_ResetStatus status;
+	uint32_t duration;
+	uint8_t header[BRIDGE2_RESET_ANSWER_HEADER_SIZE];
+	
+	
+	rv = BRIDGE2_ApplyReset(type, &status, &duration);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	header[0] = (uint8_t)(status);
+	header[1] = (uint8_t)(duration >> 24);
+	header[2] = (uint8_t)(duration >> 16);
+	header[3] = (uint8_t)(duration >> 8);
+	header[4] = (uint8_t)(duration);
+	
+	rv = BRIDGE2_EncodeCardTiming(header + 5);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	header[5 + BRIDGE2_TIMING_ANSWER_SIZE] = (uint8_t)(globalBridgeHandle.ppsStatus);
+	header[6 + BRIDGE2_TIMING_ANSWER_SIZE] = (uint8_t)(globalBridgeHandle.cardFi >> 8);
+	header[7 + BRIDGE2_TIMING_ANSWER_SIZE] = (uint8_t)(globalBridgeHandle.cardFi);
+	header[8 + BRIDGE2_TIMING_ANSWER_SIZE] = (uint8_t)(globalBridgeHandle.cardDi);
+	
+	buffRv = BUFF_Init(pAnswer);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	buffRv = BUFF_EnqueueBytes(pAnswer, header, BRIDGE2_RESET_ANSWER_HEADER_SIZE);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	if((globalBridgeHandle.cardAtrSize) != 0){
+		buffRv = BUFF_EnqueueBytes(pAnswer, globalBridgeHandle.cardAtr, globalBridgeHandle.cardAtrSize);
+		if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ApplyReset(SM_CtrlBlockType type, BRIDGE2_ResetStatus *pStatus, uint32_t *pDuration)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param type is #SM_COLD_RST_BLOCK for a cold reset (ISO/IEC7816-3 section 6.2.2) or #SM_WARM_RST_BLOCK for a warm reset (section 6.2.3).
+ * \param *pStatus is a pointer on the outcome of the reset.
+ * \param *pDuration is a pointer on the time in milliseconds between the release of the RST line and the end of the ATR.
+ * This function resets the card and receives its ATR. The waiting times used for the next exchanges are derived from it (see BRIDGE2_UpdateCardTiming()).
+ * The card is then asked for the Fi and Di of its TA1 if it has been enabled (see BRIDGE2_SetAutoPps()). It is reset again with a warm reset when it does not answer this request properly.
+ */
+static BRIDGE2_Status BRIDGE2_ApplyReset(SM_CtrlBlockType type, BRIDGE2_ResetStatus *pStatus, uint32_t *pDuration){
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	
+	
+	rv = BRIDGE2_SetCardExchangeOngoing(1);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	/* The card forgets a command forwarded in cut-through mode and not followed by a valid block ...  */
+	globalBridgeHandle.cutThroughNbSent = 0;
+	globalBridgeHandle.cardAtrSize = 0;
+	globalBridgeHandle.ppsStatus = BRIDGE2_PPS_NONE;
+	
+	/* The card answers the reset with the default Fi and Di and clock, whatever has been negotiated before ...  */
+	readerRv = READER_OK;
+	if((globalBridgeHandle.cardDefaultFreq) != 0){
+		readerRv = READER_HAL_SetFreq(globalBridgeHandle.pCommSettings, globalBridgeHandle.cardDefaultFreq);
+		if(readerRv == READER_OK){
+			globalBridgeHandle.cardDefaultFreq = 0;
+		}
+	}
+	
+	if((readerRv == READER_OK) && (((globalBridgeHandle.cardFi) != BRIDGE2_DEFAULT_FI) || ((globalBridgeHandle.cardDi) != BRIDGE2_DEFAULT_DI))){
+		readerRv = READER_HAL_SetEtu(globalBridgeHandle.pCommSettings, BRIDGE2_DEFAULT_FI, BRIDGE2_DEFAULT_DI);
+		if(readerRv == READER_OK){
+			globalBridgeHandle.cardFi = BRIDGE2_DEFAULT_FI;
+			globalBridgeHandle.cardDi = BRIDGE2_DEFAULT_DI;
+		}
+	}
+	
+	if(readerRv == READER_OK){
+		rv = BRIDGE2_ResetCard(type, pStatus, pDuration);
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	}
+	else{
+		*pStatus = BRIDGE2_RST_CARD_ERR;
+		*pDuration = 0;
+	}
+	
+	if((*pStatus == BRIDGE2_RST_OK) && ((globalBridgeHandle.flagAutoPps) != 0)){
+		rv = BRIDGE2_NegotiatePps(&(globalBridgeHandle.ppsStatus));
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		/* The card is in an undefined state after a missing or wrong PPS response, it is reset and kept at the default rates (ISO/IEC7816-3 section 9.3) ...  */
+		if((globalBridgeHandle.ppsStatus) == BRIDGE2_PPS_FAILED){
+			globalBridgeHandle.cardAtrSize = 0;
+			
+			rv = BRIDGE2_ResetCard(SM_WARM_RST_BLOCK, pStatus, pDuration);
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		}
+	}
+	
+	rv = BRIDGE2_SetCardExchangeOngoing(0);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	/* The ATR of the card is unknown after a failed reset, the default waiting times are used again ...  */
+	if(*pStatus == BRIDGE2_RST_CARD_ERR){
+		globalBridgeHandle.cardTiming.flagAtrParsed = 0;
+		globalBridgeHandle.cardTiming.ta1 = 0x11;
+		globalBridgeHandle.cardTiming.cwi = BRIDGE2_DEFAULT_CWI;
+		globalBridgeHandle.cardTiming.bwi = BRIDGE2_DEFAULT_BWI;
+	}
+	
+	rv = BRIDGE2_UpdateCardTiming();
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ResetCard(SM_CtrlBlockType type, BRIDGE2_ResetStatus *pStatus, uint32_t *pDuration)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function. A reader error is not an error, it is reported in *pStatus.
+ * \param type is #SM_COLD_RST_BLOCK for a cold reset or #SM_WARM_RST_BLOCK for a warm reset.
+ * \param *pStatus is a pointer on the outcome of the reset.
+ * \param *pDuration is a pointer on the time in milliseconds between the release of the RST line and the end of the ATR.
+ * This function resets the card with the rates currently set in the reader and receives its ATR.
+ */
+static BRIDGE2_Status BRIDGE2_ResetCard(SM_CtrlBlockType type, BRIDGE2_ResetStatus *pStatus, uint32_t *pDuration){
+	READER_Status readerRv;
+	BRIDGE2_Status atrRv;
+	uint32_t startTick;
+	
+	
+	if(type == SM_WARM_RST_BLOCK){
+		readerRv = BRIDGE2_DoWarmReset();
+	}
+	else{
+		readerRv = READER_HAL_DoColdReset();
+	}
+	
+	startTick = READER_HAL_GetTick();
+	
+	atrRv = BRIDGE2_ERR;
+	if(readerRv == READER_OK){
+		atrRv = BRIDGE2_RcvAtrFromCard();
+	}
+	
+	*pDuration = READER_HAL_GetTick() - startTick;
+	
+	if((readerRv != READER_OK) || (atrRv != BRIDGE2_OK)){
+		*pStatus = BRIDGE2_RST_CARD_ERR;
+	}
+	else if((globalBridgeHandle.cardAtrSize) == 0){
+		*pStatus = BRIDGE2_RST_NO_ATR;
+	}
+	else if((globalBridgeHandle.cardTiming.flagAtrParsed) != 0){
+		*pStatus = BRIDGE2_RST_OK;
+	}
+	else{
+		*pStatus = BRIDGE2_RST_MALFORMED;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static READER_Status BRIDGE2_DoWarmReset(void)
+ * \return READER_Status execution code of the reader library. READER_OK indicates nominal execution of the function.
+ * This function holds the RST line low for #BRIDGE2_WARM_RESET_LOW_TIME milliseconds while the card stays powered and clocked, then releases it. See ISO/IEC7816-3 section 6.2.3.
+ */
+static READER_Status BRIDGE2_DoWarmReset(void){
+	READER_Status readerRv;
+	
+	
+	readerRv = READER_HAL_SetRstLine(READER_HAL_STATE_OFF);
+	if(readerRv != READER_OK) return readerRv;
+	
+	READER_HAL_Delay(BRIDGE2_WARM_RESET_LOW_TIME);
+	
+	
+	return READER_HAL_SetRstLine(READER_HAL_STATE_ON);
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_NegotiatePps(BRIDGE2_PpsStatus *pStatus)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function. A card refusing the request or not answering it is not an error, it is reported in *pStatus.
+ * \param *pStatus is a pointer on the outcome of the exchange.
+ * This function asks the card for the Fi and Di of the TA1 of its ATR, with PPS1 only and the first protocol it offers (see ISO/IEC7816-3 section 9.2). The reader is switched to them once the card has confirmed them.
+ * A card in specific mode does not accept any request, the Fi and Di of its TA1 are used right away unless TA2 says they are implicit.
+ */
+static BRIDGE2_Status BRIDGE2_NegotiatePps(BRIDGE2_PpsStatus *pStatus){
+	READER_Status readerRv;
+	BRIDGE2_CardTiming *pTiming;
+	BRIDGE2_Status rv;
+	uint32_t fi, di, fmax, i, nbRcvd, nbExpected;
+	uint8_t request[4];
+	uint8_t response[6];
+	uint8_t check;
+	
+	
+	pTiming = &(globalBridgeHandle.cardTiming);
+	*pStatus = BRIDGE2_PPS_NONE;
+	
+	if((pTiming->ta1) == 0x11) return BRIDGE2_OK;
+	if(BRIDGE2_DecodeTa1(pTiming->ta1, &fi, &di, &fmax) != BRIDGE2_OK) return BRIDGE2_OK;
+	
+	if((pTiming->flagSpecificMode) != 0){
+		if(((pTiming->ta2) & 0x10) != 0) return BRIDGE2_OK;
+		
+		readerRv = READER_HAL_SetEtu(globalBridgeHandle.pCommSettings, fi, di);
+		if(readerRv != READER_OK){
+			*pStatus = BRIDGE2_PPS_FAILED;
+			return BRIDGE2_OK;
+		}
+		
+		globalBridgeHandle.cardFi = fi;
+		globalBridgeHandle.cardDi = di;
+		*pStatus = BRIDGE2_PPS_SPECIFIC;
+		return BRIDGE2_OK;
+	}
+	
+	/* PPSS, PPS0 (PPS1 present and protocol), PPS1 and PCK ...  */
+	request[0] = 0xFF;
+	request[1] = (uint8_t)(0x10 | ((pTiming->protocol) & 0x0F));
+	request[2] = pTiming->ta1;
+	request[3] = (uint8_t)(request[0] ^ request[1] ^ request[2]);
+	
+	*pStatus = BRIDGE2_PPS_FAILED;
+	
+	/* The waiting times derived from the ATR do not apply before the card has confirmed its new rates ...  */
+	rv = BRIDGE2_SendBytesToCard(request, sizeof(request), BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT);
+	if(rv != BRIDGE2_OK) return BRIDGE2_OK;
+	
+	readerRv = READER_HAL_WaitUntilSendComplete(globalBridgeHandle.pCommSettings);
+	if(readerRv != READER_OK) return BRIDGE2_OK;
+	
+	/* The size of the response is given by its PPS0 byte ...  */
+	nbRcvd = 0;
+	nbExpected = 2;
+	
+	while(nbRcvd < nbExpected){
+		readerRv = READER_HAL_RcvChar(globalBridgeHandle.pCommSettings, READER_HAL_PROTOCOL_T1, &(response[nbRcvd]), BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT);
+		if(readerRv != READER_OK) return BRIDGE2_OK;
+		nbRcvd++;
+		
+		if(nbRcvd == 2){
+			nbExpected = 3 + (((response[1] >> 4) & 0x01) + ((response[1] >> 5) & 0x01) + ((response[1] >> 6) & 0x01));
+		}
+	}
+	
+	check = 0x00;
+	for(i=0; i<nbRcvd; i++){
+		check ^= response[i];
+	}
+	
+	if((response[0] != request[0]) || ((response[1] & 0x0F) != (request[1] & 0x0F)) || (check != 0x00)){
+		return BRIDGE2_OK;
+	}
+	
+	/* Without PPS1 in the response, the card keeps the default values ...  */
+	if((response[1] & 0x10) == 0){
+		*pStatus = BRIDGE2_PPS_REFUSED;
+		return BRIDGE2_OK;
+	}
+	
+	if(response[2] != request[2]){
+		return BRIDGE2_OK;
+	}
+	
+	readerRv = READER_HAL_SetEtu(globalBridgeHandle.pCommSettings, fi, di);
+	if(readerRv != READER_OK) return BRIDGE2_OK;
+	
+	globalBridgeHandle.cardFi = fi;
+	globalBridgeHandle.cardDi = di;
+	*pStatus = BRIDGE2_PPS_OK;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_DecodeTa1(uint8_t ta1, uint32_t *pFi, uint32_t *pDi, uint32_t *pFmax)
+ * \return BRIDGE2_OK if all values are defined, BRIDGE2_NO if TA1 uses a reserved value.
+ * \param ta1 is the TA1 byte of the ATR.
+ * \param *pFi is a pointer on the clock rate conversion integer encoded in the high nibble of TA1.
+ * \param *pDi is a pointer on the baud rate adjustment integer encoded in the low nibble of TA1.
+ * \param *pFmax is a pointer on the maximum clock frequency (in Hz) going with Fi.
+ * See ISO/IEC7816-3 section 8.3, tables 7 and 8.
+ */
+static BRIDGE2_Status BRIDGE2_DecodeTa1(uint8_t ta1, uint32_t *pFi, uint32_t *pDi, uint32_t *pFmax){
+	static const uint16_t fiTable[16] = {372, 372, 558, 744, 1116, 1488, 1860, 0, 0, 512, 768, 1024, 1536, 2048, 0, 0};
+	static const uint32_t fmaxTable[16] = {4000000, 5000000, 6000000, 8000000, 12000000, 16000000, 20000000, 0, 0, 5000000, 7500000, 10000000, 15000000, 20000000, 0, 0};
+	static const uint8_t diTable[16] = {0, 1, 2, 4, 8, 16, 32, 64, 12, 20, 0, 0, 0, 0, 0, 0};
+	
+	
+	*pFi = (uint32_t)(fiTable[ta1 >> 4]);
+	*pFmax = fmaxTable[ta1 >> 4];
+	*pDi = (uint32_t)(diTable[ta1 & 0x0F]);
+	
+	if((*pFi == 0) || (*pDi == 0)){
+		return BRIDGE2_NO;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_RcvAtrFromCard(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function. A silent card or a malformed ATR is not an error, the default waiting times are used in that case.
+ * This function receives the ATR of the card into the cardAtr array and parses it. The reception stops as soon as the ATR is complete, so that it does not wait for the silence timeout.
+ * A malformed ATR is received until the card is silent (or #BRIDGE2_ATR_MAX_SIZE bytes), so that its last bytes are not taken for the answer to the next command.
+ */
+static BRIDGE2_Status BRIDGE2_RcvAtrFromCard(void){
+	READER_Status readerRv;
+	BRIDGE2_Status parseRv;
+	BRIDGE2_CardTiming timing;
+	uint8_t byte;
+	
+	
+	globalBridgeHandle.cardAtrSize = 0;
+	parseRv = BRIDGE2_NO;
+	
+	while((parseRv != BRIDGE2_OK) && ((globalBridgeHandle.cardAtrSize) < BRIDGE2_ATR_MAX_SIZE)){
+		readerRv = READER_HAL_RcvChar(globalBridgeHandle.pCommSettings, READER_HAL_PROTOCOL_T1, &byte, BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT);
+		if(readerRv == READER_TIMEOUT) break;
+		if(readerRv != READER_OK) return BRIDGE2_ERR;
+		
+		globalBridgeHandle.cardAtr[globalBridgeHandle.cardAtrSize] = byte;
+		globalBridgeHandle.cardAtrSize++;
+		
+		/* Once the ATR is known to be malformed, the next bytes are only stored ...  */
+		if(parseRv != BRIDGE2_ERR){
+			parseRv = BRIDGE2_ParseAtr(globalBridgeHandle.cardAtr, globalBridgeHandle.cardAtrSize, &timing);
+		}
+	}
+	
+	if(parseRv == BRIDGE2_OK){
+		globalBridgeHandle.cardTiming.flagAtrParsed = 1;
+		globalBridgeHandle.cardTiming.ta1 = timing.ta1;
+		globalBridgeHandle.cardTiming.flagSpecificMode = timing.flagSpecificMode;
+		globalBridgeHandle.cardTiming.ta2 = timing.ta2;
+		globalBridgeHandle.cardTiming.protocol = timing.protocol;
+		globalBridgeHandle.cardTiming.cwi = timing.cwi;
+		globalBridgeHandle.cardTiming.bwi = timing.bwi;
+	}
+	else{
+		globalBridgeHandle.cardTiming.flagAtrParsed = 0;
+		globalBridgeHandle.cardTiming.ta1 = 0x11;
+		globalBridgeHandle.cardTiming.flagSpecificMode = 0;
+		globalBridgeHandle.cardTiming.ta2 = 0x00;
+		globalBridgeHandle.cardTiming.protocol = 0;
+		globalBridgeHandle.cardTiming.cwi = BRIDGE2_DEFAULT_CWI;
+		globalBridgeHandle.cardTiming.bwi = BRIDGE2_DEFAULT_BWI;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ParseAtr(const uint8_t *pAtr, uint32_t atrSize, BRIDGE2_CardTiming *pTiming)
+ * \return BRIDGE2_OK when the ATR is complete, BRIDGE2_NO when more bytes are expected, BRIDGE2_ERR when the ATR is malformed.
+ * \param *pAtr is a pointer on the bytes of the ATR received so far, TS included.
+ * \param atrSize is the number of bytes received so far.
+ * \param *pTiming is a pointer on the structure where TA1, CWI and BWI are written. Only meaningful when BRIDGE2_OK is returned.
+ * CWI and BWI are read in the first TBi (i>2) following a TD(i-1) indicating T=1. The TCK byte is expected as soon as a protocol other than T=0 is indicated. See ISO/IEC7816-3 sections 8.2 and 11.4.3.
+ */
+static BRIDGE2_Status BRIDGE2_ParseAtr(const uint8_t *pAtr, uint32_t atrSize, BRIDGE2_CardTiming *pTiming){
+	uint32_t i, level, y, nbHistBytes, flagTck, flagT1, flagTbFound;
+	uint8_t td;
+	
+	
+	pTiming->ta1 = 0x11;
+	pTiming->flagSpecificMode = 0;
+	pTiming->ta2 = 0x00;
+	pTiming->protocol = 0;
+	pTiming->cwi = BRIDGE2_DEFAULT_CWI;
+	pTiming->bwi = BRIDGE2_DEFAULT_BWI;
+	
+	if(atrSize < 1) return BRIDGE2_NO;
+	if((pAtr[0] != 0x3B) && (pAtr[0] != 0x3F)) return BRIDGE2_ERR;
+	if(atrSize < 2) return BRIDGE2_NO;
+	
+	y = (uint32_t)(pAtr[1] >> 4);
+	nbHistBytes = (uint32_t)(pAtr[1] & 0x0F);
+	i = 2;
+	level = 1;
+	flagTck = 0;
+	flagT1 = 0;
+	flagTbFound = 0;
+	
+	while(1){
+		/* TAi ...  */
+		if((y & 0x01) != 0){
+			if(i >= atrSize) return BRIDGE2_NO;
+			if(level == 1) pTiming->ta1 = pAtr[i];
+			if(level == 2){
+				pTiming->flagSpecificMode = 1;
+				pTiming->ta2 = pAtr[i];
+			}
+			i++;
+		}
+		
+		/* TBi ...  */
+		if((y & 0x02) != 0){
+			if(i >= atrSize) return BRIDGE2_NO;
+			if((level > 2) && (flagT1 != 0) && (flagTbFound == 0)){
+				pTiming->cwi = pAtr[i] & 0x0F;
+				pTiming->bwi = pAtr[i] >> 4;
+				flagTbFound = 1;
+			}
+			i++;
+		}
+		
+		/* TCi ...  */
+		if((y & 0x04) != 0){
+			if(i >= atrSize) return BRIDGE2_NO;
+			i++;
+		}
+		
+		/* TDi ...  */
+		if((y & 0x08) == 0) break;
+		if(i >= atrSize) return BRIDGE2_NO;
+		
+		td = pAtr[i];
+		i++;
+		
+		if((td & 0x0F) != 0) flagTck = 1;
+		if(level == 1) pTiming->protocol = td & 0x0F;
+		flagT1 = ((td & 0x0F) == 1) ? 1 : 0;
+		y = (uint32_t)(td >> 4);
+		level++;
+	}
+	
+	if((i + nbHistBytes + flagTck) > BRIDGE2_ATR_MAX_SIZE) return BRIDGE2_ERR;
+	if(atrSize < (i + nbHistBytes + flagTck)) return BRIDGE2_NO;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_UpdateCardTiming(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * This function computes the waiting times used when exchanging with the card, rounded up to the next millisecond plus one millisecond of margin for the tick granularity :
+ * CWT = (11 + 2^CWI) ETU and BWT = 11 ETU + 2^BWI x 960 x 372 clock cycles, with ETU = Fi / (Di x f). See ISO/IEC7816-3 section 11.4.3.
+ * The values given by the computer in a timing block are kept, #BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT is used when no ATR has been parsed.
+ */
+static BRIDGE2_Status BRIDGE2_UpdateCardTiming(void){
+	READER_HAL_CommSettings *pSettings;
+	uint64_t freq, fi, di, cwt, bwt;
+	
+	
+	if((globalBridgeHandle.cardTiming.flagOverridden) != 0){
+		return BRIDGE2_OK;
+	}
+	
+	pSettings = globalBridgeHandle.pCommSettings;
+	
+	if((globalBridgeHandle.cardTiming.flagAtrParsed) == 0){
+		globalBridgeHandle.cardTiming.firstByteTimeout = BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT;
+		globalBridgeHandle.cardTiming.interByteTimeout = BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT;
+		return BRIDGE2_OK;
+	}
+	
+	freq = (uint64_t)(READER_HAL_GetFreq(pSettings));
+	fi = (uint64_t)(READER_HAL_GetFi(pSettings));
+	di = (uint64_t)(READER_HAL_GetDi(pSettings));
+	
+	if((freq == 0) || (di == 0)){
+		globalBridgeHandle.cardTiming.firstByteTimeout = BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT;
+		globalBridgeHandle.cardTiming.interByteTimeout = BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT;
+		return BRIDGE2_OK;
+	}
+	
+	/* Both expressed in clock cycles x Di, then converted in milliseconds ...  */
+	cwt = (11 + ((uint64_t)(1) << globalBridgeHandle.cardTiming.cwi)) * fi;
+	bwt = (11 * fi) + ((((uint64_t)(1) << globalBridgeHandle.cardTiming.bwi) * 960 * 372) * di);
+	
+	cwt = ((cwt * 1000) + (di * freq) - 1) / (di * freq);
+	bwt = ((bwt * 1000) + (di * freq) - 1) / (di * freq);
+	
+	globalBridgeHandle.cardTiming.interByteTimeout = (uint32_t)(cwt) + 1;
+	globalBridgeHandle.cardTiming.firstByteTimeout = (uint32_t)(bwt) + 1;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+static BRIDGE2_Status BRIDGE2_ApplyRcvdDataBlock(void){
+	BRIDGE2_Status rv;
+	uint32_t nbSent;
+	
+	
+	/* In cut-through mode, the beginning of the payload may already be at the card ...  */
+	nbSent = globalBridgeHandle.cutThroughNbSent;
+	globalBridgeHandle.cutThroughNbSent = 0;
+	globalBridgeHandle.flagCutThroughOngoing = 0;
+	
+	/* The answer is sent to the computer while it is received from the card ...  */
+	if(((globalBridgeHandle.flagAnswerStreaming) != 0) && ((globalBridgeHandle.cardFraming) != BRIDGE2_CARD_FRAMING_NONE)){
+		rv = BRIDGE2_ExchangeWithCardStreamed(globalBridgeHandle.computerRcvdBlock.pData + nbSent, globalBridgeHandle.computerRcvdBlock.size - nbSent);
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		return BRIDGE2_OK;
+	}
+	
+	/* We send to the card the previously received data from the computer and we get back its answer ...  */
+	rv = BRIDGE2_ExchangeWithCard(SM_DATA_BLOCK, globalBridgeHandle.computerRcvdBlock.pData + nbSent, globalBridgeHandle.computerRcvdBlock.size - nbSent);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	/* We send this data back to the computer inside a block ...  */
+	rv = BRIDGE2_SendAnswerToComputer(SM_DATA_BLOCK);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ForwardRcvdPayload(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * This function sends to the card the payload bytes of the data block being received which have arrived since its previous call (see BRIDGE2_SetCutThrough()). It does not wait for the next ones, it is called again as they arrive.
+ * The computer is not held while forwarding, it is still sending the rest of the block. The remaining bytes are sent by BRIDGE2_ApplyRcvdDataBlock() once the block has been received.
+ */
+static BRIDGE2_Status BRIDGE2_ForwardRcvdPayload(void){
+	BRIDGE2_Status rv;
+	READER_Status readerRv;
+	uint32_t nbRcvd;
+	
+	
+	if((globalBridgeHandle.flagCutThroughRestart) != 0){
+		globalBridgeHandle.flagCutThroughRestart = 0;
+		
+		/* The previous block has been dropped after being forwarded, the card answer to this command is not expected by the computer ...  */
+		if((globalBridgeHandle.cutThroughNbSent) != 0){
+			globalBridgeHandle.cutThroughNbSent = 0;
+			
+			readerRv = READER_HAL_WaitUntilSendComplete(globalBridgeHandle.pCommSettings);
+			if(readerRv != READER_OK) return BRIDGE2_ERR;
+			
+			rv = BRIDGE2_RcvBufferFromCard(&(globalBridgeHandle.cardRcvdBytes));
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		}
+	}
+	
+	while((globalBridgeHandle.cutThroughNbSent) < (globalBridgeHandle.cutThroughNbExpected)){
+		/* The size of the payload is updated by the UART interrupt routine ...  */
+		__asm__ __volatile__("" ::: "memory");
+		nbRcvd = globalBridgeHandle.computerRcvdBlock.size;
+		
+		/* A new block has started, it is forwarded on the next call ...  */
+		if((globalBridgeHandle.flagCutThroughRestart) != 0){
+			return BRIDGE2_OK;
+		}
+		
+		if(nbRcvd > (globalBridgeHandle.cutThroughNbExpected)){
+			nbRcvd = globalBridgeHandle.cutThroughNbExpected;
+		}
+		
+		/* Waiting for the next bytes (or the block has been dropped, nothing more is forwarded until the next one) ...  */
+		if(nbRcvd <= (globalBridgeHandle.cutThroughNbSent)){
+			return BRIDGE2_OK;
+		}
+		
+		rv = BRIDGE2_SendBytesToCard(globalBridgeHandle.computerRcvdBlock.pData + globalBridgeHandle.cutThroughNbSent, nbRcvd - globalBridgeHandle.cutThroughNbSent, globalBridgeHandle.cardTiming.interByteTimeout);
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		globalBridgeHandle.cutThroughNbSent = nbRcvd;
+	}
+	
+	globalBridgeHandle.flagCutThroughOngoing = 0;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_SendAnswerToComputer(SM_CtrlBlockType type)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param type is the type of the block carrying the answer (see BRIDGE2_GetAnswerType()).
+ * This function sends back to the computer the content of the cardRcvdBytes buffer (stop-and-wait mode). The next reception is started once this block has been acknowledged.
+ * If the state machine is still busy (typically sending the ACK of the block we answer to), the block is queued and sent as soon as it is free (see BRIDGE2_QueueBlock()).
+ */
+static BRIDGE2_Status BRIDGE2_SendAnswerToComputer(SM_CtrlBlockType type){
+	return BRIDGE2_QueueBlock(type, &(globalBridgeHandle.cardRcvdBytes), BRIDGE2_AnswerStarted);
+}
+
+
+/* The computer acknowledges the answer once it has been received, the next reception is then started ...  */
+static BRIDGE2_Status BRIDGE2_AnswerStarted(void){
+	globalBridgeHandle.flagAckExpected = 1;
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_QueueBlock(SM_CtrlBlockType type, BUFF_Buffer *pBuffer, BRIDGE2_Status (*onStarted)(void))
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function. BRIDGE2_ERR if #BRIDGE2_OUT_QUEUE_SIZE blocks are already waiting.
+ * \param type is the type of the block to be sent to the computer.
+ * \param *pBuffer is a pointer on the payload of the block (NULL if there is none), it must not be modified until the block is sent.
+ * \param onStarted is called once the state machine has started to send the block (NULL if nothing has to be done).
+ * This function puts the block at the end of the outbound queue and sends the queue as far as the state machine accepts. It never waits for the state machine to be free.
+ */
+static BRIDGE2_Status BRIDGE2_QueueBlock(SM_CtrlBlockType type, BUFF_Buffer *pBuffer, BRIDGE2_Status (*onStarted)(void)){
+	BRIDGE2_OutQueue *pQueue;
+	BRIDGE2_OutBlock *pBlock;
+	
+	
+	pQueue = &(globalBridgeHandle.outQueue);
+	
+	if((pQueue->nbBlocks) >= BRIDGE2_OUT_QUEUE_SIZE){
+		return BRIDGE2_ERR;
+	}
+	
+	pBlock = &(pQueue->blocks[((pQueue->readIndex) + (pQueue->nbBlocks)) % BRIDGE2_OUT_QUEUE_SIZE]);
+	pBlock->type = type;
+	pBlock->pBuffer = pBuffer;
+	pBlock->onStarted = onStarted;
+	pQueue->nbBlocks++;
+	
+	
+	return BRIDGE2_FlushOutQueue();
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_FlushOutQueue(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function, even if some blocks are still waiting.
+ * This function hands over the queued blocks to the state machine, in order, until it answers #SM_BUSY. The remaining ones are sent on the next processing, which is requested when the current block has been sent (see SM_BlockSentCallback()).
+ */
+static BRIDGE2_Status BRIDGE2_FlushOutQueue(void){
+	BRIDGE2_OutQueue *pQueue;
+	BRIDGE2_OutBlock *pBlock;
+	BRIDGE2_Status rv;
+	SM_Status smRv;
+	
+	
+	pQueue = &(globalBridgeHandle.outQueue);
+	
+	while((pQueue->nbBlocks) != 0){
+		pBlock = &(pQueue->blocks[pQueue->readIndex]);
+		
+		smRv = SM_SendBlock(&globalUsartHandle, pBlock->pBuffer, pBlock->type);
+		if((smRv != SM_OK) && (smRv != SM_BUSY)) return BRIDGE2_ERR;
+		
+		if(smRv == SM_BUSY){
+			return BRIDGE2_OK;
+		}
+		
+		pQueue->readIndex = ((pQueue->readIndex) + 1) % BRIDGE2_OUT_QUEUE_SIZE;
+		pQueue->nbBlocks--;
+		
+		if((pBlock->onStarted) != NULL){
+			rv = pBlock->onStarted();
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		}
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_BuildAnswer(SM_CtrlBlockType type, const uint8_t *pBytes, uint32_t nbBytes)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param type is the type of the block received from the computer (#SM_DATA_BLOCK, #SM_SEQUENCE_BLOCK, #SM_HELLO_BLOCK, #SM_BAUD_BLOCK, #SM_TIMING_BLOCK, #SM_CLOCK_BLOCK, #SM_COLD_RST_BLOCK or #SM_WARM_RST_BLOCK).
+ * \param *pBytes is a pointer on the payload of this block.
+ * \param nbBytes is the size of the payload.
+ * This function processes a block which gets an answer (see BRIDGE2_GetAnswerType()). The answer is put in the cardRcvdBytes buffer.
+ */
+static BRIDGE2_Status BRIDGE2_BuildAnswer(SM_CtrlBlockType type, const uint8_t *pBytes, uint32_t nbBytes){
+	BRIDGE2_Status rv;
+	
+	
+	if(type == SM_HELLO_BLOCK){
+		rv = BRIDGE2_ProcessHelloBlock(pBytes, nbBytes, &(globalBridgeHandle.cardRcvdBytes));
+	}
+	else if(type == SM_BAUD_BLOCK){
+		rv = BRIDGE2_ProcessBaudBlock(pBytes, nbBytes, &(globalBridgeHandle.cardRcvdBytes));
+	}
+	else if(type == SM_TIMING_BLOCK){
+		rv = BRIDGE2_ProcessTimingBlock(pBytes, nbBytes, &(globalBridgeHandle.cardRcvdBytes));
+	}
+	else if(type == SM_CLOCK_BLOCK){
+		rv = BRIDGE2_ProcessClockBlock(pBytes, nbBytes, &(globalBridgeHandle.cardRcvdBytes));
+	}
+	else if((type == SM_COLD_RST_BLOCK) || (type == SM_WARM_RST_BLOCK)){
+		rv = BRIDGE2_ProcessResetBlock(type, &(globalBridgeHandle.cardRcvdBytes));
+	}
+	else{
+		rv = BRIDGE2_ExchangeWithCard(type, pBytes, nbBytes);
+	}
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ProcessHelloBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function. A request for unsupported parameters is not an error, the answer reports the parameters actually in use.
+ * \param *pBytes is a pointer on the payload of the hello block (see #BRIDGE2_HELLO_REQUEST_SIZE).
+ * \param nbBytes is the size of the payload.
+ * \param *pAnswer is a pointer on the BUFF_Buffer where the answer is built (see #BRIDGE2_HELLO_ANSWER_SIZE). It is reset by this function.
+ * This function reports the capabilities of the bridge and records the link parameters asked for by the computer.
+ * They are applied by BRIDGE2_ApplyPendingLinkSettings() once the answer has been acknowledged, so that the answer and its ACK still use the current ones.
+ * The parameters can only be changed in stop-and-wait mode, in windowed mode the blocks in flight would be misinterpreted.
+ */
+static BRIDGE2_Status BRIDGE2_ProcessHelloBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer){
+	BUFF_Status buffRv;
+	SM_Status smRv;
+	SM_CheckType checkType;
+	uint32_t windowSize;
+	uint8_t answer[BRIDGE2_HELLO_ANSWER_SIZE];
+	
+	
+	smRv = SM_GetCheckType(&globalUsartHandle, &checkType);
+	if(smRv != SM_OK) return BRIDGE2_ERR;
+	
+	smRv = SM_GetWindowSize(&globalUsartHandle, &windowSize);
+	if(smRv != SM_OK) return BRIDGE2_ERR;
+	
+	globalBridgeHandle.flagLinkSettingsPending = 0;
+	
+	if((nbBytes >= BRIDGE2_HELLO_REQUEST_SIZE) && (BRIDGE2_IsWindowedMode() == BRIDGE2_NO)){
+		if(pBytes[1] <= SM_CHECK_CRC16){
+			checkType = (SM_CheckType)(pBytes[1]);
+		}
+		
+		if((pBytes[2] != 0) && (pBytes[2] != BRIDGE2_HELLO_KEEP) && (pBytes[2] <= SM_MAX_WINDOW_SIZE)){
+			windowSize = pBytes[2];
+		}
+		
+		globalBridgeHandle.pendingCheckType = checkType;
+		globalBridgeHandle.pendingWindowSize = windowSize;
+		globalBridgeHandle.flagLinkSettingsPending = 1;
+	}
+	
+	answer[0] = (uint8_t)(BRIDGE2_PROTOCOL_VERSION);
+	answer[1] = (uint8_t)(BUFF_MAX_SIZE >> 16);
+	answer[2] = (uint8_t)(BUFF_MAX_SIZE >> 8);
+	answer[3] = (uint8_t)(BUFF_MAX_SIZE);
+	answer[4] = (uint8_t)((1 << SM_CHECK_NONE) | (1 << SM_CHECK_LRC) | (1 << SM_CHECK_CRC16));
+	answer[5] = (uint8_t)(SM_MAX_WINDOW_SIZE);
+	answer[6] = (uint8_t)((globalBridgeHandle.computerBaudrate) >> 24);
+	answer[7] = (uint8_t)((globalBridgeHandle.computerBaudrate) >> 16);
+	answer[8] = (uint8_t)((globalBridgeHandle.computerBaudrate) >> 8);
+	answer[9] = (uint8_t)(globalBridgeHandle.computerBaudrate);
+	answer[10] = (uint8_t)(checkType);
+	answer[11] = (uint8_t)(windowSize);
+	
+	buffRv = BUFF_Init(pAnswer);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	buffRv = BUFF_EnqueueBytes(pAnswer, answer, BRIDGE2_HELLO_ANSWER_SIZE);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ApplyPendingLinkSettings(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * This function applies the link parameters recorded by BRIDGE2_ProcessHelloBlock(), if any. It has to be called while no block is being received or sent.
+ */
+static BRIDGE2_Status BRIDGE2_ApplyPendingLinkSettings(void){
+	SM_Status smRv;
+	
+	
+	if((globalBridgeHandle.flagLinkSettingsPending) == 0){
+		return BRIDGE2_OK;
+	}
+	
+	globalBridgeHandle.flagLinkSettingsPending = 0;
+	
+	smRv = SM_SetCheckType(&globalUsartHandle, globalBridgeHandle.pendingCheckType);
+	if(smRv != SM_OK) return BRIDGE2_ERR;
+	
+	smRv = SM_SetWindowSize(&globalUsartHandle, globalBridgeHandle.pendingWindowSize);
+	if(smRv != SM_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ProcessBaudBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function. A request for an unsupported baudrate is not an error, the answer reports the baudrate actually in use.
+ * \param *pBytes is a pointer on the payload of the baud block (see #BRIDGE2_BAUD_REQUEST_SIZE).
+ * \param nbBytes is the size of the payload.
+ * \param *pAnswer is a pointer on the BUFF_Buffer where the answer is built. It is reset by this function.
+ * This function records the baudrate asked for by the computer. It is applied by BRIDGE2_ApplyPendingBaudrate() once the answer has been acknowledged, so that the answer and its ACK still use the current one.
+ * As for the hello block, the baudrate can only be changed in stop-and-wait mode.
+ */
+static BRIDGE2_Status BRIDGE2_ProcessBaudBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer){
+	BUFF_Status buffRv;
+	uint32_t baudrate;
+	uint8_t answer[BRIDGE2_BAUD_REQUEST_SIZE];
+	
+	
+	baudrate = globalBridgeHandle.computerBaudrate;
+	globalBridgeHandle.flagBaudratePending = 0;
+	
+	if((nbBytes >= BRIDGE2_BAUD_REQUEST_SIZE) && (BRIDGE2_IsWindowedMode() == BRIDGE2_NO)){
+		baudrate = ((uint32_t)(pBytes[0]) << 24) | ((uint32_t)(pBytes[1]) << 16) | ((uint32_t)(pBytes[2]) << 8) | (uint32_t)(pBytes[3]);
+		
+		if((baudrate < BRIDGE2_MIN_COMPUTER_BAUDRATE) || (baudrate > BRIDGE2_MAX_COMPUTER_BAUDRATE)){
+			baudrate = globalBridgeHandle.computerBaudrate;
+		}
+		
+		if(baudrate != (globalBridgeHandle.computerBaudrate)){
+			globalBridgeHandle.pendingBaudrate = baudrate;
+			globalBridgeHandle.flagBaudratePending = 1;
+		}
+	}
+	
+	answer[0] = (uint8_t)(baudrate >> 24);
+	answer[1] = (uint8_t)(baudrate >> 16);
+	answer[2] = (uint8_t)(baudrate >> 8);
+	answer[3] = (uint8_t)(baudrate);
+	
+	buffRv = BUFF_Init(pAnswer);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	buffRv = BUFF_EnqueueBytes(pAnswer, answer, BRIDGE2_BAUD_REQUEST_SIZE);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_EncodeCardTiming(uint8_t *pDest)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pDest is a pointer on the #BRIDGE2_TIMING_ANSWER_SIZE bytes where the waiting times in use are written (layout described with #BRIDGE2_TIMING_ANSWER_SIZE).
+ */
+static BRIDGE2_Status BRIDGE2_EncodeCardTiming(uint8_t *pDest){
+	BRIDGE2_CardTiming *pTiming;
+	
+	
+	pTiming = &(globalBridgeHandle.cardTiming);
+	
+	pDest[0] = (uint8_t)(pTiming->firstByteTimeout >> 24);
+	pDest[1] = (uint8_t)(pTiming->firstByteTimeout >> 16);
+	pDest[2] = (uint8_t)(pTiming->firstByteTimeout >> 8);
+	pDest[3] = (uint8_t)(pTiming->firstByteTimeout);
+	pDest[4] = (uint8_t)(pTiming->interByteTimeout >> 24);
+	pDest[5] = (uint8_t)(pTiming->interByteTimeout >> 16);
+	pDest[6] = (uint8_t)(pTiming->interByteTimeout >> 8);
+	pDest[7] = (uint8_t)(pTiming->interByteTimeout);
+	pDest[8] = pTiming->ta1;
+	pDest[9] = pTiming->cwi;
+	pDest[10] = pTiming->bwi;
+	pDest[11] = (uint8_t)(((pTiming->flagAtrParsed != 0) ? 0x01 : 0x00) | ((pTiming->flagOverridden != 0) ? 0x02 : 0x00));
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ProcessTimingBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pBytes is a pointer on the payload of the timing block (see #BRIDGE2_TIMING_REQUEST_SIZE).
+ * \param nbBytes is the size of the payload.
+ * \param *pAnswer is a pointer on the BUFF_Buffer where the answer is built (see #BRIDGE2_TIMING_ANSWER_SIZE). It is reset by this function.
+ * This function overrides the waiting times used with the card and reports the ones now in use. Unlike the baudrate, they are applied right away as they do not affect the link with the computer.
+ */
+static BRIDGE2_Status BRIDGE2_ProcessTimingBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer){
+	BUFF_Status buffRv;
+	BRIDGE2_Status rv;
+	BRIDGE2_CardTiming *pTiming;
+	uint32_t firstByteTimeout, interByteTimeout;
+	uint8_t answer[BRIDGE2_TIMING_ANSWER_SIZE];
+	
+	
+	pTiming = &(globalBridgeHandle.cardTiming);
+	
+	if(nbBytes >= BRIDGE2_TIMING_REQUEST_SIZE){
+		firstByteTimeout = ((uint32_t)(pBytes[0]) << 24) | ((uint32_t)(pBytes[1]) << 16) | ((uint32_t)(pBytes[2]) << 8) | (uint32_t)(pBytes[3]);
+		interByteTimeout = ((uint32_t)(pBytes[4]) << 24) | ((uint32_t)(pBytes[5]) << 16) | ((uint32_t)(pBytes[6]) << 8) | (uint32_t)(pBytes[7]);
+		
+		if((firstByteTimeout == 0) && (interByteTimeout == 0)){
+			pTiming->flagOverridden = 0;
+			
+			rv = BRIDGE2_UpdateCardTiming();
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		}
+		else{
+			if(firstByteTimeout != 0) pTiming->firstByteTimeout = firstByteTimeout;
+			if(interByteTimeout != 0) pTiming->interByteTimeout = interByteTimeout;
+			pTiming->flagOverridden = 1;
+		}
+	}
+	
+	rv = BRIDGE2_EncodeCardTiming(answer);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	buffRv = BUFF_Init(pAnswer);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	buffRv = BUFF_EnqueueBytes(pAnswer, answer, BRIDGE2_TIMING_ANSWER_SIZE);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ProcessClockBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function. A frequency refused by the reader library is not an error, the answer reports the one still in use.
+ * \param *pBytes is a pointer on the payload of the clock block (see #BRIDGE2_CLOCK_REQUEST_SIZE).
+ * \param nbBytes is the size of the payload.
+ * \param *pAnswer is a pointer on the BUFF_Buffer where the answer is built (see #BRIDGE2_CLOCK_ANSWER_SIZE). It is reset by this function.
+ * This function changes the clock of the card within the limit given by its ATR, and reports the resulting ETU. The waiting times derived from the ATR follow the new clock (see BRIDGE2_UpdateCardTiming()).
+ */
+static BRIDGE2_Status BRIDGE2_ProcessClockBlock(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer){
+	READER_HAL_CommSettings *pSettings;
+	READER_Status readerRv;
+	BUFF_Status buffRv;
+	BRIDGE2_Status rv;
+	uint32_t freq, fmax, ta1Fmax, fi, di, etu;
+	uint8_t answer[BRIDGE2_CLOCK_ANSWER_SIZE];
+	
+	
+	pSettings = globalBridgeHandle.pCommSettings;
+	
+	fmax = BRIDGE2_DEFAULT_FMAX;
+	if((globalBridgeHandle.cardTiming.flagAtrParsed) != 0){
+		if(BRIDGE2_DecodeTa1(globalBridgeHandle.cardTiming.ta1, &fi, &di, &ta1Fmax) == BRIDGE2_OK){
+			fmax = ta1Fmax;
+		}
+	}
+	
+	if(nbBytes >= BRIDGE2_CLOCK_REQUEST_SIZE){
+		freq = ((uint32_t)(pBytes[0]) << 24) | ((uint32_t)(pBytes[1]) << 16) | ((uint32_t)(pBytes[2]) << 8) | (uint32_t)(pBytes[3]);
+		if((freq == 0) || (freq > fmax)) freq = fmax;
+		
+		/* The clock set by the reader library is restored before the next reset ...  */
+		if((globalBridgeHandle.cardDefaultFreq) == 0){
+			globalBridgeHandle.cardDefaultFreq = READER_HAL_GetFreq(pSettings);
+		}
+		
+		readerRv = READER_HAL_SetFreq(pSettings, freq);
+		if(readerRv == READER_OK){
+			rv = BRIDGE2_UpdateCardTiming();
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		}
+	}
+	
+	freq = READER_HAL_GetFreq(pSettings);
+	fi = READER_HAL_GetFi(pSettings);
+	di = READER_HAL_GetDi(pSettings);
+	
+	etu = 0;
+	if((freq != 0) && (di != 0)){
+		etu = (uint32_t)(((uint64_t)(fi) * 1000000000) / ((uint64_t)(di) * (uint64_t)(freq)));
+	}
+	
+	answer[0] = (uint8_t)(freq >> 24);
+	answer[1] = (uint8_t)(freq >> 16);
+	answer[2] = (uint8_t)(freq >> 8);
+	answer[3] = (uint8_t)(freq);
+	answer[4] = (uint8_t)(fmax >> 24);
+	answer[5] = (uint8_t)(fmax >> 16);
+	answer[6] = (uint8_t)(fmax >> 8);
+	answer[7] = (uint8_t)(fmax);
+	answer[8] = (uint8_t)(etu >> 24);
+	answer[9] = (uint8_t)(etu >> 16);
+	answer[10] = (uint8_t)(etu >> 8);
+	answer[11] = (uint8_t)(etu);
+	
+	buffRv = BUFF_Init(pAnswer);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	buffRv = BUFF_EnqueueBytes(pAnswer, answer, BRIDGE2_CLOCK_ANSWER_SIZE);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ApplyPendingBaudrate(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * This function switches to the baudrate recorded by BRIDGE2_ProcessBaudBlock(), if any, and starts waiting for its confirmation (see #BRIDGE2_BAUD_CONFIRM_TIMEOUT). It has to be called while no block is being received or sent.
+ */
+static BRIDGE2_Status BRIDGE2_ApplyPendingBaudrate(void){
+	BRIDGE2_Status rv;
+	
+	
+	if((globalBridgeHandle.flagBaudratePending) == 0){
+		return BRIDGE2_OK;
+	}
+	
+	globalBridgeHandle.flagBaudratePending = 0;
+	
+	/* An unconfirmed baudrate is never restored, we go back to the last one which has been working ...  */
+	if(((globalBridgeHandle.baudrateConfirmCountdown) == 0) && ((globalBridgeHandle.flagBaudrateRevertPending) == 0)){
+		globalBridgeHandle.previousBaudrate = globalBridgeHandle.computerBaudrate;
+	}
+	
+	rv = BRIDGE2_SetComputerBaudrate_Callback(globalBridgeHandle.pendingBaudrate);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	globalBridgeHandle.computerBaudrate = globalBridgeHandle.pendingBaudrate;
+	globalBridgeHandle.baudrateConfirmCountdown = BRIDGE2_BAUD_CONFIRM_TIMEOUT;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_CountDownBaudrateConfirm(uint32_t nbElapsedMs)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param nbElapsedMs is the number of milliseconds elapsed since the previous call.
+ * This function counts down the time left to the computer to confirm the current baudrate (see #BRIDGE2_BAUD_CONFIRM_TIMEOUT). When it runs out, the previous baudrate is marked to be restored by BRIDGE2_ApplyBaudrateRevert().
+ * It is called from BRIDGE2_ProcessTick(), the UART is not touched here.
+ */
+static BRIDGE2_Status BRIDGE2_CountDownBaudrateConfirm(uint32_t nbElapsedMs){
+	if((globalBridgeHandle.baudrateConfirmCountdown) == 0){
+		return BRIDGE2_OK;
+	}
+	
+	if(nbElapsedMs < (globalBridgeHandle.baudrateConfirmCountdown)){
+		globalBridgeHandle.baudrateConfirmCountdown -= nbElapsedMs;
+		return BRIDGE2_OK;
+	}
+	
+	globalBridgeHandle.baudrateConfirmCountdown = 0;
+	globalBridgeHandle.flagBaudrateRevertPending = 1;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ApplyBaudrateRevert(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * This function restores the previous baudrate when no block has been received at the new one in time (see BRIDGE2_CountDownBaudrateConfirm()). The partial block received meanwhile, if any, is dropped.
+ * It is called from BRIDGE2_ProcessTimerInterrupt(), below the priority of the UART interrupts.
+ */
+static BRIDGE2_Status BRIDGE2_ApplyBaudrateRevert(void){
+	BRIDGE2_Status rv;
+	SM_Status smRv;
+	
+	
+	if((globalBridgeHandle.flagBaudrateRevertPending) == 0){
+		return BRIDGE2_OK;
+	}
+	
+	/* The reception context is being accessed, we try again on the next processing ...  */
+	smRv = SM_DiscardRcvdBlock(&globalUsartHandle);
+	if((smRv != SM_OK) && (smRv != SM_BUSY)) return BRIDGE2_ERR;
+	
+	if(smRv == SM_BUSY){
+		return BRIDGE2_OK;
+	}
+	
+	rv = BRIDGE2_SetComputerBaudrate_Callback(globalBridgeHandle.previousBaudrate);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	globalBridgeHandle.computerBaudrate = globalBridgeHandle.previousBaudrate;
+	globalBridgeHandle.flagBaudrateRevertPending = 0;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ExchangeWithCard(SM_CtrlBlockType type, const uint8_t *pBytes, uint32_t nbBytes)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param type is the type of the block received from the computer (#SM_DATA_BLOCK or #SM_SEQUENCE_BLOCK).
+ * \param *pBytes is a pointer on the payload of this block.
+ * \param nbBytes is the size of the payload.
+ * This function executes the block against the card. The answer to be sent back to the computer is put in the cardRcvdBytes buffer.
+ * The computer is held (RTS deasserted) during the whole exchange when the RTS/CTS flow control is enabled.
+ */
+static BRIDGE2_Status BRIDGE2_ExchangeWithCard(SM_CtrlBlockType type, const uint8_t *pBytes, uint32_t nbBytes){
+	BRIDGE2_Status rv, exchangeRv;
+	
+	
+	rv = BRIDGE2_SetCardExchangeOngoing(1);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	exchangeRv = BRIDGE2_RunCardExchange(type, pBytes, nbBytes);
+	
+	rv = BRIDGE2_SetCardExchangeOngoing(0);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	
+	return exchangeRv;
+}
+
+
+static BRIDGE2_Status BRIDGE2_RunCardExchange(SM_CtrlBlockType type, const uint8_t *pBytes, uint32_t nbBytes){
+	BRIDGE2_Status rv;
+	READER_Status readerRv;
+	
+	
+	if(type == SM_SEQUENCE_BLOCK){
+		rv = BRIDGE2_ExecuteSequence(pBytes, nbBytes, &(globalBridgeHandle.cardRcvdBytes));
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		return BRIDGE2_OK;
+	}
+	
+	rv = BRIDGE2_SendBytesToCard(pBytes, nbBytes, globalBridgeHandle.cardTiming.interByteTimeout);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	readerRv = READER_HAL_WaitUntilSendComplete(globalBridgeHandle.pCommSettings);
+	if(readerRv != READER_OK) return BRIDGE2_ERR;
+	
+	/* We get back the answer from the card in a temporary buffer ... */
+	rv = BRIDGE2_RcvBufferFromCard(&(globalBridgeHandle.cardRcvdBytes));
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ExchangeWithCardStreamed(const uint8_t *pBytes, uint32_t nbBytes)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * \param *pBytes is a pointer on the command to be sent to the card.
+ * \param nbBytes is the size of the command.
+ * Same as BRIDGE2_ExchangeWithCard() followed by BRIDGE2_SendAnswerToComputer() for a data block, but the answer is sent to the computer while it is received (see BRIDGE2_SetAnswerStreaming()).
+ */
+static BRIDGE2_Status BRIDGE2_ExchangeWithCardStreamed(const uint8_t *pBytes, uint32_t nbBytes){
+	BRIDGE2_Status rv, exchangeRv;
+	READER_Status readerRv;
+	
+	
+	rv = BRIDGE2_SetCardExchangeOngoing(1);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	exchangeRv = BRIDGE2_SendBytesToCard(pBytes, nbBytes, globalBridgeHandle.cardTiming.interByteTimeout);
+	
+	if(exchangeRv == BRIDGE2_OK){
+		readerRv = READER_HAL_WaitUntilSendComplete(globalBridgeHandle.pCommSettings);
+		exchangeRv = (readerRv == READER_OK) ? BRIDGE2_OK : BRIDGE2_ERR;
+	}
+	
+	if(exchangeRv == BRIDGE2_OK){
+		exchangeRv = BRIDGE2_StreamAnswerFromCard();
+	}
+	
+	rv = BRIDGE2_SetCardExchangeOngoing(0);
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	
+	return exchangeRv;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_StreamAnswerFromCard(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * This function receives the answer of the card in the cardRcvdBytes buffer. Once its T=1 prologue is received, the data block carrying it is started with the size given by the LEN byte and the next bytes are pushed to the computer as they arrive (see #SM_SendBlockStreamed()).
+ * The first character is waited for the Block Waiting Time, the next ones for the Character Waiting Time, as in BRIDGE2_RcvBufferFromCard().
+ * If the state machine is not free when the prologue is received, the answer is completely received and queued as without streaming.
+ */
+static BRIDGE2_Status BRIDGE2_StreamAnswerFromCard(void){
+	BUFF_Status buffRv;
+	READER_Status readerRv;
+	SM_Status smRv;
+	BRIDGE2_Status rv;
+	READER_HAL_CommSettings *pSettings;
+	uint8_t byte, prologue[BRIDGE2_T1_PROLOGUE_SIZE];
+	uint32_t nbRcvdBytes, nbExpectedBytes, timeout;
+	
+	
+	pSettings = globalBridgeHandle.pCommSettings;
+	nbRcvdBytes = 0;
+	timeout = globalBridgeHandle.cardTiming.firstByteTimeout;
+	
+	buffRv = BUFF_Init(&(globalBridgeHandle.cardRcvdBytes));
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	/* Receiving the prologue, it gives the size of the answer ...  */
+	while(nbRcvdBytes < BRIDGE2_T1_PROLOGUE_SIZE){
+		readerRv = READER_HAL_RcvChar(pSettings, READER_HAL_PROTOCOL_T1, &byte, timeout);
+		if((readerRv != READER_OK) && (readerRv != READER_TIMEOUT)) return BRIDGE2_ERR;
+		
+		/* The answer is too short to be a T=1 block, it is sent as it is ...  */
+		if(readerRv == READER_TIMEOUT){
+			rv = BRIDGE2_SendAnswerToComputer(SM_DATA_BLOCK);
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+			
+			return BRIDGE2_OK;
+		}
+		
+		buffRv = BUFF_Enqueue(&(globalBridgeHandle.cardRcvdBytes), byte);
+		if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+		
+		prologue[nbRcvdBytes] = byte;
+		nbRcvdBytes++;
+		timeout = globalBridgeHandle.cardTiming.interByteTimeout;
+	}
+	
+	nbExpectedBytes = BRIDGE2_T1_PROLOGUE_SIZE + (uint32_t)(prologue[2]) + (((globalBridgeHandle.cardFraming) == BRIDGE2_CARD_FRAMING_T1_CRC) ? 2 : 1);
+	
+	/* LEN 0xFF is reserved, the end of such an answer is only known when the card is silent. The block can not be started either when other blocks are waiting for the state machine ...  */
+	if((prologue[2] == 0xFF) || ((globalBridgeHandle.outQueue.nbBlocks) != 0)){
+		smRv = SM_BUSY;
+	}
+	else{
+		smRv = SM_SendBlockStreamed(&globalUsartHandle, &(globalBridgeHandle.cardRcvdBytes), SM_DATA_BLOCK, nbExpectedBytes);
+		if((smRv != SM_OK) && (smRv != SM_BUSY)) return BRIDGE2_ERR;
+	}
+	
+	/* The answer is then completely received before being queued ...  */
+	if(smRv == SM_BUSY){
+		while(BRIDGE2_IsCardFrameComplete(prologue, nbRcvdBytes) != BRIDGE2_OK){
+			readerRv = READER_HAL_RcvChar(pSettings, READER_HAL_PROTOCOL_T1, &byte, timeout);
+			if((readerRv != READER_OK) && (readerRv != READER_TIMEOUT)) return BRIDGE2_ERR;
+			
+			if(readerRv == READER_TIMEOUT){
+				break;
+			}
+			
+			buffRv = BUFF_Enqueue(&(globalBridgeHandle.cardRcvdBytes), byte);
+			if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+			
+			nbRcvdBytes++;
+		}
+		
+		rv = BRIDGE2_SendAnswerToComputer(SM_DATA_BLOCK);
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		return BRIDGE2_OK;
+	}
+	
+	globalBridgeHandle.flagAckExpected = 1;
+	
+	readerRv = READER_OK;
+	while(nbRcvdBytes < nbExpectedBytes){
+		if(readerRv != READER_TIMEOUT){
+			readerRv = READER_HAL_RcvChar(pSettings, READER_HAL_PROTOCOL_T1, &byte, timeout);
+			if((readerRv != READER_OK) && (readerRv != READER_TIMEOUT)) return BRIDGE2_ERR;
+		}
+		
+		/* The card stopped before the end of its block, the announced size has to be sent anyway ...  */
+		if(readerRv == READER_TIMEOUT){
+			byte = 0x00;
+		}
+		
+		smRv = SM_StreamBytes(&globalUsartHandle, &byte, 1);
+		if(smRv != SM_OK) return BRIDGE2_ERR;
+		
+		nbRcvdBytes++;
+	}
+	
+	
+	return BRIDGE2_OK;
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_ExecuteSequence(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function. A failed exchange with the card is not an error, it is reported in the answer.
+ * \param *pBytes is a pointer on the payload of a sequence block (see #BRIDGE2_SeqStatus for its format).
+ * \param nbBytes is the size of the payload.
+ * \param *pAnswer is a pointer on the BUFF_Buffer where the reply is built. It is reset by this function.
+ * This function executes the commands of a sequence block back-to-back against the card.
+ * The commands which can not be reported in the reply (not even their entry header) are not executed.
+ */
+static BRIDGE2_Status BRIDGE2_ExecuteSequence(const uint8_t *pBytes, uint32_t nbBytes, BUFF_Buffer *pAnswer){
+	BRIDGE2_Status rv;
+	BUFF_Status buffRv;
+	READER_Status readerRv;
+	BRIDGE2_SeqStatus status;
+	uint32_t i, cmdSize, answerSize, room;
+	
+	
+	buffRv = BUFF_Init(pAnswer);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	i = 0;
+	
+	while(i < nbBytes){
+		buffRv = BUFF_GetCurrentSize(pAnswer, &room);
+		if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+		
+		room = BUFF_MAX_SIZE - room;
+		if(room < BRIDGE2_SEQ_ENTRY_HEADER_SIZE){
+			return BRIDGE2_OK;
+		}
+		room -= BRIDGE2_SEQ_ENTRY_HEADER_SIZE;
+		
+		/* The length of the command has to be complete and consistent with the remaining bytes ...  */
+		if((nbBytes - i) < 2){
+			return BRIDGE2_AppendSequenceEntry(pAnswer, BRIDGE2_SEQ_MALFORMED, NULL, 0);
+		}
+		
+		cmdSize = ((uint32_t)(pBytes[i]) << 8) | (uint32_t)(pBytes[i + 1]);
+		i += 2;
+		
+		if(cmdSize > (nbBytes - i)){
+			return BRIDGE2_AppendSequenceEntry(pAnswer, BRIDGE2_SEQ_MALFORMED, NULL, 0);
+		}
+		
+		answerSize = 0;
+		status = BRIDGE2_SEQ_CARD_ERR;
+		
+		rv = BRIDGE2_SendBytesToCard(pBytes + i, cmdSize, globalBridgeHandle.cardTiming.interByteTimeout);
+		if(rv == BRIDGE2_OK){
+			readerRv = READER_HAL_WaitUntilSendComplete(globalBridgeHandle.pCommSettings);
+			if(readerRv == READER_OK){
+				rv = BRIDGE2_RcvBytesFromCard(globalBridgeHandle.cardRcvdData, room, &answerSize);
+				
+				if(rv == BRIDGE2_NO){
+					status = BRIDGE2_SEQ_TRUNCATED;
+				}
+				else if((rv == BRIDGE2_OK) && (answerSize == 0)){
+					status = BRIDGE2_SEQ_NO_ANSWER;
+				}
+				else if(rv == BRIDGE2_OK){
+					status = BRIDGE2_SEQ_OK;
+				}
+			}
+		}
+		
+		rv = BRIDGE2_AppendSequenceEntry(pAnswer, status, globalBridgeHandle.cardRcvdData, answerSize);
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		i += cmdSize;
+	}
 	
 	
 	return BRIDGE2_OK;
 }
 
 
-/**
- * \fn BRIDGE2_Status BRIDGE2_ProcessTxeInterrupt(uint8_t *pByteToSend)
- * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
- * \param *pByteToSend is a pointer on an uint8_t value. The location will be filled with the next byte that has to be sent by the UART interrupt routine.
- * This function is designed to be called from a UART buffer empty interrupt routine. It is aimed to transmitthe next byte ready to be sent back to the computer and to evolve bridge's state consequently.
- * When implementing the bridge for a specific target, the developper is in charge of configuring the UART interruption and to place a call to this function inside.
- * Warning : this function operates on the globalUsartHandle global data structure which is local to this file.
- */
-BRIDGE2_Status BRIDGE2_ProcessTxeInterrupt(uint8_t *pByteToSend){
-	SM_Status smRv;
-	BRIDGE2_Status rv;
+static BRIDGE2_Status BRIDGE2_AppendSequenceEntry(BUFF_Buffer *pAnswer, BRIDGE2_SeqStatus status, const uint8_t *pBytes, uint32_t nbBytes){
+	BUFF_Status buffRv;
+	uint8_t header[BRIDGE2_SEQ_ENTRY_HEADER_SIZE];
 	
 	
-	smRv = SM_EvolveStateOnByteTransmission(&globalUsartHandle, pByteToSend);
-	if((smRv != SM_OK) && (smRv != SM_EMPTY)) return BRIDGE2_ERR;
+	header[0] = (uint8_t)(status);
+	header[1] = (uint8_t)(nbBytes >> 8);
+	header[2] = (uint8_t)(nbBytes);
 	
-	if(smRv == SM_EMPTY){
-		rv = BRIDGE2_DisableTxeInterrupt_Callback();
-		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
-		
-		return BRIDGE2_EMPTY;
+	buffRv = BUFF_EnqueueBytes(pAnswer, header, BRIDGE2_SEQ_ENTRY_HEADER_SIZE);
+	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	
+	if(nbBytes != 0){
+		buffRv = BUFF_EnqueueBytes(pAnswer, pBytes, nbBytes);
+		if(buffRv != BUFF_OK) return BRIDGE2_ERR;
 	}
 	
 	
@@ -250,218 +2581,254 @@ BRIDGE2_Status BRIDGE2_ProcessTxeInterrupt(uint8_t *pByteToSend){
 }
 
 
-/**
- * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_EnableTxeInterrupt_Callback(void)
- * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
- * The implementer of the bridge for a specific target has to make its own implementation of this function because its code might be hardware dependent.
- * The implementation of this function has to enable the TX Empty interruption of the UART peripheral.
- * The developper has to make sure to return a BRIDGE2_OK execution code if the interruption is correctly activated.
- */
-__attribute__((weak)) BRIDGE2_Status BRIDGE2_EnableTxeInterrupt_Callback(void){
-	return BRIDGE2_OK;
-}
-
-
-/**
- * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_DisableTxeInterrupt_Callback(void)
- * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
- * The implementer of the bridge for a specific target has to make its own implementation of this function because its code might be hardware dependent.
- * The implementation of this function has to disable the TX Empty interruption of the UART peripheral.
- * The developper has to make sure to return a BRIDGE2_OK execution code if the interruption is correctly activated.
- */
-__attribute__((weak)) BRIDGE2_Status BRIDGE2_DisableTxeInterrupt_Callback(void){
-	return BRIDGE2_OK;
-}
-
-
-/**
- * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_EnableTxeInterrupt_Callback(void)
- * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
- * The implementer of the bridge for a specific target has to make its own implementation of this function because its code might be hardware dependent.
- * The implementation of this function has to enable the RX Not Empty interruption of the UART peripheral.
- * The developper has to make sure to return a BRIDGE2_OK execution code if the interruption is correctly activated.
- */
-__attribute__((weak)) BRIDGE2_Status BRIDGE2_EnableRxneInterrupt_Callback(void){
-	return BRIDGE2_OK;
-}
-
-
-/**
- * \fn __attribute__((weak)) BRIDGE2_Status BRIDGE2_DisableRxneInterrupt_Callback(void)
- * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
- * The implementer of the bridge for a specific target has to make its own implementation of this function because its code might be hardware dependent.
- * The implementation of this function has to diable the RX Not Empty interruption of the UART peripheral.
- * The developper has to make sure to return a BRIDGE2_OK execution code if the interruption is correctly activated.
- */
-__attribute__((weak)) BRIDGE2_Status BRIDGE2_DisableRxneInterrupt_Callback(void){
+static BRIDGE2_Status BRIDGE2_StartNewReception(void){
+	BRIDGE2_Status rv;
+	SM_Status smRv;
+	
+	
+	globalBridgeHandle.flagReceptionPending = 0;
+	
+	/* We check if we have to start another block reception from the computer ...  */
+	if((globalBridgeHandle.state) == BRIDGE2_RUNNING){
+		/* In stop-and-wait mode the payload directly lands in a linear array, in windowed mode several payloads are queued in a circular buffer ...  */
+		if(BRIDGE2_IsWindowedMode() == BRIDGE2_OK){
+			smRv = SM_ReceiveBlock(&globalUsartHandle, &(globalBridgeHandle.computerRcvdBytes));
+		}
+		else{
+			smRv = SM_ReceiveBlockLinear(&globalUsartHandle, &(globalBridgeHandle.computerRcvdBlock));
+		}
+		if((smRv != SM_OK) && (smRv != SM_BUSY)) return BRIDGE2_ERR;
+		
+		/* The reception context is being accessed, we try again on the next processing ...  */
+		if(smRv == SM_BUSY){
+			globalBridgeHandle.flagReceptionPending = 1;
+		}
+	}
+	else{
+		/* If we receive a block after the bridge has been stopped it means this is the last one ...  */
+		rv = BRIDGE2_DisableTimerInterrupt_Callback();
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	}
+	
+	
 	return BRIDGE2_OK;
 }
 
 
-__attribute__((weak)) BRIDGE2_Status BRIDGE2_Sleep_Callback(void){
+static BRIDGE2_Status BRIDGE2_ApplyRcvdCtrlBlock(void){
+	BRIDGE2_Status rv;
+	SM_CtrlBlockType answerType;
+	
+	
+	/* Sequence, hello, baud, timing, clock and reset blocks are answered like a data block, the next reception starts once the answer is acknowledged ...  */
+	if(BRIDGE2_GetAnswerType(globalBridgeHandle.rcvdBlockType, &answerType) == BRIDGE2_OK){
+		rv = BRIDGE2_BuildAnswer(globalBridgeHandle.rcvdBlockType, globalBridgeHandle.computerRcvdBlock.pData, globalBridgeHandle.computerRcvdBlock.size);
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		rv = BRIDGE2_SendAnswerToComputer(answerType);
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+		
+		return BRIDGE2_OK;
+	}
+	
+	rv = BRIDGE2_StartNewReception();
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
+	
 	return BRIDGE2_OK;
 }
 
 
-
-/* Private functions declarations ...  */
-
 /**
- * \fn static BRIDGE2_Status BRIDGE2_SendBufferToCard(BUFF_Buffer *pBuffer)
- * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
- * \param *pBuffer is a pointer to a BUFF_Buffer data structure containing the bytes of data to be sent to the smartcard on the I/O half-duplex transmission line.
- * This function transmists a buffer of bytes to the smartcard by making use of the iso7816 reader librairy.
+ * \fn static BRIDGE2_Status BRIDGE2_GetAnswerType(SM_CtrlBlockType type, SM_CtrlBlockType *pAnswerType)
+ * \return BRIDGE2_OK if a block of this type is answered, BRIDGE2_NO otherwise.
+ * \param type is the type of the block received from the computer.
+ * \param *pAnswerType is a pointer on the type of the block carrying the answer. Only meaningful when BRIDGE2_OK is returned.
+ * Both reset blocks are answered by an ATR block (see #BRIDGE2_RESET_ANSWER_HEADER_SIZE), the other ones by a block of the same type.
  */
-static BRIDGE2_Status BRIDGE2_SendBufferToCard(BUFF_Buffer *pBuffer){
-	BUFF_Status buffRv;
-	READER_Status readerRv;
-	READER_HAL_CommSettings *pSettings;
-	uint8_t byte;
-	
-	
-	pSettings = globalBridgeHandle.pCommSettings;
+static BRIDGE2_Status BRIDGE2_GetAnswerType(SM_CtrlBlockType type, SM_CtrlBlockType *pAnswerType){
+	if((type == SM_DATA_BLOCK) || (type == SM_SEQUENCE_BLOCK) || (type == SM_HELLO_BLOCK) || (type == SM_BAUD_BLOCK) || (type == SM_TIMING_BLOCK) || (type == SM_CLOCK_BLOCK)){
+		*pAnswerType = type;
+		return BRIDGE2_OK;
+	}
 	
-	while(BUFF_IsEmpty(pBuffer) == BUFF_NO){
-		buffRv = BUFF_Dequeue(pBuffer, &byte);
-		if(buffRv != BUFF_OK) return BRIDGE2_ERR;
-		
-		readerRv = READER_HAL_SendChar(pSettings, READER_HAL_PROTOCOL_T1, byte, BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT);
-		if(readerRv != READER_OK) return BRIDGE2_ERR;
+	if((type == SM_COLD_RST_BLOCK) || (type == SM_WARM_RST_BLOCK)){
+		*pAnswerType = SM_ATR_BLOCK;
+		return BRIDGE2_OK;
 	}
 	
 	
-	return BRIDGE2_OK;
+	return BRIDGE2_NO;
 }
 
 
 /**
- * \fn static BRIDGE2_Status BRIDGE2_RcvBufferFromCard(BUFF_Buffer *pBuffer)
+ * \fn static BRIDGE2_Status BRIDGE2_ProcessRcvdBlocksQueue(void)
  * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
- * \param *pBuffer is a pointer to a BUFF_Buffer data structure where the received bytes (from the smartcard) are going to be placed in. The buffer will be reset by this function before putting the bytes in.
- * This function receives characters from the smartcard on the I/O transmission line. It stops when timeout or when the buffer overflows.
+ * This function processes, in order, all the blocks queued by the state machine in windowed mode.
+ * A data block is only processed when the answer of the card can be sent back right away, otherwise we stop and try again on the next timer interrupt.
+ * Each processed block is released, which acknowledges it to the computer.
  */
-static BRIDGE2_Status BRIDGE2_RcvBufferFromCard(BUFF_Buffer *pBuffer){
+static BRIDGE2_Status BRIDGE2_ProcessRcvdBlocksQueue(void){
+	BRIDGE2_Status rv;
 	BUFF_Status buffRv;
-	READER_Status readerRv;
-	READER_HAL_CommSettings *pSettings;
-	uint8_t byte;
-	
+	SM_Status smRv;
+	SM_CtrlBlockType type, answerType;
+	uint32_t size;
 	
-	pSettings = globalBridgeHandle.pCommSettings;
 	
-	buffRv = BUFF_Init(pBuffer);
-	if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+	globalBridgeHandle.flagDataBlockReceived = 0;
+	globalBridgeHandle.flagCtrlBlockReceived = 0;
 	
-	do{
-		readerRv = READER_HAL_RcvChar(pSettings, READER_HAL_PROTOCOL_T1, &byte, BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT);
-		if((readerRv != READER_OK) && (readerRv != READER_TIMEOUT)) return BRIDGE2_ERR;
-		
-		if(readerRv != READER_TIMEOUT){
-			buffRv = BUFF_Enqueue(pBuffer, byte);
+	while((smRv = SM_GetRcvdBlockInfo(&globalUsartHandle, &type, &size)) == SM_OK){
+		if(BRIDGE2_GetAnswerType(type, &answerType) == BRIDGE2_OK){
+			/* The card answer buffer is still being sent to the computer or the window is full ...  */
+			if(SM_IsReadyToSend(&globalUsartHandle, answerType) != SM_OK){
+				return BRIDGE2_OK;
+			}
+			
+			/* We move the payload of this block out of the reception buffer, the reception is still running in the background ...  */
+			rv = BRIDGE2_DisableRxneInterrupt_Callback();
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+			
+			buffRv = BUFF_DequeueBytes(&(globalBridgeHandle.computerRcvdBytes), globalBridgeHandle.computerRcvdData, size);
 			if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+			
+			rv = BRIDGE2_UpdateRts();
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+			
+			rv = BRIDGE2_EnableRxneInterrupt_Callback();
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+			
+			/* We exchange with the card and we send back the answer ...  */
+			rv = BRIDGE2_BuildAnswer(type, globalBridgeHandle.computerRcvdData, size);
+			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+			
+			smRv = SM_SendBlock(&globalUsartHandle, &(globalBridgeHandle.cardRcvdBytes), answerType);
+			if(smRv != SM_OK) return BRIDGE2_ERR;
 		}
 		
-	}while(readerRv != READER_TIMEOUT);
+		smRv = SM_ReleaseRcvdBlock(&globalUsartHandle);
+		if(smRv != SM_OK) return BRIDGE2_ERR;
+		
+		/* Does nothing if the reception is still running, stops the bridge if it has been requested ...  */
+		rv = BRIDGE2_StartNewReception();
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	}
+	
+	if(smRv != SM_NO) return BRIDGE2_ERR;
 	
 	
 	return BRIDGE2_OK;
 }
 
 
-/**
- * \fn static BRIDGE2_Status BRIDGE2_ApplyColdReset(void)
- * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
- * This function applies a cold reset procedure to the smartcard. See ISO/IEC7816-3 section 6.2.2.
- */
-static BRIDGE2_Status BRIDGE2_ApplyColdReset(void){
-	READER_Status readerRv;
+static BRIDGE2_Status BRIDGE2_IsWindowedMode(void){
+	SM_Status smRv;
+	uint32_t windowSize;
 	
 	
-	readerRv = READER_HAL_DoColdReset();
-	if(readerRv != READER_OK) return BRIDGE2_ERR;
+	smRv = SM_GetWindowSize(&globalUsartHandle, &windowSize);
+	if(smRv != SM_OK) return BRIDGE2_ERR;
 	
-	return BRIDGE2_OK;
+	if(windowSize > 1){
+		return BRIDGE2_OK;
+	}
+	
+	
+	return BRIDGE2_NO;
 }
 
 
-static BRIDGE2_Status BRIDGE2_ApplyRcvdDataBlock(void){
-	BRIDGE2_Status rv;
-	READER_Status status;
-	READER_HAL_CommSettings *pSettings;
+/* Drops the block being received, or defers it to the next byte or processing if the reception context is busy ...  */
+static BRIDGE2_Status BRIDGE2_Resync(void){
 	SM_Status smRv;
 	
 	
-	pSettings = globalBridgeHandle.pCommSettings;
-	
-	/* We send to the card the previously received data from the computer ...  */
-	rv = BRIDGE2_SendBufferToCard(&(globalBridgeHandle.computerRcvdBytes));
-	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
-	
-	status = READER_HAL_WaitUntilSendComplete(pSettings);
-	if(status != READER_OK) return BRIDGE2_ERR;
-	
-	/* We get back the answer from the card in a temporary buffer ... */
-	rv = BRIDGE2_RcvBufferFromCard(&(globalBridgeHandle.cardRcvdBytes));
-	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	if((globalBridgeHandle.flagResyncPending) == 0){
+		globalBridgeHandle.rxErrors.nbResyncs++;
+	}
 	
-	/* We send this data back to the computer inside a block ...  */
-	do{	
-		smRv = SM_SendBlock(&globalUsartHandle, &(globalBridgeHandle.cardRcvdBytes), SM_DATA_BLOCK);
-		if((smRv != SM_OK) && (smRv != SM_BUSY)) return BRIDGE2_ERR;
-	}while(smRv == SM_BUSY);   /* TODO : Adding a sleep function ?? ...  */
+	smRv = SM_DiscardRcvdBlock(&globalUsartHandle);
+	if((smRv != SM_OK) && (smRv != SM_BUSY)) return BRIDGE2_ERR;
 	
-	rv = BRIDGE2_EnableTxeInterrupt_Callback();  /* TODO : Remove this line (dead code ??) */
-	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	if(smRv == SM_BUSY){
+		globalBridgeHandle.flagResyncPending = 1;
+		return BRIDGE2_OK;
+	}
 	
-	globalBridgeHandle.flagAckExpected = 1;
+	globalBridgeHandle.flagResyncPending = 0;
 	
 	
 	return BRIDGE2_OK;
 }
 
 
-static BRIDGE2_Status BRIDGE2_StartNewReception(void){
+/* Handles, below the UART priority, the events which are due according to BRIDGE2_ProcessTick() ...  */
+static BRIDGE2_Status BRIDGE2_ProcessTimerEvents(void){
 	BRIDGE2_Status rv;
 	SM_Status smRv;
 	
 	
-	/* We check if we have to start another block reception from the computer ...  */
-	if((globalBridgeHandle.state) == BRIDGE2_RUNNING){
-		do{
-			smRv = SM_ReceiveBlock(&globalUsartHandle, &(globalBridgeHandle.computerRcvdBytes));   /* TODO : Adding a sleep function ?? ...  */
-			if((smRv != SM_OK) && (smRv != SM_BUSY)) return BRIDGE2_ERR;
-		}while(smRv == SM_BUSY);
+	if((globalBridgeHandle.state) == BRIDGE2_IDLE){
+		return BRIDGE2_OK;
 	}
-	else{
-		/* If we receive a block after the bridge has been stopped it means this is the last one ...  */
-		rv = BRIDGE2_DisableTimerInterrupt_Callback();
+	
+	smRv = SM_ProcessTimerEvents(&globalUsartHandle);
+	if(smRv != SM_OK) return BRIDGE2_ERR;
+	
+	if((globalBridgeHandle.flagResyncPending) != 0){
+		rv = BRIDGE2_Resync();
 		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
 	}
 	
+	rv = BRIDGE2_ApplyBaudrateRevert();
+	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	
 	
 	return BRIDGE2_OK;
 }
 
 
-static BRIDGE2_Status BRIDGE2_ApplyRcvdCtrlBlock(void){
+static BRIDGE2_Status BRIDGE2_SetCardExchangeOngoing(uint32_t flagOngoing){
+	globalBridgeHandle.flagCardExchangeOngoing = flagOngoing;
+	
+	return BRIDGE2_UpdateRts();
+}
+
+
+/**
+ * \fn static BRIDGE2_Status BRIDGE2_UpdateRts(void)
+ * \return BRIDGE2_Status execution code. BRIDGE2_OK indicates nominal execution of the function.
+ * This function deasserts RTS while a card exchange is running or when less than #BRIDGE2_RTS_ROOM_MARGIN bytes are left in the reception buffer (windowed mode), and asserts it otherwise.
+ * In stop-and-wait mode the computer does not send more than one block before its answer, only the card exchanges hold it.
+ * The callback is only called when the state of the line changes.
+ */
+static BRIDGE2_Status BRIDGE2_UpdateRts(void){
 	BRIDGE2_Status rv;
-	SM_CtrlBlockType type;
+	BUFF_Status buffRv;
+	uint32_t flagReady, currentSize;
 	
 	
-	type = globalBridgeHandle.rcvdBlockType;
+	if((globalBridgeHandle.flagRtsFlowCtrl) == 0){
+		return BRIDGE2_OK;
+	}
 	
-	switch(type){
-		case SM_COLD_RST_BLOCK:
-			rv = BRIDGE2_ApplyColdReset();
-			if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
-			break;
-			
-		default:
-			break;
+	flagReady = ((globalBridgeHandle.flagCardExchangeOngoing) == 0);
+	
+	if((flagReady != 0) && (BRIDGE2_IsWindowedMode() == BRIDGE2_OK)){
+		buffRv = BUFF_GetCurrentSize(&(globalBridgeHandle.computerRcvdBytes), &currentSize);
+		if(buffRv != BUFF_OK) return BRIDGE2_ERR;
+		
+		flagReady = ((BUFF_MAX_SIZE - currentSize) >= BRIDGE2_RTS_ROOM_MARGIN);
 	}
 	
-	rv = BRIDGE2_StartNewReception();
-	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	if(flagReady != (globalBridgeHandle.flagRtsAsserted)){
+		globalBridgeHandle.flagRtsAsserted = flagReady;
+		
+		rv = BRIDGE2_SetRts_Callback(flagReady);
+		if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
+	}
 	
 	
 	return BRIDGE2_OK;
@@ -474,6 +2841,11 @@ SM_Status SM_BlockRecievedCallback(SM_Handle *pHandle){
 	BRIDGE2_Status rv;
 	
 	
+	/* In windowed mode the reception is continuous ...  */
+	if(BRIDGE2_IsWindowedMode() == BRIDGE2_OK){
+		return SM_OK;
+	}
+	
 	rv = BRIDGE2_DisableRxneInterrupt_Callback();
 	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
 	
@@ -482,18 +2854,56 @@ SM_Status SM_BlockRecievedCallback(SM_Handle *pHandle){
 }
 
 
+/* A well-formed block has been received, the current baudrate works in both directions ...  */
 SM_Status SM_CtrlBlockRecievedCallback(SM_Handle *pHandle){
+	BRIDGE2_Status rv;
+	
+	
 	globalBridgeHandle.flagCtrlBlockReceived = 1;
 	globalBridgeHandle.rcvdBlockType = pHandle->rcvHandle.currentBlockType;
+	globalBridgeHandle.baudrateConfirmCountdown = 0;
+	globalBridgeHandle.flagBaudrateRevertPending = 0;
+	
+	rv = BRIDGE2_RequestProcessing_Callback();
+	if(rv != BRIDGE2_OK) return SM_ERR;
 	
 	
 	return SM_OK;
 }
 
 
-SM_Status SM_DataBlockRecievedCallback(SM_Handle *pHandle){	
+SM_Status SM_DataBlockRecievedCallback(SM_Handle *pHandle){
+	BRIDGE2_Status rv;
+	
+	
 	globalBridgeHandle.flagDataBlockReceived = 1;
 	globalBridgeHandle.rcvdBlockType = SM_DATA_BLOCK;
+	globalBridgeHandle.baudrateConfirmCountdown = 0;
+	globalBridgeHandle.flagBaudrateRevertPending = 0;
+	
+	rv = BRIDGE2_RequestProcessing_Callback();
+	if(rv != BRIDGE2_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/* In cut-through mode, the payload of a data block is forwarded to the card from the timer interrupt routine as it arrives ...  */
+SM_Status SM_DataPayloadStartedCallback(SM_Handle *pHandle){
+	BRIDGE2_Status rv;
+	
+	
+	if(((globalBridgeHandle.flagCutThrough) == 0) || (BRIDGE2_IsWindowedMode() == BRIDGE2_OK)){
+		return SM_OK;
+	}
+	
+	globalBridgeHandle.cutThroughNbExpected = pHandle->rcvHandle.nbDataExpected;
+	globalBridgeHandle.flagCutThroughRestart = 1;
+	globalBridgeHandle.flagCutThroughOngoing = 1;
+	
+	rv = BRIDGE2_RequestProcessing_Callback();
+	if(rv != BRIDGE2_OK) return SM_ERR;
 	
 	
 	return SM_OK;
@@ -507,6 +2917,12 @@ SM_Status SM_BlockSentCallback(SM_Handle *pHandle){
 	rv = BRIDGE2_DisableTxeInterrupt_Callback();
 	if(rv != BRIDGE2_OK) return BRIDGE2_ERR;
 	
+	/* The state machine is free, the blocks waiting for it can be sent ...  */
+	if((globalBridgeHandle.outQueue.nbBlocks) != 0){
+		rv = BRIDGE2_RequestProcessing_Callback();
+		if(rv != BRIDGE2_OK) return SM_ERR;
+	}
+	
 	
 	return SM_OK;
 }
@@ -557,9 +2973,35 @@ SM_Status SM_DisableTxeInterrupt_Callback(SM_Handle *pHandle){
 
 
 SM_Status SM_ACK_BLOCK_ReceivedCallback(SM_Handle *pHandle){
+	BRIDGE2_Status rv;
+	
+	
+	if((globalBridgeHandle.flagAckExpected) != 0){
+		globalBridgeHandle.flagAckReceived = 1;
+	}
+	
+	/* In windowed mode, the acknowledgement may open the window for the answers still queued ...  */
+	rv = BRIDGE2_RequestProcessing_Callback();
+	if(rv != BRIDGE2_OK) return SM_ERR;
+	
+	return SM_OK;
+}
+
+
+/* The response to the computer has been given up, we do as if it was acknowledged so that the timer routine waits for the next command ...  */
+/* The computer may not have received a hello or baud answer, the link parameters are kept.                                           */
+SM_Status SM_AckTimeoutCallback(SM_Handle *pHandle){
+	BRIDGE2_Status rv;
+	
+	
 	if((globalBridgeHandle.flagAckExpected) != 0){
 		globalBridgeHandle.flagAckReceived = 1;
+		globalBridgeHandle.flagLinkSettingsPending = 0;
+		globalBridgeHandle.flagBaudratePending = 0;
 	}
 	
+	rv = BRIDGE2_RequestProcessing_Callback();
+	if(rv != BRIDGE2_OK) return SM_ERR;
+	
 	return SM_OK;
 }
@@ -1,4 +1,5 @@
 #include "bytes_buffer.h"
+#include <string.h>
 
 
 
@@ -60,6 +61,35 @@ BUFF_Status BUFF_Enqueue(BUFF_Buffer *pBuffer, uint8_t byte){
 }
 
 
+BUFF_Status BUFF_EnqueueBytes(BUFF_Buffer *pBuffer, const uint8_t *pBytes, uint32_t nbBytes){
+	uint32_t firstPart;
+	
+	
+	if((pBuffer == NULL) || (pBytes == NULL)){
+		return BUFF_ERR;
+	}
+	
+	/* Either all the bytes fit in the buffer or none is enqueued ...  */
+	if(nbBytes > (BUFF_MAX_SIZE - pBuffer->currentSize)){
+		return BUFF_FULL;
+	}
+	
+	/* The copy is done in two parts when it wraps around the end of the array ...  */
+	firstPart = BUFF_MAX_SIZE - pBuffer->writeIndex;
+	if(firstPart > nbBytes){
+		firstPart = nbBytes;
+	}
+	
+	memcpy(&(pBuffer->array[pBuffer->writeIndex]), pBytes, firstPart);
+	memcpy(&(pBuffer->array[0]), pBytes + firstPart, nbBytes - firstPart);
+	
+	pBuffer->writeIndex = (pBuffer->writeIndex + nbBytes) % BUFF_MAX_SIZE;
+	pBuffer->currentSize = pBuffer->currentSize + nbBytes;
+	
+	return BUFF_OK;
+}
+
+
 BUFF_Status BUFF_Dequeue(BUFF_Buffer *pBuffer, uint8_t *pByte){
 	if(pBuffer == NULL){
 		return BUFF_ERR;
@@ -77,6 +107,69 @@ BUFF_Status BUFF_Dequeue(BUFF_Buffer *pBuffer, uint8_t *pByte){
 }
 
 
+BUFF_Status BUFF_DequeueBytes(BUFF_Buffer *pBuffer, uint8_t *pBytes, uint32_t nbBytes){
+	uint32_t firstPart;
+	
+	
+	if((pBuffer == NULL) || (pBytes == NULL)){
+		return BUFF_ERR;
+	}
+	
+	/* Either all the requested bytes are available or none is dequeued ...  */
+	if(nbBytes > pBuffer->currentSize){
+		return BUFF_EMPTY;
+	}
+	
+	/* The copy is done in two parts when it wraps around the end of the array ...  */
+	firstPart = BUFF_MAX_SIZE - pBuffer->readIndex;
+	if(firstPart > nbBytes){
+		firstPart = nbBytes;
+	}
+	
+	memcpy(pBytes, &(pBuffer->array[pBuffer->readIndex]), firstPart);
+	memcpy(pBytes + firstPart, &(pBuffer->array[0]), nbBytes - firstPart);
+	
+	pBuffer->readIndex = (pBuffer->readIndex + nbBytes) % BUFF_MAX_SIZE;
+	pBuffer->currentSize = pBuffer->currentSize - nbBytes;
+	
+	return BUFF_OK;
+}
+
+
+/* Gives back the nbBytes last dequeued bytes, they are still in the array as long as nothing has been enqueued since ...  */
+BUFF_Status BUFF_Rewind(BUFF_Buffer *pBuffer, uint32_t nbBytes){
+	if(pBuffer == NULL){
+		return BUFF_ERR;
+	}
+	
+	if(nbBytes > (BUFF_MAX_SIZE - pBuffer->currentSize)){
+		return BUFF_ERR;
+	}
+	
+	pBuffer->readIndex = (pBuffer->readIndex + BUFF_MAX_SIZE - nbBytes) % BUFF_MAX_SIZE;
+	pBuffer->currentSize = pBuffer->currentSize + nbBytes;
+	
+	return BUFF_OK;
+}
+
+
+/* Removes the nbBytes last enqueued bytes ...  */
+BUFF_Status BUFF_DropLast(BUFF_Buffer *pBuffer, uint32_t nbBytes){
+	if(pBuffer == NULL){
+		return BUFF_ERR;
+	}
+	
+	if(nbBytes > pBuffer->currentSize){
+		return BUFF_ERR;
+	}
+	
+	pBuffer->writeIndex = (pBuffer->writeIndex + BUFF_MAX_SIZE - nbBytes) % BUFF_MAX_SIZE;
+	pBuffer->currentSize = pBuffer->currentSize - nbBytes;
+	
+	return BUFF_OK;
+}
+
+
 BUFF_Status BUFF_GetCurrentSize(BUFF_Buffer *pBuffer, uint32_t *pCurrentSize){
 	if(pBuffer == NULL){
 		return BUFF_ERR;
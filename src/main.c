@@ -8,18 +8,78 @@
 
 
 
+/* Baudrate of the serial link with the computer when the bridge starts, it can be chosen at build time (make BOOT_COMPUTER_BAUDRATE=115200) ...  */
+#ifndef BOOT_COMPUTER_BAUDRATE
+#define BOOT_COMPUTER_BAUDRATE     BRIDGE2_DEFAULT_COMPUTER_BAUDRATE
+#endif
+
+/* End of the answers from the card, detected by silence unless a T=1 epilogue is chosen at build time (make CARD_T1_EDC=LRC) ...  */
+#ifndef CARD_FRAMING
+#define CARD_FRAMING               BRIDGE2_CARD_FRAMING_NONE
+#endif
+
+/* With COMPUTER_RX_DMA defined (make COMPUTER_RX_DMA=1), the bytes from the computer are received in a circular DMA buffer and handed to the bridge by spans, instead of one RXNE interrupt per byte ...  */
+#define COMPUTER_RX_DMA_BUFFER_SIZE     512
+
+/* With COMPUTER_TX_DMA defined (make COMPUTER_TX_DMA=1), the frames for the computer are serialised in a staging area shipped by a single DMA transfer, instead of one TXE interrupt per byte. The area holds a whole frame : header, largest payload, check and a chained ACK ...  */
+#define COMPUTER_TX_DMA_BUFFER_SIZE     (BUFF_MAX_SIZE + 16)
+
+/* With COMPUTER_RTS_CTS defined (make COMPUTER_RTS_CTS=1), the serial link with the computer uses RTS/CTS flow control. CTS is handled by the UART, RTS is driven by the bridge ...  */
+#define COMPUTER_RTS_PORT               GPIOA
+#define COMPUTER_RTS_PIN                GPIO_PIN_12
+
+/* With COMPUTER_RX_RING defined (make COMPUTER_RX_RING=1), the reception interrupt only stores the bytes in the bridge's ring. They are parsed by batches in a software triggered interrupt (the DMA2 Stream5 vector, unused without COMPUTER_RX_DMA) ...  */
+#define COMPUTER_RX_RING_BATCH_SIZE     32
+
+#if defined(COMPUTER_RX_RING) && defined(COMPUTER_RX_DMA)
+#error COMPUTER_RX_RING and COMPUTER_RX_DMA can not be used together, the DMA already delivers the bytes by spans.
+#endif
+
+
+
 
 UART_HandleTypeDef uartHandleStruct;
 TIM_HandleTypeDef timerHandleStruct;
 uint8_t globalBuff;
+volatile uint32_t globalFlagRxEnabled;
+
+#ifdef COMPUTER_RX_DMA
+DMA_HandleTypeDef dmaRxHandleStruct;
+uint8_t globalRxDmaBuff[COMPUTER_RX_DMA_BUFFER_SIZE];
+uint32_t globalRxDmaReadPos;
+#endif
+
+#ifdef COMPUTER_TX_DMA
+DMA_HandleTypeDef dmaTxHandleStruct;
+uint8_t globalTxDmaBuff[COMPUTER_TX_DMA_BUFFER_SIZE];
+volatile uint32_t globalFlagTxRequested;
+#endif
 
 
 void initUartHandle(UART_HandleTypeDef *uartHandleStruct);
 void initUartHardware(void);
+#ifdef COMPUTER_RTS_CTS
+void initUartFlowCtrlHardware(void);
+#endif
 
 void initTimerHandle(TIM_HandleTypeDef *pTimerHandle);
 void initTimerHardware(void);
 
+#ifdef COMPUTER_RX_DMA
+void initDmaRxHandle(DMA_HandleTypeDef *pDmaHandle);
+void initDmaRxHardware(void);
+#endif
+
+#ifdef COMPUTER_RX_RING
+void initRxRingHardware(void);
+#endif
+
+#ifdef COMPUTER_TX_DMA
+void initDmaTxHandle(DMA_HandleTypeDef *pDmaHandle);
+void initDmaTxHardware(void);
+void sendNextTxDmaSpan(void);
+#endif
+
 void ErrorHandler(void);
 
 
@@ -35,14 +95,42 @@ int main(void){
 	readerRv = READER_HAL_InitWithDefaults(&settings);
 	if(readerRv != READER_OK) ErrorHandler();
 	
+	/* SysTick keeps the highest priority, the reader library relies on HAL_GetTick() during the card exchanges. BRIDGE2_ProcessTick() only counts down and defers its work to TIM5 ...  */
 	HAL_NVIC_SetPriority(SysTick_IRQn, 0x00, 0U);
 	/* Initializing the computer-bridge communication ...  */
 	initUartHandle(&uartHandleStruct);
 	initUartHardware();
+#ifdef COMPUTER_RTS_CTS
+	initUartFlowCtrlHardware();
+#endif
 	
 	halRv = HAL_UART_Init(&uartHandleStruct);
 	if(halRv != HAL_OK) ErrorHandler();
 	
+#ifdef COMPUTER_RX_DMA
+	initDmaRxHandle(&dmaRxHandleStruct);
+	initDmaRxHardware();
+	
+	halRv = HAL_DMA_Init(&dmaRxHandleStruct);
+	if(halRv != HAL_OK) ErrorHandler();
+	
+	__HAL_LINKDMA(&uartHandleStruct, hdmarx, dmaRxHandleStruct);
+#endif
+	
+#ifdef COMPUTER_RX_RING
+	initRxRingHardware();
+#endif
+	
+#ifdef COMPUTER_TX_DMA
+	initDmaTxHandle(&dmaTxHandleStruct);
+	initDmaTxHardware();
+	
+	halRv = HAL_DMA_Init(&dmaTxHandleStruct);
+	if(halRv != HAL_OK) ErrorHandler();
+	
+	__HAL_LINKDMA(&uartHandleStruct, hdmatx, dmaTxHandleStruct);
+#endif
+	
 	/* Initiating timer ...  */
 	initTimerHandle(&timerHandleStruct);
 	initTimerHardware();
@@ -55,6 +143,32 @@ int main(void){
 	rv = BRIDGE2_Init(&settings);
 	if(rv != BRIDGE2_OK) ErrorHandler();
 	
+	rv = BRIDGE2_SetComputerBaudrate(BOOT_COMPUTER_BAUDRATE);
+	if(rv != BRIDGE2_OK) ErrorHandler();
+	
+	rv = BRIDGE2_SetCardFraming(CARD_FRAMING);
+	if(rv != BRIDGE2_OK) ErrorHandler();
+	
+#ifdef COMPUTER_RTS_CTS
+	rv = BRIDGE2_SetRtsFlowCtrl(1);
+	if(rv != BRIDGE2_OK) ErrorHandler();
+#endif
+	
+#ifdef CARD_CUT_THROUGH
+	rv = BRIDGE2_SetCutThrough(1);
+	if(rv != BRIDGE2_OK) ErrorHandler();
+#endif
+	
+#ifdef CARD_ANSWER_STREAMING
+	rv = BRIDGE2_SetAnswerStreaming(1);
+	if(rv != BRIDGE2_OK) ErrorHandler();
+#endif
+	
+#ifdef CARD_AUTO_PPS
+	rv = BRIDGE2_SetAutoPps(1);
+	if(rv != BRIDGE2_OK) ErrorHandler();
+#endif
+	
 	rv = BRIDGE2_Run();
 	if(rv != BRIDGE2_OK) ErrorHandler();
 	
@@ -67,6 +181,7 @@ int main(void){
 
 
 
+#ifndef COMPUTER_TX_DMA
 BRIDGE2_Status BRIDGE2_EnableTxeInterrupt_Callback(void){
 	HAL_UART_Transmit_IT_continuous(&uartHandleStruct, &globalBuff);
 	SET_BIT(uartHandleStruct.Instance->CR1, USART_CR1_TXEIE);
@@ -81,9 +196,61 @@ BRIDGE2_Status BRIDGE2_DisableTxeInterrupt_Callback(void){
 	
 	return BRIDGE2_OK;
 }
+#else
+/* It may be called while the state machine context is locked, the frame is staged later in the DMA interrupt (pended here) or at the end of the transfer in progress ...  */
+BRIDGE2_Status BRIDGE2_EnableTxeInterrupt_Callback(void){
+	globalFlagTxRequested = 1;
+	HAL_NVIC_SetPendingIRQ(DMA2_Stream7_IRQn);
+	
+	return BRIDGE2_OK;
+}
 
 
+/* Called by the state machine when it produced the last byte, the transfer in progress goes on ...  */
+BRIDGE2_Status BRIDGE2_DisableTxeInterrupt_Callback(void){
+	globalFlagTxRequested = 0;
+	
+	return BRIDGE2_OK;
+}
+
+
+/* Stages the next bytes to be sent (up to a whole frame) and ships them with one DMA transfer ...  */
+void sendNextTxDmaSpan(void){
+	BRIDGE2_Status rv;
+	HAL_StatusTypeDef halRv;
+	uint32_t nbBytes;
+	
+	
+	rv = BRIDGE2_ProcessTxeBytes(globalTxDmaBuff, COMPUTER_TX_DMA_BUFFER_SIZE, &nbBytes);
+	if(rv != BRIDGE2_OK) ErrorHandler();
+	
+	if(nbBytes == 0){
+		return;
+	}
+	
+	halRv = HAL_UART_Transmit_DMA(&uartHandleStruct, globalTxDmaBuff, (uint16_t)(nbBytes));
+	if(halRv != HAL_OK) ErrorHandler();
+}
+
+
+/* The last byte of the transfer has left the shift register, the end of block is reported to the bridge before staging the next frame ...  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart){
+	BRIDGE2_Status rv;
+	
+	
+	rv = BRIDGE2_ProcessTxComplete();
+	if(rv != BRIDGE2_OK) ErrorHandler();
+	
+	if(globalFlagTxRequested != 0){
+		sendNextTxDmaSpan();
+	}
+}
+#endif
+
+
+#ifndef COMPUTER_RX_DMA
 BRIDGE2_Status BRIDGE2_EnableRxneInterrupt_Callback(void){
+	globalFlagRxEnabled = 1;
 	HAL_UART_Receive_IT_continuous(&uartHandleStruct);
 		
 	return BRIDGE2_OK;
@@ -91,12 +258,165 @@ BRIDGE2_Status BRIDGE2_EnableRxneInterrupt_Callback(void){
 
 
 BRIDGE2_Status BRIDGE2_DisableRxneInterrupt_Callback(void){
+	globalFlagRxEnabled = 0;
+	HAL_UART_Abort_IT(&uartHandleStruct);
+	
+	return BRIDGE2_OK;
+}
+#else
+/* The DMA keeps on receiving, only the delivery of the spans to the bridge is masked. Once unmasked, the USART interrupt is pended to deliver the bytes received in the meantime ...  */
+BRIDGE2_Status BRIDGE2_EnableRxneInterrupt_Callback(void){
+	HAL_StatusTypeDef halRv;
+	
+	
+	globalFlagRxEnabled = 1;
+	
+	if(uartHandleStruct.RxState == HAL_UART_STATE_READY){
+		globalRxDmaReadPos = 0;
+		
+		halRv = HAL_UART_Receive_DMA_continuous(&uartHandleStruct, globalRxDmaBuff, COMPUTER_RX_DMA_BUFFER_SIZE);
+		if(halRv != HAL_OK) return BRIDGE2_ERR;
+	}
+	else{
+		SET_BIT(uartHandleStruct.Instance->CR1, USART_CR1_IDLEIE);
+		HAL_NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+		HAL_NVIC_SetPendingIRQ(USART1_IRQn);
+	}
+	
+	return BRIDGE2_OK;
+}
+
+
+BRIDGE2_Status BRIDGE2_DisableRxneInterrupt_Callback(void){
+	globalFlagRxEnabled = 0;
+	HAL_NVIC_DisableIRQ(DMA2_Stream5_IRQn);
+	CLEAR_BIT(uartHandleStruct.Instance->CR1, USART_CR1_IDLEIE);
+	
+	return BRIDGE2_OK;
+}
+
+
+/* Hands to the bridge the bytes written by the DMA since the previous call, in two spans when the circular buffer wrapped around ...  */
+void HAL_UART_RxEventCallback_continuous(UART_HandleTypeDef *huart){
+	BRIDGE2_Status rv;
+	uint32_t writePos;
+	
+	
+	writePos = (COMPUTER_RX_DMA_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart->hdmarx)) % COMPUTER_RX_DMA_BUFFER_SIZE;
+	
+	if(writePos < globalRxDmaReadPos){
+		rv = BRIDGE2_ProcessRxBytes(globalRxDmaBuff + globalRxDmaReadPos, COMPUTER_RX_DMA_BUFFER_SIZE - globalRxDmaReadPos);
+		if(rv != BRIDGE2_OK) ErrorHandler();
+		
+		globalRxDmaReadPos = 0;
+	}
+	
+	if(writePos > globalRxDmaReadPos){
+		rv = BRIDGE2_ProcessRxBytes(globalRxDmaBuff + globalRxDmaReadPos, writePos - globalRxDmaReadPos);
+		if(rv != BRIDGE2_OK) ErrorHandler();
+		
+		globalRxDmaReadPos = writePos;
+	}
+}
+#endif
+
+
+/* Reception errors cost the block being received, the reception is restarted if the error stopped it ...  */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart){
+	BRIDGE2_Status rv;
+	uint32_t errorFlags;
+	
+	
+	errorFlags = 0;
+	if((huart->ErrorCode & HAL_UART_ERROR_PE) != 0) errorFlags |= BRIDGE2_RX_ERR_PARITY;
+	if((huart->ErrorCode & HAL_UART_ERROR_FE) != 0) errorFlags |= BRIDGE2_RX_ERR_FRAMING;
+	if((huart->ErrorCode & HAL_UART_ERROR_NE) != 0) errorFlags |= BRIDGE2_RX_ERR_NOISE;
+	if((huart->ErrorCode & HAL_UART_ERROR_ORE) != 0) errorFlags |= BRIDGE2_RX_ERR_OVERRUN;
+	if(errorFlags == 0) errorFlags = BRIDGE2_RX_ERR_OTHER;
+	
+#ifdef COMPUTER_RX_RING
+	/* The bytes received before the error are parsed first, the error applies to the block they belong to ...  */
+	rv = BRIDGE2_ProcessRxRing(0);
+	if(rv != BRIDGE2_OK) ErrorHandler();
+#endif
+	
+	rv = BRIDGE2_ProcessRxError(errorFlags);
+	if(rv != BRIDGE2_OK) ErrorHandler();
+	
+#ifdef COMPUTER_RX_DMA
+	/* A DMA transfer error disables the stream ...  */
+	if((huart->RxState == HAL_UART_STATE_READY) || ((huart->hdmarx->Instance->CR & DMA_SxCR_EN) == 0)){
+		HAL_UART_AbortReceive_DMA_continuous(huart);
+		globalRxDmaReadPos = 0;
+		
+		if(HAL_UART_Receive_DMA_continuous(huart, globalRxDmaBuff, COMPUTER_RX_DMA_BUFFER_SIZE) != HAL_OK) ErrorHandler();
+		
+		if(globalFlagRxEnabled == 0){
+			BRIDGE2_DisableRxneInterrupt_Callback();
+		}
+	}
+#else
+	if((huart->RxState == HAL_UART_STATE_READY) && (globalFlagRxEnabled != 0)){
+		BRIDGE2_EnableRxneInterrupt_Callback();
+	}
+#endif
+	
+#ifdef COMPUTER_TX_DMA
+	/* A DMA transfer error ends the transmission, the state machine sends the block again on the ACK timeout ...  */
+	if((huart->gState == HAL_UART_STATE_READY) && (globalFlagTxRequested != 0)){
+		HAL_NVIC_SetPendingIRQ(DMA2_Stream7_IRQn);
+	}
+#endif
+}
+
+
+BRIDGE2_Status BRIDGE2_SetComputerBaudrate_Callback(uint32_t baudrate){
+	HAL_StatusTypeDef halRv;
+	uint32_t flagRxne;
+	
+	
+	flagRxne = (uartHandleStruct.RxState == HAL_UART_STATE_BUSY_RX);
+#ifdef COMPUTER_RX_DMA
+	HAL_UART_AbortReceive_DMA_continuous(&uartHandleStruct);
+#else
 	HAL_UART_Abort_IT(&uartHandleStruct);
+#endif
+	
+	/* Above PCLK2/16 the baudrate can only be reached with 8 times oversampling ...  */
+	uartHandleStruct.Init.BaudRate = baudrate;
+	if(baudrate > (HAL_RCC_GetPCLK2Freq() / 16)){
+		uartHandleStruct.Init.OverSampling = UART_OVERSAMPLING_8;
+	}
+	else{
+		uartHandleStruct.Init.OverSampling = UART_OVERSAMPLING_16;
+	}
+	
+	halRv = HAL_UART_Init(&uartHandleStruct);
+	if(halRv != HAL_OK) return BRIDGE2_ERR;
+	
+	if(flagRxne){
+		BRIDGE2_EnableRxneInterrupt_Callback();
+	}
 	
 	return BRIDGE2_OK;
 }
 
 
+#ifdef COMPUTER_RTS_CTS
+/* RTS is active low ...  */
+BRIDGE2_Status BRIDGE2_SetRts_Callback(uint32_t flagReady){
+	if(flagReady != 0){
+		HAL_GPIO_WritePin(COMPUTER_RTS_PORT, COMPUTER_RTS_PIN, GPIO_PIN_RESET);
+	}
+	else{
+		HAL_GPIO_WritePin(COMPUTER_RTS_PORT, COMPUTER_RTS_PIN, GPIO_PIN_SET);
+	}
+	
+	return BRIDGE2_OK;
+}
+#endif
+
+
 BRIDGE2_Status BRIDGE2_EnableTimerInterrupt_Callback(void){
 	HAL_StatusTypeDef halRv;
 	
@@ -107,6 +427,13 @@ BRIDGE2_Status BRIDGE2_EnableTimerInterrupt_Callback(void){
 	return BRIDGE2_OK;
 }
 
+/* The bridge processing is run right away by pending the timer interrupt, the timer period is only a safety net ...  */
+BRIDGE2_Status BRIDGE2_RequestProcessing_Callback(void){
+	HAL_NVIC_SetPendingIRQ(TIM5_IRQn);
+	
+	return BRIDGE2_OK;
+}
+
 BRIDGE2_Status BRIDGE2_DisableTimerInterrupt_Callback(void){
 	HAL_StatusTypeDef halRv;
 	
@@ -121,8 +448,24 @@ BRIDGE2_Status BRIDGE2_DisableTimerInterrupt_Callback(void){
 void HAL_UART_RxCpltCallback_continuous(UART_HandleTypeDef *huart, uint16_t data){
 	BRIDGE2_Status rv;
 	
+#ifdef COMPUTER_RX_RING
+	rv = BRIDGE2_PushRxByte((uint8_t)(data));
+	if(rv != BRIDGE2_OK) ErrorHandler();
+	
+	HAL_NVIC_SetPendingIRQ(DMA2_Stream5_IRQn);
+#else
 	rv = BRIDGE2_ProcessRxneInterrupt((uint8_t)(data));
 	if(rv != BRIDGE2_OK) ErrorHandler();
+#endif
+}
+
+
+
+void HAL_SYSTICK_Callback(void){
+	BRIDGE2_Status rv;
+	
+	rv = BRIDGE2_ProcessTick(1);
+	if(rv != BRIDGE2_OK) ErrorHandler();
 }
 
 
@@ -154,7 +497,11 @@ void initUartHandle(UART_HandleTypeDef *uartHandleStruct){
 	uartHandleStruct->Init.Parity = UART_PARITY_NONE;
 	uartHandleStruct->Init.StopBits = UART_STOPBITS_1;
 	uartHandleStruct->Init.WordLength = UART_WORDLENGTH_8B;
+#ifdef COMPUTER_RTS_CTS
+	uartHandleStruct->Init.HwFlowCtl = UART_HWCONTROL_CTS;
+#else
 	uartHandleStruct->Init.HwFlowCtl = UART_HWCONTROL_NONE;
+#endif
 }
 
 
@@ -193,6 +540,35 @@ void initUartHardware(void){
 }
 
 
+#ifdef COMPUTER_RTS_CTS
+void initUartFlowCtrlHardware(void){
+	GPIO_InitTypeDef gpioInitStruct;
+	
+	/* Initialisation pin CTS, the UART holds the transmission while the computer deasserts it */
+	gpioInitStruct.Pin = GPIO_PIN_11;
+	gpioInitStruct.Mode = GPIO_MODE_AF_PP;
+	gpioInitStruct.Pull = GPIO_PULLUP;
+	gpioInitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	gpioInitStruct.Alternate = GPIO_AF7_USART1;
+	
+	__HAL_RCC_GPIOA_CLK_ENABLE();
+	HAL_GPIO_Init(GPIOA, &gpioInitStruct);
+	
+	
+	/* Initialisation pin RTS, driven by the bridge (BRIDGE2_SetRts_Callback()) and not by the UART, it is deasserted until the flow control is enabled */
+	HAL_GPIO_WritePin(COMPUTER_RTS_PORT, COMPUTER_RTS_PIN, GPIO_PIN_SET);
+	
+	gpioInitStruct.Pin = COMPUTER_RTS_PIN;
+	gpioInitStruct.Mode = GPIO_MODE_OUTPUT_PP;
+	gpioInitStruct.Pull = GPIO_NOPULL;
+	gpioInitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+	gpioInitStruct.Alternate = 0;
+	
+	HAL_GPIO_Init(COMPUTER_RTS_PORT, &gpioInitStruct);
+}
+#endif
+
+
 void initTimerHardware(void){
 	__HAL_RCC_TIM5_CLK_ENABLE();
 	
@@ -210,15 +586,105 @@ void initTimerHandle(TIM_HandleTypeDef *pTimerHandle){
 }
 
 
+#ifdef COMPUTER_RX_DMA
+void initDmaRxHandle(DMA_HandleTypeDef *pDmaHandle){
+	pDmaHandle->Instance = DMA2_Stream5;
+	pDmaHandle->Init.Channel = DMA_CHANNEL_4;
+	pDmaHandle->Init.Direction = DMA_PERIPH_TO_MEMORY;
+	pDmaHandle->Init.PeriphInc = DMA_PINC_DISABLE;
+	pDmaHandle->Init.MemInc = DMA_MINC_ENABLE;
+	pDmaHandle->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	pDmaHandle->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	pDmaHandle->Init.Mode = DMA_CIRCULAR;
+	pDmaHandle->Init.Priority = DMA_PRIORITY_HIGH;
+	pDmaHandle->Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+}
+
+
+void initDmaRxHardware(void){
+	__HAL_RCC_DMA2_CLK_ENABLE();
+	
+	/* Same priority as the USART interrupt, both of them deliver the received spans ...  */
+	HAL_NVIC_SetPriority(DMA2_Stream5_IRQn, 0x0E, 0);
+	HAL_NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+}
+
+
+void DMA2_Stream5_IRQHandler(void){
+	HAL_DMA_IRQHandler(&dmaRxHandleStruct);
+}
+#endif
+
+
+#ifdef COMPUTER_RX_RING
+void initRxRingHardware(void){
+	/* Same priority as the USART interrupt : the parsing never runs concurrently with the transmission, but it preempts the exchanges with the card.  */
+	/* On a tie the USART interrupt (lower IRQ number) is served first, a new byte waits for one batch at most ...  */
+	HAL_NVIC_SetPriority(DMA2_Stream5_IRQn, 0x0E, 0);
+	HAL_NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+}
+
+
+void DMA2_Stream5_IRQHandler(void){
+	BRIDGE2_Status rv;
+	
+	
+	rv = BRIDGE2_ProcessRxRing(COMPUTER_RX_RING_BATCH_SIZE);
+	if((rv != BRIDGE2_OK) && (rv != BRIDGE2_NO)) ErrorHandler();
+	
+	/* Bytes are left in the ring, the next batch is parsed once the pending USART interrupts have been served ...  */
+	if(rv == BRIDGE2_NO){
+		HAL_NVIC_SetPendingIRQ(DMA2_Stream5_IRQn);
+	}
+}
+#endif
+
+
+#ifdef COMPUTER_TX_DMA
+void initDmaTxHandle(DMA_HandleTypeDef *pDmaHandle){
+	pDmaHandle->Instance = DMA2_Stream7;
+	pDmaHandle->Init.Channel = DMA_CHANNEL_4;
+	pDmaHandle->Init.Direction = DMA_MEMORY_TO_PERIPH;
+	pDmaHandle->Init.PeriphInc = DMA_PINC_DISABLE;
+	pDmaHandle->Init.MemInc = DMA_MINC_ENABLE;
+	pDmaHandle->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	pDmaHandle->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+	pDmaHandle->Init.Mode = DMA_NORMAL;
+	pDmaHandle->Init.Priority = DMA_PRIORITY_MEDIUM;
+	pDmaHandle->Init.FIFOMode = DMA_FIFOMODE_DISABLE;
+}
+
+
+void initDmaTxHardware(void){
+	__HAL_RCC_DMA2_CLK_ENABLE();
+	
+	/* Same priority as the USART interrupt, the frames are staged either here or on the transfer complete interrupt of the USART ...  */
+	HAL_NVIC_SetPriority(DMA2_Stream7_IRQn, 0x0E, 0);
+	HAL_NVIC_EnableIRQ(DMA2_Stream7_IRQn);
+}
+
+
+/* Also pended by BRIDGE2_EnableTxeInterrupt_Callback(), a new frame is staged if the transmitter is idle ...  */
+void DMA2_Stream7_IRQHandler(void){
+	HAL_DMA_IRQHandler(&dmaTxHandleStruct);
+	
+	if((globalFlagTxRequested != 0) && (uartHandleStruct.gState == HAL_UART_STATE_READY)){
+		sendNextTxDmaSpan();
+	}
+}
+#endif
+
+
+/* Entered on the timer period or when pended by BRIDGE2_RequestProcessing_Callback() (the update flag is then not set) ...  */
 void TIM5_IRQHandler(void) {
 	BRIDGE2_Status rv;
 	
 	if (__HAL_TIM_GET_FLAG(&timerHandleStruct, TIM_FLAG_UPDATE) == SET) {
 		__HAL_TIM_CLEAR_FLAG(&timerHandleStruct, TIM_FLAG_UPDATE);
-		
-		rv = BRIDGE2_ProcessTimerInterrupt();
-		if(rv != BRIDGE2_OK) ErrorHandler();
 	}
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	if(rv != BRIDGE2_OK) ErrorHandler();
 }
 
 
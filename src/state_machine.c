@@ -5,6 +5,8 @@
  */
 
 
+#include <string.h>
+
 #include "state_machine.h"
 #include "bytes_buffer.h"
 #include "semaphore.h"
@@ -18,7 +20,7 @@
 static SM_Status SM_InitRcv(SM_Handle *pHandle);
 
 static SM_Status SM_ApplyRcvState(SM_Handle *pHandle, uint8_t rcvdByte);
-static SM_Status SM_ApplyState_SM_RCVSTATE_INIT(SM_Handle *pHandle);
+static SM_Status SM_ApplyState_SM_RCVSTATE_INIT(SM_Handle *pHandle, uint8_t rcvdByte);
 static SM_Status SM_ApplyState_SM_RCVSTATE_TRANSMITTED_ACK(SM_Handle *pHandle, uint8_t rcvdByte);
 static SM_Status SM_ApplyState_SM_RCVSTATE_CTRL_BYTE(SM_Handle *pHandle, uint8_t rcvdByte);
 static SM_Status SM_ApplyState_SM_RCVSTATE_LEN_BYTE1(SM_Handle *pHandle, uint8_t rcvdByte);
@@ -28,6 +30,8 @@ static SM_Status SM_ApplyState_SM_RCVSTATE_DATA(SM_Handle *pHandle, uint8_t rcvd
 static SM_Status SM_ApplyState_SM_RCVSTATE_CHECK(SM_Handle *pHandle, uint8_t rcvdByte);
 static SM_Status SM_ApplyState_SM_RCVSTATE_ACK_CTRL_BYTE(SM_Handle *pHandle, uint8_t rcvdByte);
 static SM_Status SM_ApplyState_SM_RCVSTATE_ACK_CHECK(SM_Handle *pHandle, uint8_t rcvdByte);
+static SM_Status SM_ApplyState_SM_RCVSTATE_SEQ(SM_Handle *pHandle, uint8_t rcvdByte);
+static SM_Status SM_ApplyState_SM_RCVSTATE_CHECK_MSB(SM_Handle *pHandle, uint8_t rcvdByte);
 
 static SM_Status SM_ComputeNextRcvState(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState);
 static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_INIT(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState);
@@ -40,19 +44,39 @@ static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_DATA(SM_Handle *pHandle, ui
 static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_CHECK(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState);
 static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CTRL_BYTE(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState);
 static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CHECK(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState);
+static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_SEQ(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState);
+static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_CHECK_MSB(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState);
+static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CHECK_MSB(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState);
 
 static SM_Status SM_MoveToNextRcvState(SM_Handle *pHandle, SM_RcvState nextState);
+static SM_Status SM_ProcessRcvdByte(SM_Handle *pHandle, uint8_t rcvdByte);
+static SM_Status SM_ApplyDataBytes(SM_Handle *pHandle, const uint8_t *pRcvdBytes, uint32_t nbBytes);
 static SM_Status Apply_SM_ACK_BLOCK_Received(SM_Handle *pHandle);
 static SM_Status SM_EndBlockRcvProcess(SM_Handle *pHandle);
 static SM_Status SM_ReceiveBlockWithSameBuffer(SM_Handle *pHandle);
+static SM_Status SM_ReceiveBlockInto(SM_Handle *pHandle, BUFF_Buffer *pBuffer, SM_LinearBuffer *pLinearBuffer);
+static SM_Status SM_DropRcvdPayload(SM_Handle *pHandle);
+static SM_Status SM_CallRcvdBlockCallbacks(SM_Handle *pHandle, SM_CtrlBlockType type);
+static SM_Status SM_EndWindowedBlockRcv(SM_Handle *pHandle);
+static SM_Status Apply_SM_ACK_BLOCK_ReceivedCumulative(SM_Handle *pHandle, uint8_t ackSeq);
+static SM_Status Apply_SM_NACK_BLOCK_Received(SM_Handle *pHandle);
+static SM_Status SM_UpdateRcvCheck(SM_Handle *pHandle, SM_RcvState nextState, uint8_t rcvdByte);
+static SM_Status SM_IsRcvdCheckValid(SM_Handle *pHandle, uint8_t rcvdByte);
+static SM_Status SM_RejectRcvdBlock(SM_Handle *pHandle, SM_RcvState checkState);
+static SM_Status SM_SendNack(SM_Handle *pHandle);
+static SM_Status SM_DropRcvdBytes(SM_Handle *pHandle, uint32_t nbBytes);
+static SM_Status SM_DiscardPartialBlock(SM_Handle *pHandle);
+static SM_Status SM_UpdateFlowCtrl(SM_Handle *pHandle);
+static SM_Status SM_SetPauseRequested(SM_Handle *pHandle, uint32_t flagPauseRequested);
 
 
 
 /* Specific to transmission state machine private functions ...  */
 static SM_Status SM_InitSend(SM_Handle *pHandle);
+static SM_Status SM_StartBlockSend(SM_Handle *pHandle, BUFF_Buffer *pBuffer, SM_CtrlBlockType type, uint32_t flagStreamed, uint32_t nbDataToSend);
 
 static SM_Status SM_ApplySendState(SM_Handle *pHandle, uint8_t *pByteToSend);
-static SM_Status SM_ApplyState_SM_SENDSTATE_INIT(SM_Handle *pHandle);
+static SM_Status SM_ApplyState_SM_SENDSTATE_INIT(SM_Handle *pHandle, uint8_t *pByteToSend);
 static SM_Status SM_ApplyState_SM_SENDSTATE_RCVD_ACK(SM_Handle *pHandle, uint8_t *pByteToSend);
 static SM_Status SM_ApplyState_SM_SENDSTATE_CTRL_BYTE(SM_Handle *pHandle, uint8_t *pByteToSend);
 static SM_Status SM_ApplyState_SM_SENDSTATE_LEN_BYTE1(SM_Handle *pHandle, uint8_t *pByteToSend);
@@ -62,6 +86,8 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_DATA(SM_Handle *pHandle, uint8_t *pB
 static SM_Status SM_ApplyState_SM_SENDSTATE_CHECK(SM_Handle *pHandle, uint8_t *pByteToSend);
 static SM_Status SM_ApplyState_SM_SENDSTATE_ACK_CTRL_BYTE(SM_Handle *pHandle, uint8_t *pByteToSend);
 static SM_Status SM_ApplyState_SM_SENDSTATE_ACK_CHECK(SM_Handle *pHandle, uint8_t *pByteToSend);
+static SM_Status SM_ApplyState_SM_SENDSTATE_SEQ(SM_Handle *pHandle, uint8_t *pByteToSend);
+static SM_Status SM_ApplyState_SM_SENDSTATE_CHECK_MSB(SM_Handle *pHandle, uint8_t *pByteToSend);
 
 static SM_Status SM_ComputeNextSendState(SM_Handle *pHandle, SM_SendState *pNextState);
 static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_INIT(SM_Handle *pHandle, SM_SendState *pNextState);
@@ -74,14 +100,146 @@ static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_DATA(SM_Handle *pHandle, S
 static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_CHECK(SM_Handle *pHandle, SM_SendState *pNextState);
 static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CTRL_BYTE(SM_Handle *pHandle, SM_SendState *pNextState);
 static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CHECK(SM_Handle *pHandle, SM_SendState *pNextState);
+static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_SEQ(SM_Handle *pHandle, SM_SendState *pNextState);
+static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_CHECK_MSB(SM_Handle *pHandle, SM_SendState *pNextState);
+static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CHECK_MSB(SM_Handle *pHandle, SM_SendState *pNextState);
 
 static SM_Status SM_MoveToNextSendState(SM_Handle *pHandle, SM_SendState nextState);
 static SM_Status Apply_SM_ACK_BLOCK_Transmitted(SM_Handle *pHandle);
 static SM_Status SM_EndBlockSendProcess(SM_Handle *pHandle);
+static SM_Status SM_EndWindowedBlockSend(SM_Handle *pHandle);
+static SM_Status SM_RetransmitLastBlock(SM_Handle *pHandle);
+static SM_Status SM_UpdateSendCheck(SM_Handle *pHandle, uint8_t sentByte);
+static SM_Status SM_AbortBlockSend(SM_Handle *pHandle);
+static SM_Status SM_SendFlowCtrlBlock(SM_Handle *pHandle, SM_CtrlBlockType type);
+static SM_Status SM_SendPendingFlowCtrlBlock(SM_Handle *pHandle);
 
 
 /* General usage private functions ....  */
 static SM_Status SM_DoesThisBlockNeedAnAck(SM_CtrlBlockType type);
+static SM_Status SM_DoesThisBlockCarryASeq(SM_CtrlBlockType type);
+static SM_Status SM_DoesThisBlockCarryAPayload(SM_CtrlBlockType type);
+static SM_Status SM_IsWindowedMode(SM_Handle *pHandle);
+static SM_Status SM_IsSendStalled(SM_Handle *pHandle);
+static SM_Status SM_ResetWindow(SM_Handle *pHandle);
+static SM_RcvState SM_GetRcvCheckEntryState(SM_Handle *pHandle, SM_RcvState checkState);
+static SM_SendState SM_GetSendCheckEntryState(SM_Handle *pHandle, SM_SendState checkState);
+static void SM_InitCheck(SM_Handle *pHandle, uint16_t *pCheck);
+static void SM_UpdateCheck(SM_Handle *pHandle, uint16_t *pCheck, const uint8_t *pBytes, uint32_t nbBytes);
+static void SM_InitAckTimer(SM_Handle *pHandle);
+static void SM_StartAckTimer(SM_Handle *pHandle);
+static void SM_StopAckTimer(SM_Handle *pHandle);
+static void SM_UpdateAckTimeout(SM_Handle *pHandle, uint32_t rtt);
+static void SM_GetDueTimerEvents(SM_Handle *pHandle, uint32_t *pFlagAckTimeout, uint32_t *pFlagResume);
+static SM_Status SM_ProcessAckTimeout(SM_Handle *pHandle);
+
+
+/* Transition/action tables of both state machines, indexed by the current state ...  */
+
+/**
+ * \def SM_NB_RCVSTATES
+ * Number of states of the reception state machine (size of #SM_RcvStatesTable).
+ */
+#define SM_NB_RCVSTATES                      ((uint32_t)(13))
+
+/**
+ * \def SM_NB_SENDSTATES
+ * Number of states of the transmission state machine (size of #SM_SendStatesTable).
+ */
+#define SM_NB_SENDSTATES                     ((uint32_t)(13))
+
+
+/**
+ * \struct SM_RcvStateDesc
+ * Entry of the reception state machine table. For a given state, it gives the function computing the next state and the function applying the actions of the state.
+ */
+typedef struct SM_RcvStateDesc SM_RcvStateDesc;
+struct SM_RcvStateDesc{
+	SM_Status (*computeNext)(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState);    /*!< Computes the state we move to when a byte is received in this state.  */
+	SM_Status (*apply)(SM_Handle *pHandle, uint8_t rcvdByte);                                   /*!< Actions performed when entering this state.                          */
+};
+
+/**
+ * \struct SM_SendStateDesc
+ * Entry of the transmission state machine table. For a given state, it gives the function computing the next state and the function applying the actions of the state.
+ */
+typedef struct SM_SendStateDesc SM_SendStateDesc;
+struct SM_SendStateDesc{
+	SM_Status (*computeNext)(SM_Handle *pHandle, SM_SendState *pNextState);                     /*!< Computes the state we move to when a new byte has to be sent.        */
+	SM_Status (*apply)(SM_Handle *pHandle, uint8_t *pByteToSend);                               /*!< Actions performed when entering this state (gives the byte to send). */
+};
+
+
+static const SM_RcvStateDesc SM_RcvStatesTable[SM_NB_RCVSTATES] = {
+	[SM_RCVSTATE_INIT]            = {SM_ComputeNextStateFrom_SM_RCVSTATE_INIT,            SM_ApplyState_SM_RCVSTATE_INIT},
+	[SM_RCVSTATE_CTRL_BYTE]       = {SM_ComputeNextStateFrom_SM_RCVSTATE_CTRL_BYTE,       SM_ApplyState_SM_RCVSTATE_CTRL_BYTE},
+	[SM_RCVSTATE_LEN_BYTE1]       = {SM_ComputeNextStateFrom_SM_RCVSTATE_LEN_BYTE1,       SM_ApplyState_SM_RCVSTATE_LEN_BYTE1},
+	[SM_RCVSTATE_LEN_BYTE2]       = {SM_ComputeNextStateFrom_SM_RCVSTATE_LEN_BYTE2,       SM_ApplyState_SM_RCVSTATE_LEN_BYTE2},
+	[SM_RCVSTATE_LEN_BYTE3]       = {SM_ComputeNextStateFrom_SM_RCVSTATE_LEN_BYTE3,       SM_ApplyState_SM_RCVSTATE_LEN_BYTE3},
+	[SM_RCVSTATE_DATA]            = {SM_ComputeNextStateFrom_SM_RCVSTATE_DATA,            SM_ApplyState_SM_RCVSTATE_DATA},
+	[SM_RCVSTATE_TRANSMITTED_ACK] = {SM_ComputeNextStateFrom_SM_RCVSTATE_TRANSMITTED_ACK, SM_ApplyState_SM_RCVSTATE_TRANSMITTED_ACK},
+	[SM_RCVSTATE_ACK_CTRL_BYTE]   = {SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CTRL_BYTE,   SM_ApplyState_SM_RCVSTATE_ACK_CTRL_BYTE},
+	[SM_RCVSTATE_ACK_CHECK]       = {SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CHECK,       SM_ApplyState_SM_RCVSTATE_ACK_CHECK},
+	[SM_RCVSTATE_CHECK]           = {SM_ComputeNextStateFrom_SM_RCVSTATE_CHECK,           SM_ApplyState_SM_RCVSTATE_CHECK},
+	[SM_RCVSTATE_SEQ]             = {SM_ComputeNextStateFrom_SM_RCVSTATE_SEQ,             SM_ApplyState_SM_RCVSTATE_SEQ},
+	[SM_RCVSTATE_CHECK_MSB]       = {SM_ComputeNextStateFrom_SM_RCVSTATE_CHECK_MSB,       SM_ApplyState_SM_RCVSTATE_CHECK_MSB},
+	[SM_RCVSTATE_ACK_CHECK_MSB]   = {SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CHECK_MSB,   SM_ApplyState_SM_RCVSTATE_CHECK_MSB}
+};
+
+
+static const SM_SendStateDesc SM_SendStatesTable[SM_NB_SENDSTATES] = {
+	[SM_SENDSTATE_INIT]           = {SM_ComputeNextStateFrom_SM_SENDSTATE_INIT,           SM_ApplyState_SM_SENDSTATE_INIT},
+	[SM_SENDSTATE_CTRL_BYTE]      = {SM_ComputeNextStateFrom_SM_SENDSTATE_CTRL_BYTE,      SM_ApplyState_SM_SENDSTATE_CTRL_BYTE},
+	[SM_SENDSTATE_LEN_BYTE1]      = {SM_ComputeNextStateFrom_SM_SENDSTATE_LEN_BYTE1,      SM_ApplyState_SM_SENDSTATE_LEN_BYTE1},
+	[SM_SENDSTATE_LEN_BYTE2]      = {SM_ComputeNextStateFrom_SM_SENDSTATE_LEN_BYTE2,      SM_ApplyState_SM_SENDSTATE_LEN_BYTE2},
+	[SM_SENDSTATE_LEN_BYTE3]      = {SM_ComputeNextStateFrom_SM_SENDSTATE_LEN_BYTE3,      SM_ApplyState_SM_SENDSTATE_LEN_BYTE3},
+	[SM_SENDSTATE_DATA]           = {SM_ComputeNextStateFrom_SM_SENDSTATE_DATA,           SM_ApplyState_SM_SENDSTATE_DATA},
+	[SM_SENDSTATE_RCVD_ACK]       = {SM_ComputeNextStateFrom_SM_SENDSTATE_RCVD_ACK,       SM_ApplyState_SM_SENDSTATE_RCVD_ACK},
+	[SM_SENDSTATE_ACK_CTRL_BYTE]  = {SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CTRL_BYTE,  SM_ApplyState_SM_SENDSTATE_ACK_CTRL_BYTE},
+	[SM_SENDSTATE_ACK_CHECK]      = {SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CHECK,      SM_ApplyState_SM_SENDSTATE_ACK_CHECK},
+	[SM_SENDSTATE_CHECK]          = {SM_ComputeNextStateFrom_SM_SENDSTATE_CHECK,          SM_ApplyState_SM_SENDSTATE_CHECK},
+	[SM_SENDSTATE_SEQ]            = {SM_ComputeNextStateFrom_SM_SENDSTATE_SEQ,            SM_ApplyState_SM_SENDSTATE_SEQ},
+	[SM_SENDSTATE_CHECK_MSB]      = {SM_ComputeNextStateFrom_SM_SENDSTATE_CHECK_MSB,      SM_ApplyState_SM_SENDSTATE_CHECK_MSB},
+	[SM_SENDSTATE_ACK_CHECK_MSB]  = {SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CHECK_MSB,  SM_ApplyState_SM_SENDSTATE_CHECK_MSB}
+};
+
+
+/* CRC-16/CCITT lookup table (polynomial 0x1021), one entry per value of the most significant byte of the CRC xored with the incoming byte ...  */
+static const uint16_t SM_Crc16Table[256] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
 
 
 /* Public functions definitions ...  */
@@ -103,6 +261,334 @@ SM_Status SM_Init(SM_Handle *pHandle){
 	rv = SM_InitSend(pHandle);
 	if(rv != SM_OK) return SM_ERR;
 	
+	pHandle->windowSize = SM_DEFAULT_WINDOW_SIZE;
+	pHandle->checkType = SM_CHECK_NONE;
+	
+	SM_InitAckTimer(pHandle);
+	
+	rv = SM_ResetWindow(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_SetWindowSize(SM_Handle *pHandle, uint32_t windowSize)
+ * \brief Selects the number of blocks which can be in flight at the same time on the serial link.
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param windowSize is the new window size. It has to be between 1 and #SM_MAX_WINDOW_SIZE. A value of 1 selects the legacy stop-and-wait protocol.
+ * \return This function returns a SM_Status execution code. #SM_BUSY is returned if a reception or a transmission process is ongoing, the window size can not be changed in that case.
+ * 
+ * With a window size greater than 1, every block needing an ACK carries a sequence number byte right after its control byte, and ACK blocks carry the sequence number of the last acknowledged block (cumulative ACK).
+ * Up to windowSize blocks can then be sent before the first one is acknowledged.
+ * The sequence numbers of both directions are reset by this function.
+ */
+SM_Status SM_SetWindowSize(SM_Handle *pHandle, uint32_t windowSize){
+	SM_Status rv;
+	
+	
+	if((windowSize == 0) || (windowSize > SM_MAX_WINDOW_SIZE)){
+		return SM_ERR;
+	}
+	
+	if(((pHandle->rcvHandle.flagRcptOngoing) != 0) || ((pHandle->sendHandle.flagSendOngoing) != 0)){
+		return SM_BUSY;
+	}
+	
+	pHandle->windowSize = windowSize;
+	
+	rv = SM_ResetWindow(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_GetWindowSize(SM_Handle *pHandle, uint32_t *pWindowSize)
+ * \brief Gets the current window size (see #SM_SetWindowSize()).
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param *pWindowSize is a pointer on the place where to write the current window size.
+ * \return This function returns a SM_Status execution code.
+ */
+SM_Status SM_GetWindowSize(SM_Handle *pHandle, uint32_t *pWindowSize){
+	*pWindowSize = pHandle->windowSize;
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_SetCheckType(SM_Handle *pHandle, SM_CheckType checkType)
+ * \brief Selects the integrity check carried by the CHECK field of the blocks, in both directions.
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param checkType is the new check type. It has to be a member of the #SM_CheckType enum.
+ * \return This function returns a SM_Status execution code. #SM_BUSY is returned if a reception or a transmission process is ongoing, the check type can not be changed in that case.
+ * 
+ * With a check type other than #SM_CHECK_NONE, the check of every received block is verified.
+ * A corrupted block is dropped and answered with a NACK block, the computer is expected to send it again.
+ * When a NACK is received while waiting for the ACK of the last sent block, this block is sent again.
+ */
+SM_Status SM_SetCheckType(SM_Handle *pHandle, SM_CheckType checkType){
+	if(checkType > SM_CHECK_CRC16){
+		return SM_ERR;
+	}
+	
+	if(((pHandle->rcvHandle.flagRcptOngoing) != 0) || ((pHandle->sendHandle.flagSendOngoing) != 0)){
+		return SM_BUSY;
+	}
+	
+	pHandle->checkType = checkType;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_GetCheckType(SM_Handle *pHandle, SM_CheckType *pCheckType)
+ * \brief Gets the current check type (see #SM_SetCheckType()).
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param *pCheckType is a pointer on the place where to write the current check type.
+ * \return This function returns a SM_Status execution code.
+ */
+SM_Status SM_GetCheckType(SM_Handle *pHandle, SM_CheckType *pCheckType){
+	*pCheckType = pHandle->checkType;
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_ProcessTick(SM_Handle *pHandle, uint32_t nbElapsedMs)
+ * \brief Advances the time base of the state machine and handles the expiration of the ACK timer.
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param nbElapsedMs is the number of milliseconds elapsed since the previous call.
+ * \return This function returns a SM_Status execution code.
+ * 
+ * This function is the combination of #SM_AdvanceTime() and #SM_ProcessTimerEvents().
+ * It has to be called periodically from a context which does not preempt the UART interrupts, otherwise the time base and the processing have to be split between #SM_AdvanceTime() and #SM_ProcessTimerEvents().
+ */
+SM_Status SM_ProcessTick(SM_Handle *pHandle, uint32_t nbElapsedMs){
+	SM_Status rv;
+	
+	
+	rv = SM_AdvanceTime(pHandle, nbElapsedMs);
+	if(rv == SM_NO) return SM_OK;
+	if(rv != SM_OK) return SM_ERR;
+	
+	rv = SM_ProcessTimerEvents(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_AdvanceTime(SM_Handle *pHandle, uint32_t nbElapsedMs)
+ * \brief Advances the time base of the state machine and tells if a timer event is due.
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param nbElapsedMs is the number of milliseconds elapsed since the previous call.
+ * \return This function returns SM_OK when #SM_ProcessTimerEvents() has something to do, SM_NO otherwise.
+ * 
+ * This function has to be called periodically (typically from the SysTick interrupt), without it the ACK timer never expires and a paused reception never resumes (see #SM_PauseReception()).
+ * It only updates the time base and does not touch the contexts, so it can be called from an interrupt which preempts the UART interrupts.
+ */
+SM_Status SM_AdvanceTime(SM_Handle *pHandle, uint32_t nbElapsedMs){
+	uint32_t flagAckTimeout, flagResume;
+	
+	
+	pHandle->currentTime += nbElapsedMs;
+	
+	SM_GetDueTimerEvents(pHandle, &flagAckTimeout, &flagResume);
+	
+	if((flagAckTimeout == 0) && (flagResume == 0) && ((pHandle->sendHandle.flagFlowCtrlExpected) == 0)){
+		return SM_NO;
+	}
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_ProcessTimerEvents(SM_Handle *pHandle)
+ * \brief Handles the timer events which are due according to the time base (see #SM_AdvanceTime()).
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \return This function returns a SM_Status execution code.
+ * 
+ * When no ACK has been received for the last sent block within the retransmission timeout, the block is sent again (legacy mode) and the timeout is doubled.
+ * After #SM_MAX_NB_RETRIES attempts, the transmission is given up: the contexts are released and #SM_AckTimeoutCallback() is called.
+ * If one of the contexts is being accessed by another interrupt routine, the events are handled on the next call.
+ * This function sends bytes on the UART, it must not preempt the UART interrupts.
+ */
+SM_Status SM_ProcessTimerEvents(SM_Handle *pHandle){
+	SEM_Status mutexRv;
+	SM_Status rv;
+	uint32_t flagAckTimeout, flagResume;
+	
+	
+	SM_GetDueTimerEvents(pHandle, &flagAckTimeout, &flagResume);
+	
+	if((flagAckTimeout == 0) && (flagResume == 0) && ((pHandle->sendHandle.flagFlowCtrlExpected) == 0)){
+		return SM_OK;
+	}
+	
+	mutexRv = SEM_TryLock(&(pHandle->sendHandle.contextAccessMutex));
+	if((mutexRv != SEM_LOCKED) && (mutexRv != SEM_UNLOCKED)) return SM_ERR;
+	
+	if(mutexRv == SEM_LOCKED){
+		return SM_OK;
+	}
+	
+	mutexRv = SEM_TryLock(&(pHandle->rcvHandle.contextAccessMutex));
+	if((mutexRv != SEM_LOCKED) && (mutexRv != SEM_UNLOCKED)) return SM_ERR;
+	
+	if(mutexRv == SEM_LOCKED){
+		mutexRv = SEM_Release(&(pHandle->sendHandle.contextAccessMutex));
+		if(mutexRv != SEM_OK) return SM_ERR;
+		
+		return SM_OK;
+	}
+	
+	rv = SM_OK;
+	
+	if(flagAckTimeout != 0){
+		rv = SM_ProcessAckTimeout(pHandle);
+	}
+	
+	/* The computer stopped sending, the partial block is dropped (it is going to be sent again) and the computer is allowed to resume ...  */
+	if((rv == SM_OK) && (flagResume != 0)){
+		rv = SM_DiscardPartialBlock(pHandle);
+		
+		if(rv == SM_OK){
+			pHandle->rcvHandle.flagPaused = 0;
+			rv = SM_UpdateFlowCtrl(pHandle);
+		}
+	}
+	
+	if(rv == SM_OK){
+		rv = SM_SendPendingFlowCtrlBlock(pHandle);
+	}
+	
+	mutexRv = SEM_Release(&(pHandle->rcvHandle.contextAccessMutex));
+	if(mutexRv != SEM_OK) return SM_ERR;
+	
+	mutexRv = SEM_Release(&(pHandle->sendHandle.contextAccessMutex));
+	if(mutexRv != SEM_OK) return SM_ERR;
+	
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_GetAckTimeout(SM_Handle *pHandle, uint32_t *pTimeout)
+ * \brief Gets the current retransmission timeout (see #SM_ProcessTimerEvents()).
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param *pTimeout is a pointer on the place where to write the current timeout, in milliseconds.
+ * \return This function returns a SM_Status execution code.
+ */
+SM_Status SM_GetAckTimeout(SM_Handle *pHandle, uint32_t *pTimeout){
+	*pTimeout = pHandle->ackTimer.timeout;
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn __attribute__((weak)) SM_Status SM_AckTimeoutCallback(SM_Handle *pHandle)
+ * \brief Callback function when the transmission of a block has been given up because its ACK never came.
+ * \param *pHandle Is a pointer on a #SM_Handle struct containing the current communication context.
+ * \return This function has to return an #SM_Status error code to indicate if the function behaved as expected or not.
+ * 
+ * It is called from #SM_ProcessTimerEvents() with both contexts locked, it should only set flags for the application.
+ */
+__attribute__((weak)) SM_Status SM_AckTimeoutCallback(SM_Handle *pHandle){
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_PauseReception(SM_Handle *pHandle)
+ * \brief Asks the computer to stop sending blocks, by sending a BUSY block.
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \return This function returns a SM_Status execution code. #SM_BUSY if the reception context is being used, the call has to be made again later.
+ * 
+ * The flow control contract with the computer is the following :
+ * - On a BUSY block, the computer stops sending as soon as possible.
+ * - On a READY block, it resumes and sends again every block which has not been acknowledged yet, starting with the oldest one.
+ * 
+ * The bytes still on their way are processed normally. The state machine also sends a BUSY block by itself when it has to drop a received byte (see #SM_GetNbDroppedBytes()) or when there is no room for a block in windowed mode.
+ * The READY block is sent once none of these conditions holds anymore.
+ * If the transmission state machine is busy, the BUSY or READY block is sent at the end of the current block.
+ */
+SM_Status SM_PauseReception(SM_Handle *pHandle){
+	return SM_SetPauseRequested(pHandle, 1);
+}
+
+
+/**
+ * \fn SM_Status SM_ResumeReception(SM_Handle *pHandle)
+ * \brief Ends a pause requested with #SM_PauseReception().
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \return This function returns a SM_Status execution code. #SM_BUSY if the reception context is being used, the call has to be made again later.
+ */
+SM_Status SM_ResumeReception(SM_Handle *pHandle){
+	return SM_SetPauseRequested(pHandle, 0);
+}
+
+
+/**
+ * \fn SM_Status SM_GetNbDroppedBytes(SM_Handle *pHandle, uint32_t *pNbDroppedBytes)
+ * \brief Gets the number of received bytes dropped since #SM_Init().
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param *pNbDroppedBytes is a pointer on the place where to write the number of dropped bytes.
+ * \return This function returns a SM_Status execution code.
+ * 
+ * A byte is dropped when the reception context is already accessed by another interrupt routine, and afterwards until the computer has stopped sending (see #SM_PauseReception()).
+ */
+SM_Status SM_GetNbDroppedBytes(SM_Handle *pHandle, uint32_t *pNbDroppedBytes){
+	*pNbDroppedBytes = pHandle->rcvHandle.nbDroppedBytes;
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_DiscardRcvdBlock(SM_Handle *pHandle)
+ * \brief Drops the block being currently received and waits for a new control byte.
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \return This function returns a SM_Status execution code. #SM_BUSY if the reception context is already accessed by another interrupt routine, nothing has been done.
+ * 
+ * This function is used to resynchronize the reception on the next block after bytes which can not be part of a block have been received (#SM_EvolveStateOnByteReception() returned #SM_ERR), for example while the two ends of the serial link do not use the same baudrate yet.
+ * It does nothing if no reception process is ongoing.
+ */
+SM_Status SM_DiscardRcvdBlock(SM_Handle *pHandle){
+	SM_Status rv;
+	SEM_Status mutexRv;
+	
+	
+	mutexRv = SEM_TryLock(&(pHandle->rcvHandle.contextAccessMutex));
+	if((mutexRv != SEM_LOCKED) && (mutexRv != SEM_UNLOCKED)) return SM_ERR;
+	
+	if(mutexRv == SEM_LOCKED){
+		return SM_BUSY;
+	}
+	
+	rv = SM_DiscardPartialBlock(pHandle);
+	
+	mutexRv = SEM_Release(&(pHandle->rcvHandle.contextAccessMutex));
+	if(mutexRv != SEM_OK) return SM_ERR;
+	
+	if(rv != SM_OK) return SM_ERR;
+	
 	
 	return SM_OK;
 }
@@ -138,6 +624,14 @@ static SM_Status SM_InitRcv(SM_Handle *pHandle){
 	pRcvHandle->flagAckTransmitted = 0;
 	pRcvHandle->flagRcptOngoing = 0;
 	pRcvHandle->flagAckRcptOccurred = 0;
+	pRcvHandle->pLinearBuffer = NULL;
+	
+	pRcvHandle->flagPaused = 0;
+	pRcvHandle->flagPauseRequested = 0;
+	pRcvHandle->flagNoRoom = 0;
+	pRcvHandle->flagHostPaused = 0;
+	pRcvHandle->nbDroppedBytes = 0;
+	pRcvHandle->lastDropTime = 0;
 	
 	return SM_OK;
 }
@@ -172,6 +666,27 @@ static SM_Status SM_EndBlockRcvProcess(SM_Handle *pHandle){
 		if(rv != SM_OK) return SM_ERR;
 	}
 	
+	rv = SM_CallRcvdBlockCallbacks(pHandle, type);
+	if(rv != SM_OK) return SM_ERR;
+	
+	rv = SM_DisableRxneInterrupt_Callback(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	/* We start a new block reception if we are expecting an ACK ...  */
+	if((pHandle->rcvHandle.flagAckExpected) != 0){
+		rv = SM_ReceiveBlockWithSameBuffer(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+	}
+		
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_CallRcvdBlockCallbacks(SM_Handle *pHandle, SM_CtrlBlockType type){
+	SM_Status rv;
+	
+	
 	switch(type){
 		case SM_ACK_BLOCK:
 			break;
@@ -205,22 +720,53 @@ static SM_Status SM_EndBlockRcvProcess(SM_Handle *pHandle){
 			if(rv != SM_OK) return SM_ERR;
 			break;
 			
-		default:
-			return SM_ERR;
-	}
-	
-	rv = SM_BlockRecievedCallback(pHandle);
-	if(rv != SM_OK) return SM_ERR;
-	
-	rv = SM_DisableRxneInterrupt_Callback(pHandle);
-	if(rv != SM_OK) return SM_ERR;
-	
-	/* We start a new block reception if we are expecting an ACK ...  */
-	if((pHandle->rcvHandle.flagAckExpected) != 0){
-		rv = SM_ReceiveBlockWithSameBuffer(pHandle);
-		if(rv != SM_OK) return SM_ERR;
+		case SM_SEQUENCE_BLOCK:
+			rv = SM_CtrlBlockRecievedCallback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			
+			rv = SM_SEQUENCE_BLOCK_Callback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			break;
+			
+		case SM_HELLO_BLOCK:
+			rv = SM_CtrlBlockRecievedCallback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			
+			rv = SM_HELLO_BLOCK_Callback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			break;
+			
+		case SM_BAUD_BLOCK:
+			rv = SM_CtrlBlockRecievedCallback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			
+			rv = SM_BAUD_BLOCK_Callback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			break;
+			
+		case SM_TIMING_BLOCK:
+			rv = SM_CtrlBlockRecievedCallback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			
+			rv = SM_TIMING_BLOCK_Callback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			break;
+			
+		case SM_CLOCK_BLOCK:
+			rv = SM_CtrlBlockRecievedCallback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			
+			rv = SM_CLOCK_BLOCK_Callback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			break;
+			
+		default:
+			return SM_ERR;
 	}
-		
+	
+	rv = SM_BlockRecievedCallback(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
 	
 	return SM_OK;
 }
@@ -230,7 +776,7 @@ static SM_Status SM_ReceiveBlockWithSameBuffer(SM_Handle *pHandle){
 	SM_Status rv;
 	
 	
-	rv = SM_ReceiveBlock(pHandle, pHandle->rcvHandle.pBuffer);
+	rv = SM_ReceiveBlockInto(pHandle, pHandle->rcvHandle.pBuffer, pHandle->rcvHandle.pLinearBuffer);
 	if(rv != SM_OK) return rv;
 	
 	
@@ -246,6 +792,42 @@ static SM_Status SM_ReceiveBlockWithSameBuffer(SM_Handle *pHandle){
  * \param *pBuffer is a pointer on a #BUFF_Buffer structure that is gonne be used to store the received data bytes if we are receiving a data block.
  */
 SM_Status SM_ReceiveBlock(SM_Handle *pHandle, BUFF_Buffer *pBuffer){
+	
+	
+	return SM_ReceiveBlockInto(pHandle, pBuffer, NULL);
+}
+
+
+/**
+ * \fn SM_Status SM_ReceiveBlockLinear(SM_Handle *pHandle, SM_LinearBuffer *pLinearBuffer)
+ * \brief Same as #SM_ReceiveBlock() but the payload of a data block is written contiguously in a caller-provided array (stop-and-wait mode only).
+ * \return This function return a #SM_Status execution code. If #SM_OK, the reception process has started correctly. If #SM_BUSY, the reception process has not been started because another reception process is ongoing. Any other value indicates an error.
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param *pLinearBuffer is a pointer on a #SM_LinearBuffer structure describing the array receiving the payload. Once the block is received, the payload is in pLinearBuffer->pData[0] to pLinearBuffer->pData[pLinearBuffer->size - 1].
+ *
+ * A data block whose payload does not fit in the array is an error, as it is for a #BUFF_Buffer.
+ */
+SM_Status SM_ReceiveBlockLinear(SM_Handle *pHandle, SM_LinearBuffer *pLinearBuffer){
+	SM_Status rv;
+	
+	
+	if(pLinearBuffer == NULL) return SM_ERR;
+	if((pLinearBuffer->pData) == NULL) return SM_ERR;
+	
+	/* In windowed mode the payloads of several blocks are queued, this requires a circular buffer ...  */
+	if(SM_IsWindowedMode(pHandle) == SM_OK) return SM_ERR;
+	
+	rv = SM_ReceiveBlockInto(pHandle, NULL, pLinearBuffer);
+	if(rv != SM_OK) return rv;
+	
+	pLinearBuffer->size = 0;
+	
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_ReceiveBlockInto(SM_Handle *pHandle, BUFF_Buffer *pBuffer, SM_LinearBuffer *pLinearBuffer){
 	SM_RcvHandle *pRcvHandle;
 	SEM_Status mutexRv;
 	SM_Status rv;
@@ -256,8 +838,32 @@ SM_Status SM_ReceiveBlock(SM_Handle *pHandle, BUFF_Buffer *pBuffer){
 	mutexRv = SEM_TryLock(&(pRcvHandle->rcptProcessMutex));
 	if((mutexRv != SEM_UNLOCKED) && (mutexRv != SEM_LOCKED)) return SM_ERR;
 	
+	/* In windowed mode the reception is continuous. Asking again for the same buffer is not an error ...                                      */
+	/* A reception started without buffer (to collect the ACKs) is handed over to the caller if it is between two blocks ...  */
+	if((mutexRv == SEM_LOCKED) && (SM_IsWindowedMode(pHandle) == SM_OK)){
+		if((pRcvHandle->pBuffer) == pBuffer){
+			return SM_OK;
+		}
+		
+		if(((pRcvHandle->pBuffer) == NULL) && ((pRcvHandle->currentState) == SM_RCVSTATE_INIT)){
+			if(BUFF_Init(pBuffer) != BUFF_OK) return SM_ERR;
+			
+			pRcvHandle->pBuffer = pBuffer;
+			pRcvHandle->nbBlocksQueued = 0;
+			
+			return SM_OK;
+		}
+	}
+	
 	if(mutexRv == SEM_UNLOCKED){
+		/* In windowed mode the reception is continuous, the buffer receives the payloads of all the queued blocks ...  */
+		if((SM_IsWindowedMode(pHandle) == SM_OK) && (pBuffer != NULL)){
+			if(BUFF_Init(pBuffer) != BUFF_OK) return SM_ERR;
+			pRcvHandle->nbBlocksQueued = 0;
+		}
+		
 		pRcvHandle->pBuffer = pBuffer;
+		pRcvHandle->pLinearBuffer = pLinearBuffer;
 		pRcvHandle->currentState = SM_RCVSTATE_INIT;
 		pRcvHandle->currentBlockType = SM_UNKNOWN_BLOCK;
 		pRcvHandle->flagRcptOngoing = 1;
@@ -290,7 +896,6 @@ SM_Status SM_ReceiveBlock(SM_Handle *pHandle, BUFF_Buffer *pBuffer){
 SM_Status SM_EvolveStateOnByteReception(SM_Handle *pHandle, uint8_t rcvdByte){
 	SM_Status rv;
 	SEM_Status mutexRv;
-	SM_RcvState nextState;
 	
 	
 	if((pHandle->rcvHandle.flagRcptOngoing) == 0){
@@ -302,28 +907,199 @@ SM_Status SM_EvolveStateOnByteReception(SM_Handle *pHandle, uint8_t rcvdByte){
 	if((mutexRv != SEM_LOCKED) && (mutexRv != SEM_UNLOCKED)) return SM_ERR;
 	
 	if(mutexRv == SEM_UNLOCKED){
+		/* The computer has been asked to stop, the bytes still on their way are dropped ...  */
+		if((pHandle->rcvHandle.flagPaused) != 0){
+			rv = SM_DropRcvdBytes(pHandle, 1);
+			if(rv != SM_OK) return SM_ERR;
+			
+			mutexRv = SEM_Release(&(pHandle->rcvHandle.contextAccessMutex));
+			if(mutexRv != SEM_OK) return SM_ERR;
+			
+			return SM_BUSY;
+		}
+		
+		/* Fast path : a payload byte which is not the last one of the block, we stay in the DATA state ...  */
+		if(((pHandle->rcvHandle.currentState) == SM_RCVSTATE_DATA) && ((pHandle->rcvHandle.nbDataRcvd) < (pHandle->rcvHandle.nbDataExpected))){
+			rv = SM_ApplyState_SM_RCVSTATE_DATA(pHandle, rcvdByte);
+			if(rv != SM_OK) return SM_ERR;
+			
+			mutexRv = SEM_Release(&(pHandle->rcvHandle.contextAccessMutex));
+			if(mutexRv != SEM_OK) return SM_ERR;
+			
+			return SM_OK;
+		}
+		
 		/* If everything is okay we process normally the state ... */
-		rv = SM_ComputeNextRcvState(pHandle, rcvdByte, &nextState);
+		rv = SM_ProcessRcvdByte(pHandle, rcvdByte);
+		
+		/* The context is released even on an unexpected byte, so that the caller is able to recover (see #SM_DiscardRcvdBlock()) ...  */
+		mutexRv = SEM_Release(&(pHandle->rcvHandle.contextAccessMutex));
+		if(mutexRv != SEM_OK) return SM_ERR;
+		
+		if(rv != SM_OK) return SM_ERR;
+	}
+	else{
+		/* If the reception context is already locked by another interrupt routine, the byte is lost ...  */
+		/* We ask the computer to pause with a BUSY block, it will send the block again after the READY block ...  */
+		rv = SM_DropRcvdBytes(pHandle, 1);
 		if(rv != SM_OK) return SM_ERR;
 		
-		rv = SM_MoveToNextRcvState(pHandle, nextState);
+		return SM_BUSY;
+	}
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_EvolveStateOnBytesReception(SM_Handle *pHandle, const uint8_t *pRcvdBytes, uint32_t nbBytes)
+ * \brief Evolve the current state machine state when several bytes are received at once.
+ * \return This function returns a SM_Status execution code. #SM_BUSY if the reception context is already accessed by another interrupt routine or if the reception is paused (none of the bytes has been processed, they are dropped). #SM_ERR if the reception process ended before all the bytes were processed.
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param *pRcvdBytes is a pointer on the received bytes, in their reception order.
+ * \param nbBytes is the number of received bytes.
+ * 
+ * This function has the same effect as calling #SM_EvolveStateOnByteReception() for each byte, but the context is locked only once.
+ * While in the DATA state, the payload bytes are copied in the reception buffer in one go, the state machine only goes through the per-byte logic for the header and check bytes.
+ * This function is designed to be fed with bursts of bytes (DMA, idle line detection, FIFO ...).
+ */
+SM_Status SM_EvolveStateOnBytesReception(SM_Handle *pHandle, const uint8_t *pRcvdBytes, uint32_t nbBytes){
+	SM_RcvHandle *pRcvHandle;
+	SM_Status rv;
+	SEM_Status mutexRv;
+	uint32_t i, nbDataBytes;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	
+	if((pRcvHandle->flagRcptOngoing) == 0){
+		return SM_ERR;
+	}
+	
+	mutexRv = SEM_TryLock(&(pRcvHandle->contextAccessMutex));
+	if((mutexRv != SEM_LOCKED) && (mutexRv != SEM_UNLOCKED)) return SM_ERR;
+	
+	if(mutexRv == SEM_LOCKED){
+		rv = SM_DropRcvdBytes(pHandle, nbBytes);
 		if(rv != SM_OK) return SM_ERR;
 		
-		rv = SM_ApplyRcvState(pHandle, rcvdByte);
+		return SM_BUSY;
+	}
+	
+	if((pRcvHandle->flagPaused) != 0){
+		rv = SM_DropRcvdBytes(pHandle, nbBytes);
 		if(rv != SM_OK) return SM_ERR;
 		
-		mutexRv = SEM_Release(&(pHandle->rcvHandle.contextAccessMutex));
+		mutexRv = SEM_Release(&(pRcvHandle->contextAccessMutex));
 		if(mutexRv != SEM_OK) return SM_ERR;
-	}
-	/* TODO !!!!!!! */
-	else{
-		/* If the reception context is already locked by another interrupt routine ...  */
-		/* We enqueue a BUSY block in the data about to be sent to the computer ...     */
-		//rv = SM_SendControlBlock(pHandle, SM_BUSY_BLOCK);
-		//if(rv != SM_OK) return SM_ERR;
+		
 		return SM_BUSY;
 	}
 	
+	i = 0;
+	while(i < nbBytes){
+		/* The block ended the reception process, the remaining bytes can not be processed ...  */
+		if((pRcvHandle->flagRcptOngoing) == 0){
+			mutexRv = SEM_Release(&(pRcvHandle->contextAccessMutex));
+			if(mutexRv != SEM_OK) return SM_ERR;
+			
+			return SM_ERR;
+		}
+		
+		if(((pRcvHandle->currentState) == SM_RCVSTATE_DATA) && ((pRcvHandle->nbDataRcvd) < (pRcvHandle->nbDataExpected))){
+			/* We take all the payload bytes of the current block available in the span ...  */
+			nbDataBytes = pRcvHandle->nbDataExpected - pRcvHandle->nbDataRcvd;
+			if(nbDataBytes > (nbBytes - i)){
+				nbDataBytes = nbBytes - i;
+			}
+			
+			rv = SM_ApplyDataBytes(pHandle, pRcvdBytes + i, nbDataBytes);
+			if(rv != SM_OK){
+				mutexRv = SEM_Release(&(pRcvHandle->contextAccessMutex));
+				if(mutexRv != SEM_OK) return SM_ERR;
+				
+				return SM_ERR;
+			}
+			
+			i += nbDataBytes;
+		}
+		else{
+			rv = SM_ProcessRcvdByte(pHandle, pRcvdBytes[i]);
+			if(rv != SM_OK){
+				mutexRv = SEM_Release(&(pRcvHandle->contextAccessMutex));
+				if(mutexRv != SEM_OK) return SM_ERR;
+				
+				return SM_ERR;
+			}
+			
+			i++;
+		}
+	}
+	
+	mutexRv = SEM_Release(&(pRcvHandle->contextAccessMutex));
+	if(mutexRv != SEM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_ProcessRcvdByte(SM_Handle *pHandle, uint8_t rcvdByte){
+	SM_Status rv;
+	SM_RcvState nextState;
+	
+	
+	rv = SM_ComputeNextRcvState(pHandle, rcvdByte, &nextState);
+	if(rv != SM_OK) return SM_ERR;
+	
+	/* The header bytes are accumulated in the check value, which is verified when entering the CHECK states ...  */
+	if((pHandle->checkType) != SM_CHECK_NONE){
+		rv = SM_UpdateRcvCheck(pHandle, nextState, rcvdByte);
+		if((rv != SM_OK) && (rv != SM_NO)) return SM_ERR;
+		
+		if(rv == SM_NO){
+			rv = SM_RejectRcvdBlock(pHandle, nextState);
+			if(rv != SM_OK) return SM_ERR;
+			
+			return SM_OK;
+		}
+	}
+	
+	rv = SM_MoveToNextRcvState(pHandle, nextState);
+	if(rv != SM_OK) return SM_ERR;
+	
+	rv = SM_ApplyRcvState(pHandle, rcvdByte);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/* Equivalent to nbBytes calls of SM_ApplyState_SM_RCVSTATE_DATA(), the caller makes sure that all the bytes belong to the payload of the current block ...  */
+static SM_Status SM_ApplyDataBytes(SM_Handle *pHandle, const uint8_t *pRcvdBytes, uint32_t nbBytes){
+	SM_RcvHandle *pRcvHandle;
+	BUFF_Status buffRv;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	
+	if(((pRcvHandle->flagDiscardBlock) == 0) && ((pRcvHandle->pLinearBuffer) != NULL)){
+		memcpy(pRcvHandle->pLinearBuffer->pData + pRcvHandle->pLinearBuffer->size, pRcvdBytes, nbBytes);
+		pRcvHandle->pLinearBuffer->size += nbBytes;
+	}
+	else if((pRcvHandle->flagDiscardBlock) == 0){
+		buffRv = BUFF_EnqueueBytes(pRcvHandle->pBuffer, pRcvdBytes, nbBytes);
+		if(buffRv != BUFF_OK) return SM_ERR;
+	}
+	
+	pRcvHandle->nbDataRcvd += nbBytes;
+	
+	if((pHandle->checkType) != SM_CHECK_NONE){
+		SM_UpdateCheck(pHandle, &(pRcvHandle->checkValue), pRcvdBytes, nbBytes);
+	}
+	
+	
 	return SM_OK;
 }
 
@@ -351,11 +1127,15 @@ SM_Status SM_IsDataAvail(SM_Handle *pHandle){
 		return SM_NO;
 	}
 	
-	/* If we are handling something different than a data block, there is no data avail ...  */
-	if((pRcvHandle->currentBlockType) != SM_DATA_BLOCK){
+	/* If we are handling a block without payload, there is no data avail ...  */
+	if(SM_DoesThisBlockCarryAPayload(pRcvHandle->currentBlockType) != SM_OK){
 		return SM_NO;
 	}
 	
+	if((pRcvHandle->pLinearBuffer) != NULL){
+		return ((pRcvHandle->pLinearBuffer->size) != 0) ? SM_OK : SM_NO;
+	}
+	
 	rv = SM_GetRcptBufferPtr(pHandle, &pBuffer);
 	if(rv != SM_OK) return SM_ERR;
 	
@@ -386,6 +1166,82 @@ SM_Status SM_IsAllDataRecieved(SM_Handle *pHandle){
 }
 
 
+/**
+ * \fn SM_Status SM_GetRcvdBlockInfo(SM_Handle *pHandle, SM_CtrlBlockType *pType, uint32_t *pSize)
+ * \brief Gets the type and the payload size of the oldest received block which has not been released yet (windowed mode only).
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param *pType is a pointer on the place where to write the type of the block.
+ * \param *pSize is a pointer on the place where to write the number of payload bytes of the block.
+ * \return This function returns a SM_Status execution code. #SM_OK if a block is available, #SM_NO if no received block is waiting. Any other value indicates an error.
+ * 
+ * The payload bytes of the block are the next *pSize bytes of the reception buffer (see #SM_GetRcptBufferPtr()).
+ */
+SM_Status SM_GetRcvdBlockInfo(SM_Handle *pHandle, SM_CtrlBlockType *pType, uint32_t *pSize){
+	SM_RcvHandle *pRcvHandle;
+	SM_RcvdBlockInfo *pInfo;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	
+	if((pRcvHandle->nbBlocksQueued) == 0){
+		return SM_NO;
+	}
+	
+	pInfo = &(pRcvHandle->blocksQueue[pRcvHandle->blocksQueueHead]);
+	*pType = pInfo->type;
+	*pSize = pInfo->size;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_ReleaseRcvdBlock(SM_Handle *pHandle)
+ * \brief Releases the oldest received block and acknowledges it to the computer (windowed mode only).
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \return This function returns a SM_Status execution code. #SM_NO if there is no block to release.
+ * 
+ * The caller has to dequeue the payload bytes of the block from the reception buffer before calling this function.
+ * The ACK is cumulative : if the transmission state machine is busy, the ACK is sent at the end of the current block and covers all the blocks released in the meantime.
+ */
+SM_Status SM_ReleaseRcvdBlock(SM_Handle *pHandle){
+	SM_RcvHandle *pRcvHandle;
+	SM_SendHandle *pSendHandle;
+	SM_Status rv;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	pSendHandle = &(pHandle->sendHandle);
+	
+	if((pRcvHandle->nbBlocksQueued) == 0){
+		return SM_NO;
+	}
+	
+	pSendHandle->ackSeqToSend = pRcvHandle->blocksQueue[pRcvHandle->blocksQueueHead].seq;
+	
+	pRcvHandle->blocksQueueHead = (pRcvHandle->blocksQueueHead + 1) % SM_MAX_WINDOW_SIZE;
+	pRcvHandle->nbBlocksQueued--;
+	
+	/* The ACK is sent now or as soon as the transmission state machine is free ...  */
+	pSendHandle->flagAckExpected = 1;
+	
+	rv = SM_SendBlock(pHandle, NULL, SM_ACK_BLOCK);
+	if((rv != SM_OK) && (rv != SM_BUSY)) return SM_ERR;
+	
+	/* There is room again for the blocks we had to discard ...  */
+	if((pRcvHandle->flagNoRoom) != 0){
+		pRcvHandle->flagNoRoom = 0;
+		
+		rv = SM_UpdateFlowCtrl(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	
+	
+	return SM_OK;
+}
+
+
 /**
  * \fn SM_Status SM_GetRcptBufferPtr(SM_Handle *pHandle, BUFF_Buffer **ppBuffer)
  * \brief This function is used to get the pointer on the #BUFF_Buffer struct containing the received data bytes (in the case of a data block reception).
@@ -427,6 +1283,36 @@ SM_Status SM_GetSendBufferPtr(SM_Handle *pHandle, BUFF_Buffer **ppBuffer){
 }
 
 
+/**
+ * \fn SM_Status SM_IsReadyToSend(SM_Handle *pHandle, SM_CtrlBlockType type)
+ * \brief Tests if a call to #SM_SendBlock() with the given block type would start a transmission right now.
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \param type is the type of the block we would like to send.
+ * \return This function returns #SM_OK if the transmission state machine is free and (in windowed mode) the window is not full. #SM_NO otherwise.
+ */
+SM_Status SM_IsReadyToSend(SM_Handle *pHandle, SM_CtrlBlockType type){
+	SM_SendHandle *pSendHandle;
+	SEM_Status mutexRv;
+	
+	
+	pSendHandle = &(pHandle->sendHandle);
+	
+	mutexRv = SEM_IsLocked(&(pSendHandle->sendProcessMutex));
+	if(mutexRv == SEM_LOCKED){
+		return SM_NO;
+	}
+	
+	if((SM_IsWindowedMode(pHandle) == SM_OK) && (SM_DoesThisBlockNeedAnAck(type) == SM_OK)){
+		if((pSendHandle->nbBlocksInFlight) >= (pHandle->windowSize)){
+			return SM_NO;
+		}
+	}
+	
+	
+	return SM_OK;
+}
+
+
 __attribute__((weak)) SM_Status SM_EnableRxneInterrupt_Callback(SM_Handle *pHandle){
 	return SM_OK;
 }
@@ -462,7 +1348,21 @@ __attribute__((weak)) SM_Status SM_DataBlockRecievedCallback(SM_Handle *pHandle)
 }
 
 
-__attribute__((weak)) SM_Status SM_COLD_RST_BLOCK_Callback(SM_Handle *pHandle){
+/**
+ * \fn __attribute__((weak)) SM_Status SM_DataPayloadStartedCallback(SM_Handle *pHandle)
+ * \brief Called once the header of a data block with a payload has been received, before its first payload byte.
+ * \param *pHandle is a pointer on a SM_Handle struct containing the current context of the state machine.
+ * \return This function returns a SM_Status execution code.
+ * 
+ * The payload bytes are then stored in the reception buffer as they arrive, the size of the payload is in pHandle->rcvHandle.nbDataExpected.
+ * The block is not checked yet, it may still be dropped (wrong check, lost bytes), in which case the stored bytes are removed from the reception buffer.
+ */
+__attribute__((weak)) SM_Status SM_DataPayloadStartedCallback(SM_Handle *pHandle){
+	return SM_OK;
+}
+
+
+__attribute__((weak)) SM_Status SM_COLD_RST_BLOCK_Callback(SM_Handle *pHandle){
 	return SM_OK;
 }
 
@@ -476,6 +1376,31 @@ __attribute__((weak)) SM_Status SM_UNKNOWN_BLOCK_Callback(SM_Handle *pHandle){
 	return SM_OK;
 }
 
+
+__attribute__((weak)) SM_Status SM_SEQUENCE_BLOCK_Callback(SM_Handle *pHandle){
+	return SM_OK;
+}
+
+
+__attribute__((weak)) SM_Status SM_HELLO_BLOCK_Callback(SM_Handle *pHandle){
+	return SM_OK;
+}
+
+
+__attribute__((weak)) SM_Status SM_BAUD_BLOCK_Callback(SM_Handle *pHandle){
+	return SM_OK;
+}
+
+
+__attribute__((weak)) SM_Status SM_TIMING_BLOCK_Callback(SM_Handle *pHandle){
+	return SM_OK;
+}
+
+
+__attribute__((weak)) SM_Status SM_CLOCK_BLOCK_Callback(SM_Handle *pHandle){
+	return SM_OK;
+}
+
 __attribute__((weak)) SM_Status SM_ACK_BLOCK_ReceivedCallback(SM_Handle *pHandle){
 	return SM_OK;
 }
@@ -497,6 +1422,8 @@ static SM_Status Apply_SM_ACK_BLOCK_Received(SM_Handle *pHandle){
 	/* We clear the ACK expected flag ...  */
 	pHandle->rcvHandle.flagAckExpected = 0;
 	
+	SM_StopAckTimer(pHandle);
+	
 	/* We notify the transmission state machine that that ACK has been received ...  */
 	pHandle->sendHandle.flagAckReceived = 1;
 	
@@ -509,6 +1436,24 @@ static SM_Status Apply_SM_ACK_BLOCK_Received(SM_Handle *pHandle){
 }
 
 
+/* Called when a NACK is received in legacy mode, the computer asks for the last sent block again ...  */
+static SM_Status Apply_SM_NACK_BLOCK_Received(SM_Handle *pHandle){
+	SM_Status rv;
+	
+	
+	/* A NACK is meaningful only while we are waiting for the ACK of the last sent block ...  */
+	if((pHandle->rcvHandle.flagAckExpected) == 0){
+		return SM_OK;
+	}
+	
+	rv = SM_RetransmitLastBlock(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
 /**
  * \fn static SM_Status SM_InitSend(SM_Handle *pHandle)
  * \brief Initializes the transmission state machine context.
@@ -537,6 +1482,11 @@ static SM_Status SM_InitSend(SM_Handle *pHandle){
 	pSendHandle->flagAckExpected = 0;
 	pSendHandle->flagAckReceived = 0;
 	pSendHandle->flagSendOngoing = 0;
+	pSendHandle->flagNackExpected = 0;
+	pSendHandle->flagFlowCtrlExpected = 0;
+	pSendHandle->flagStreamed = 0;
+	pSendHandle->nbDataSent = 0;
+	pSendHandle->flagStalled = 0;
 	
 	return SM_OK;
 }
@@ -576,6 +1526,14 @@ static SM_Status SM_EndBlockSendProcess(SM_Handle *pHandle){
 		rv = SM_SendBlock(pHandle, NULL, SM_ACK_BLOCK);
 		if(rv != SM_OK) return SM_ERR;
 	}
+	else if((pHandle->sendHandle.flagNackExpected) != 0){
+		rv = SM_SendBlock(pHandle, NULL, SM_NACK_BLOCK);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	else{
+		rv = SM_SendPendingFlowCtrlBlock(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+	}
 	
 		
 	return SM_OK;
@@ -617,8 +1575,95 @@ static SM_Status Apply_SM_ACK_BLOCK_Transmitted(SM_Handle *pHandle){
  * 
  * This function gather the data to be sent and initiates the transmission state machine.
  * While the data is not completely sent and ACKed by the computer, it is not possible to initiate a new transaction. If this happen, this function will exit and return #SM_BUSY code.
+ * In windowed mode (see #SM_SetWindowSize()), a new transaction can start as soon as the previous block is sent, #SM_BUSY is returned when the window is full of unacknowledged blocks.
  */
 SM_Status SM_SendBlock(SM_Handle *pHandle, BUFF_Buffer *pBuffer, SM_CtrlBlockType type){
+	return SM_StartBlockSend(pHandle, pBuffer, type, 0, 0);
+}
+
+
+/**
+ * \fn SM_Status SM_SendBlockStreamed(SM_Handle *pHandle, BUFF_Buffer *pBuffer, SM_CtrlBlockType type, uint32_t nbDataToSend)
+ * \brief Starts the transmission of a block whose payload is not completely available yet.
+ * \param *pHandle is a pointer on a #SM_Handle struct containing the current communication context.
+ * \param *pBuffer is a pointer on the #BUFF_Buffer struct in which the payload bytes are going to be pushed with #SM_StreamBytes(). It may already contain the first payload bytes.
+ * \param type Is the type of block to be sent. It has to be a block carrying a payload.
+ * \param nbDataToSend Is the total payload size announced in the LEN bytes of the block.
+ * \return This function returns an #SM_Status error code. Same meaning as for #SM_SendBlock().
+ * 
+ * The header and the payload bytes already in the buffer are sent right away. The transmission then stalls until more bytes are pushed with #SM_StreamBytes(), the check bytes are sent once nbDataToSend bytes went out.
+ * The caller has to push exactly nbDataToSend bytes in total, the block can not be shortened once its header is sent.
+ */
+SM_Status SM_SendBlockStreamed(SM_Handle *pHandle, BUFF_Buffer *pBuffer, SM_CtrlBlockType type, uint32_t nbDataToSend){
+	if(pBuffer == NULL) return SM_ERR;
+	
+	if(SM_DoesThisBlockCarryAPayload(type) != SM_OK){
+		return SM_ERR;
+	}
+	
+	return SM_StartBlockSend(pHandle, pBuffer, type, 1, nbDataToSend);
+}
+
+
+/**
+ * \fn SM_Status SM_StreamBytes(SM_Handle *pHandle, const uint8_t *pBytes, uint32_t nbBytes)
+ * \brief Pushes payload bytes of the block started with #SM_SendBlockStreamed().
+ * \param *pHandle is a pointer on a #SM_Handle struct containing the current communication context.
+ * \param *pBytes is a pointer on the bytes to be appended to the payload.
+ * \param nbBytes is the number of bytes to be appended.
+ * \return This function returns an #SM_Status error code. #SM_ERR if no streamed block is being sent or if the bytes would exceed the announced payload size.
+ * 
+ * The transmission is resumed if it was waiting for these bytes.
+ */
+SM_Status SM_StreamBytes(SM_Handle *pHandle, const uint8_t *pBytes, uint32_t nbBytes){
+	SM_SendHandle *pSendHandle;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	uint32_t currentSize;
+	
+	
+	pSendHandle = &(pHandle->sendHandle);
+	
+	if(((pSendHandle->flagSendOngoing) == 0) || ((pSendHandle->flagStreamed) == 0)){
+		return SM_ERR;
+	}
+	
+	if(nbBytes == 0){
+		return SM_OK;
+	}
+	
+	if(nbBytes > (pSendHandle->nbDataToSend)){
+		return SM_ERR;
+	}
+	
+	/* The sending buffer is shared with the TXE interrupt, it is masked while the bytes are pushed ...  */
+	/* The exact bound depends on what the interrupt has sent already, it is checked once masked ...  */
+	rv = SM_DisableTxeInterrupt_Callback(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	buffRv = BUFF_GetCurrentSize(pSendHandle->pBuffer, &currentSize);
+	if((buffRv != BUFF_OK) || (((pSendHandle->nbDataSent) + currentSize + nbBytes) > (pSendHandle->nbDataToSend))){
+		rv = SM_EnableTxeInterrupt_Callback(pHandle);
+		return SM_ERR;
+	}
+	
+	buffRv = BUFF_EnqueueBytes(pSendHandle->pBuffer, pBytes, nbBytes);
+	if(buffRv != BUFF_OK){
+		rv = SM_EnableTxeInterrupt_Callback(pHandle);
+		return SM_ERR;
+	}
+	
+	pSendHandle->flagStalled = 0;
+	
+	rv = SM_EnableTxeInterrupt_Callback(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_StartBlockSend(SM_Handle *pHandle, BUFF_Buffer *pBuffer, SM_CtrlBlockType type, uint32_t flagStreamed, uint32_t nbDataToSend){
 	SEM_Status mutexRv;
 	SM_Status rv;
 	SM_SendHandle *pSendHandle;
@@ -627,15 +1672,30 @@ SM_Status SM_SendBlock(SM_Handle *pHandle, BUFF_Buffer *pBuffer, SM_CtrlBlockTyp
 	
 	pSendHandle = &(pHandle->sendHandle);
 	
+	/* In windowed mode, we do not start a new block needing an ACK if the window is full ...  */
+	if((SM_IsWindowedMode(pHandle) == SM_OK) && (SM_DoesThisBlockNeedAnAck(type) == SM_OK)){
+		if((pSendHandle->nbBlocksInFlight) >= (pHandle->windowSize)){
+			return SM_BUSY;
+		}
+	}
+	
 	mutexRv = SEM_TryLock(&(pSendHandle->sendProcessMutex));
 	if((mutexRv != SEM_LOCKED) && (mutexRv != SEM_UNLOCKED)) return SM_ERR;
 	
 	
 	if(mutexRv == SEM_UNLOCKED){
+		/* A new block needing an ACK gets a fresh retry budget ...  */
+		if(((pHandle->ackTimer.flagArmed) == 0) && (SM_DoesThisBlockNeedAnAck(type) == SM_OK)){
+			pHandle->ackTimer.nbRetries = 0;
+			pHandle->ackTimer.flagRetransmitted = 0;
+		}
+		
 		pSendHandle->flagEmpty = 0;
 		pSendHandle->flagSendOngoing = 1;
 		pSendHandle->pBuffer = pBuffer;
 		pSendHandle->currentBlockType = type;
+		pSendHandle->flagStreamed = flagStreamed;
+		pSendHandle->nbDataToSend = nbDataToSend;
 		pSendHandle->currentState = SM_SENDSTATE_INIT;
 		
 		rv = SM_ApplySendState(pHandle, &dummy);
@@ -690,42 +1750,175 @@ __attribute__((weak)) SM_Status SM_ACK_BLOCK_TransmittedCallback(SM_Handle *pHan
  * This function can typically be called in the TX Empty interrupt routine.
  */
 SM_Status SM_EvolveStateOnByteTransmission(SM_Handle *pHandle, uint8_t *pByteToSend){
+	SM_Status rv;
+	uint32_t nbBytes;
+	
+	
+	rv = SM_EvolveStateOnBytesTransmission(pHandle, pByteToSend, 1, &nbBytes);
+	if(rv != SM_OK) return rv;
+	
+	/* A streamed block waiting for its next payload byte has nothing to send for now ...  */
+	if((nbBytes == 0) && ((pHandle->sendHandle.flagStalled) != 0)){
+		return SM_EMPTY;
+	}
+	
+	if(nbBytes != 1) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_EvolveStateOnBytesTransmission(SM_Handle *pHandle, uint8_t *pBytesToSend, uint32_t maxNbBytes, uint32_t *pNbBytes)
+ * \param *pHandle Is a pointer on a #SM_Handle struct containing the current communication context.
+ * \param *pBytesToSend is a pointer on the place where to put the next bytes to be sent. It has to be at least maxNbBytes long.
+ * \param maxNbBytes is the maximum number of bytes the caller is ready to send.
+ * \param *pNbBytes is a pointer on an uint32_t value. It is filled with the number of bytes actually written in pBytesToSend.
+ * \return This function returns an #SM_Status error code to indicate if the function behaved as expected or not. #SM_BUSY if the transmission context is already accessed by another interrupt routine (nothing has been produced).
+ * 
+ * This function has the same effect as calling #SM_EvolveStateOnByteTransmission() up to maxNbBytes times, but the context is locked only once.
+ * It stops before maxNbBytes when the current transmission process has nothing more to send (the TXE interrupt callback is disabled as in the per-byte function).
+ * The payload bytes are copied from the sending buffer in one go. It is designed for transmitters able to send a whole span at once (DMA, FIFO ...).
+ */
+SM_Status SM_EvolveStateOnBytesTransmission(SM_Handle *pHandle, uint8_t *pBytesToSend, uint32_t maxNbBytes, uint32_t *pNbBytes){
+	SM_SendHandle *pSendHandle;
 	SM_Status rv;
 	SEM_Status mutexRv;
+	BUFF_Status buffRv;
 	SM_SendState nextState;
+	uint32_t i, nbDataBytes, flagTimerArmed;
 	
 	
-	if((pHandle->sendHandle.flagSendOngoing) == 0){
+	pSendHandle = &(pHandle->sendHandle);
+	*pNbBytes = 0;
+	
+	if((pSendHandle->flagSendOngoing) == 0){
 		return SM_ERR;
-	}	
+	}
 	
-	mutexRv = SEM_TryLock(&(pHandle->sendHandle.contextAccessMutex));
+	mutexRv = SEM_TryLock(&(pSendHandle->contextAccessMutex));
 	if((mutexRv != SEM_LOCKED) && (mutexRv != SEM_UNLOCKED)) return SM_ERR;
 	
-	if(mutexRv == SEM_UNLOCKED){
-		rv = SM_ComputeNextSendState(pHandle, &nextState);
-		if(rv != SM_OK) return SM_ERR;
-		
-		rv = SM_MoveToNextSendState(pHandle, nextState);
-		if(rv != SM_OK) return SM_ERR;
-		
-		rv = SM_ApplySendState(pHandle, pByteToSend);
-		if(rv != SM_OK) return SM_ERR;
-		
-		if((pHandle->sendHandle.flagEmpty) != 0){
-			rv = SM_DisableTxeInterrupt_Callback(pHandle);    /*  It means that we have just sent the last byte of this transmission process. There is nothing more to be sent. */
+	if(mutexRv == SEM_LOCKED){
+		return SM_BUSY;
+	}
+	
+	flagTimerArmed = pHandle->ackTimer.flagArmed;
+	
+	/* The first step is always performed (it is also used to notify the reception of an ACK), the next ones only while there are bytes left to send ...  */
+	i = 0;
+	while(i < maxNbBytes){
+		/* Fast path : in the DATA state the payload bytes available in the sending buffer are copied at once ...  */
+		if(((pSendHandle->currentState) == SM_SENDSTATE_DATA) && ((pSendHandle->pBuffer->currentSize) != 0)){
+			nbDataBytes = pSendHandle->pBuffer->currentSize;
+			if(nbDataBytes > ((pSendHandle->nbDataToSend) - (pSendHandle->nbDataSent))){
+				nbDataBytes = (pSendHandle->nbDataToSend) - (pSendHandle->nbDataSent);
+			}
+			if(nbDataBytes > (maxNbBytes - i)){
+				nbDataBytes = maxNbBytes - i;
+			}
+			
+			if(nbDataBytes == 1){
+				buffRv = BUFF_Dequeue(pSendHandle->pBuffer, pBytesToSend + i);
+			}
+			else{
+				buffRv = BUFF_DequeueBytes(pSendHandle->pBuffer, pBytesToSend + i, nbDataBytes);
+			}
+			if(buffRv != BUFF_OK) return SM_ERR;
+			
+			if((pHandle->checkType) != SM_CHECK_NONE){
+				SM_UpdateCheck(pHandle, &(pSendHandle->checkValue), pBytesToSend + i, nbDataBytes);
+			}
+			
+			pSendHandle->nbDataSent += nbDataBytes;
+			i += nbDataBytes;
+		}
+		else if(SM_IsSendStalled(pHandle) == SM_OK){
+			/* The next payload byte of a streamed block has not been pushed yet, we wait for #SM_StreamBytes() ...  */
+			pSendHandle->flagStalled = 1;
+			break;
+		}
+		else{
+			rv = SM_ComputeNextSendState(pHandle, &nextState);
+			if(rv != SM_OK) return SM_ERR;
+			
+			rv = SM_MoveToNextSendState(pHandle, nextState);
+			if(rv != SM_OK) return SM_ERR;
+			
+			rv = SM_ApplySendState(pHandle, pBytesToSend + i);
 			if(rv != SM_OK) return SM_ERR;
+			
+			if((pHandle->checkType) != SM_CHECK_NONE){
+				rv = SM_UpdateSendCheck(pHandle, pBytesToSend[i]);
+				if(rv != SM_OK) return SM_ERR;
+			}
+			
+			i++;
 		}
 		
-		mutexRv = SEM_Release(&(pHandle->sendHandle.contextAccessMutex));
-		if(mutexRv != SEM_OK) return SM_ERR;
+		if(((pSendHandle->flagEmpty) != 0) || ((pSendHandle->flagSendOngoing) == 0)){
+			break;
+		}
 	}
-	else{
-		/* TODO : Sending busy block to computer ?? ...  */
-		/* TODO : Udpating Doxygen header ...  */
+	
+	*pNbBytes = i;
+	
+	/* The ACK timer has been armed by these bytes, it is armed again once they are out if the caller reports it ...  */
+	if((flagTimerArmed == 0) && ((pHandle->ackTimer.flagArmed) != 0)){
+		pHandle->ackTimer.flagStartOnCompletion = 1;
+	}
+	
+	/* The interrupt is not entered again for nothing when the pushed bytes have all been sent ...  */
+	if(SM_IsSendStalled(pHandle) == SM_OK){
+		pSendHandle->flagStalled = 1;
+	}
+	
+	if((pSendHandle->flagEmpty) != 0){
+		rv = SM_DisableTxeInterrupt_Callback(pHandle);    /*  It means that we have just sent the last byte of this transmission process. There is nothing more to be sent. */
+		if(rv != SM_OK) return SM_ERR;
+	}
+	else if((pSendHandle->flagStalled) != 0){
+		rv = SM_DisableTxeInterrupt_Callback(pHandle);    /*  Enabled again by SM_StreamBytes() */
+		if(rv != SM_OK) return SM_ERR;
+	}
+	
+	mutexRv = SEM_Release(&(pSendHandle->contextAccessMutex));
+	if(mutexRv != SEM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn SM_Status SM_EvolveStateOnTransmissionComplete(SM_Handle *pHandle)
+ * \param *pHandle Is a pointer on a #SM_Handle struct containing the current communication context.
+ * \return This function returns an #SM_Status error code to indicate if the function behaved as expected or not. #SM_BUSY if the transmission context is already accessed by another interrupt routine (nothing has been done).
+ * 
+ * This public function is designed to be called by the transmitters working on whole spans (see #SM_EvolveStateOnBytesTransmission()) once the last produced bytes have actually been sent, typically in the transfer complete interrupt of a DMA.
+ * The block is over for the state machine as soon as its last byte is produced. If it expects an ACK, the ACK timer is armed again from now so that the time spent by the frame in the transmitter is not counted in the round trip time.
+ */
+SM_Status SM_EvolveStateOnTransmissionComplete(SM_Handle *pHandle){
+	SEM_Status mutexRv;
+	
+	
+	mutexRv = SEM_TryLock(&(pHandle->sendHandle.contextAccessMutex));
+	if((mutexRv != SEM_LOCKED) && (mutexRv != SEM_UNLOCKED)) return SM_ERR;
+	
+	if(mutexRv == SEM_LOCKED){
 		return SM_BUSY;
 	}
 	
+	if(((pHandle->ackTimer.flagArmed) != 0) && ((pHandle->ackTimer.flagStartOnCompletion) != 0)){
+		pHandle->ackTimer.startTime = pHandle->currentTime;
+	}
+	
+	pHandle->ackTimer.flagStartOnCompletion = 0;
+	
+	mutexRv = SEM_Release(&(pHandle->sendHandle.contextAccessMutex));
+	if(mutexRv != SEM_OK) return SM_ERR;
+	
 	
 	return SM_OK;
 }
@@ -745,67 +1938,19 @@ static SM_Status SM_MoveToNextRcvState(SM_Handle *pHandle, SM_RcvState nextState
 
 
 static SM_Status SM_ComputeNextRcvState(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState){
-	SM_RcvHandle *pRcvHandle;
+	SM_RcvState currentState;
 	SM_Status rv;
 	
 	
-	pRcvHandle = &(pHandle->rcvHandle);
+	currentState = pHandle->rcvHandle.currentState;
 	
-	switch(pRcvHandle->currentState){
-		case SM_RCVSTATE_INIT:
-			rv = SM_ComputeNextStateFrom_SM_RCVSTATE_INIT(pHandle, rcvdByte, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_RCVSTATE_CTRL_BYTE:
-			rv = SM_ComputeNextStateFrom_SM_RCVSTATE_CTRL_BYTE(pHandle, rcvdByte, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_RCVSTATE_LEN_BYTE1:
-			rv = SM_ComputeNextStateFrom_SM_RCVSTATE_LEN_BYTE1(pHandle, rcvdByte, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_RCVSTATE_LEN_BYTE2:
-			rv = SM_ComputeNextStateFrom_SM_RCVSTATE_LEN_BYTE2(pHandle, rcvdByte, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_RCVSTATE_LEN_BYTE3:
-			rv = SM_ComputeNextStateFrom_SM_RCVSTATE_LEN_BYTE3(pHandle, rcvdByte, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_RCVSTATE_DATA:
-			rv = SM_ComputeNextStateFrom_SM_RCVSTATE_DATA(pHandle, rcvdByte, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_RCVSTATE_CHECK:
-			rv = SM_ComputeNextStateFrom_SM_RCVSTATE_CHECK(pHandle, rcvdByte, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_RCVSTATE_TRANSMITTED_ACK:
-			rv = SM_ComputeNextStateFrom_SM_RCVSTATE_TRANSMITTED_ACK(pHandle, rcvdByte, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_RCVSTATE_ACK_CTRL_BYTE:
-			rv = SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CTRL_BYTE(pHandle, rcvdByte, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_RCVSTATE_ACK_CHECK:
-			rv = SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CHECK(pHandle, rcvdByte, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		default:
-			return SM_ERR;
+	if(currentState >= SM_NB_RCVSTATES){
+		return SM_ERR;
 	}
 	
+	rv = SM_RcvStatesTable[currentState].computeNext(pHandle, rcvdByte, pNextState);
+	if(rv != SM_OK) return SM_ERR;
+	
 	
 	return SM_OK;
 }
@@ -833,25 +1978,72 @@ static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_CTRL_BYTE(SM_Handle *pHandl
 	pRcvHandle = &(pHandle->rcvHandle);
 	type = pRcvHandle->currentBlockType;
 	
+	/* In windowed mode, the sequence number comes right after the control byte ...  */
+	if((SM_IsWindowedMode(pHandle) == SM_OK) && (SM_DoesThisBlockCarryASeq(type) == SM_OK)){
+		*pNextState = SM_RCVSTATE_SEQ;
+		return SM_OK;
+	}
+	
 	switch(type){
 		case SM_DATA_BLOCK:
 			*pNextState = SM_RCVSTATE_LEN_BYTE1;
 			break;
 		
-		case SM_COLD_RST_BLOCK:
-			*pNextState = SM_RCVSTATE_CHECK;
+		case SM_SEQUENCE_BLOCK:
+			*pNextState = SM_RCVSTATE_LEN_BYTE1;
 			break;
-			
-		case SM_ACK_BLOCK:
-			*pNextState = SM_RCVSTATE_CHECK;
+		
+		case SM_HELLO_BLOCK:
+			*pNextState = SM_RCVSTATE_LEN_BYTE1;
 			break;
 		
-		case SM_UNKNOWN_BLOCK:
-			return SM_ERR;
+		case SM_BAUD_BLOCK:
+			*pNextState = SM_RCVSTATE_LEN_BYTE1;
 			break;
 		
-		default:
-			return SM_ERR;
+		case SM_TIMING_BLOCK:
+			*pNextState = SM_RCVSTATE_LEN_BYTE1;
+			break;
+		
+		case SM_CLOCK_BLOCK:
+			*pNextState = SM_RCVSTATE_LEN_BYTE1;
+			break;
+		
+		case SM_COLD_RST_BLOCK:
+			*pNextState = SM_GetRcvCheckEntryState(pHandle, SM_RCVSTATE_CHECK);
+			break;
+		
+		case SM_WARM_RST_BLOCK:
+			*pNextState = SM_GetRcvCheckEntryState(pHandle, SM_RCVSTATE_CHECK);
+			break;
+			
+		case SM_ACK_BLOCK:
+			*pNextState = SM_GetRcvCheckEntryState(pHandle, SM_RCVSTATE_CHECK);
+			break;
+			
+		case SM_NACK_BLOCK:
+			*pNextState = SM_GetRcvCheckEntryState(pHandle, SM_RCVSTATE_CHECK);
+			break;
+		
+		case SM_UNKNOWN_BLOCK:
+			return SM_ERR;
+			break;
+		
+		default:
+			return SM_ERR;
+	}
+	
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_SEQ(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState){
+	if(SM_DoesThisBlockCarryAPayload(pHandle->rcvHandle.currentBlockType) == SM_OK){
+		*pNextState = SM_RCVSTATE_LEN_BYTE1;
+	}
+	else{
+		*pNextState = SM_GetRcvCheckEntryState(pHandle, SM_RCVSTATE_CHECK);
 	}
 	
 	
@@ -875,7 +2067,7 @@ static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_LEN_BYTE2(SM_Handle *pHandl
 
 static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_LEN_BYTE3(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState){
 	if((pHandle->rcvHandle.nbDataExpected) == 0){
-		*pNextState = SM_RCVSTATE_CHECK;
+		*pNextState = SM_GetRcvCheckEntryState(pHandle, SM_RCVSTATE_CHECK);
 	}
 	else{
 		*pNextState = SM_RCVSTATE_DATA;
@@ -896,7 +2088,7 @@ static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_DATA(SM_Handle *pHandle, ui
 		*pNextState = SM_RCVSTATE_DATA;
 	}
 	else if((pRcvHandle->nbDataRcvd) == (pRcvHandle->nbDataExpected)){
-		*pNextState = SM_RCVSTATE_CHECK;
+		*pNextState = SM_GetRcvCheckEntryState(pHandle, SM_RCVSTATE_CHECK);
 	}
 	else{
 		return SM_ERR;
@@ -938,6 +2130,20 @@ static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_CHECK(SM_Handle *pHandle, u
 
 
 static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CTRL_BYTE(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState){
+	*pNextState = SM_GetRcvCheckEntryState(pHandle, SM_RCVSTATE_ACK_CHECK);
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_CHECK_MSB(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState){
+	*pNextState = SM_RCVSTATE_CHECK;
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CHECK_MSB(SM_Handle *pHandle, uint8_t rcvdByte, SM_RcvState *pNextState){
 	*pNextState = SM_RCVSTATE_ACK_CHECK;
 	
 	return SM_OK;
@@ -970,73 +2176,25 @@ static SM_Status SM_ComputeNextStateFrom_SM_RCVSTATE_ACK_CHECK(SM_Handle *pHandl
 
 
 static SM_Status SM_ApplyRcvState(SM_Handle *pHandle, uint8_t rcvdByte){
-	SM_RcvHandle *pRcvHandle;
+	SM_RcvState currentState;
 	SM_Status rv;
 	
 	
-	pRcvHandle = &(pHandle->rcvHandle);
+	currentState = pHandle->rcvHandle.currentState;
 	
-	switch(pRcvHandle->currentState){
-		case SM_RCVSTATE_INIT:
-			rv = SM_ApplyState_SM_RCVSTATE_INIT(pHandle);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_RCVSTATE_CTRL_BYTE:
-			rv = SM_ApplyState_SM_RCVSTATE_CTRL_BYTE(pHandle, rcvdByte);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_RCVSTATE_LEN_BYTE1:
-			rv = SM_ApplyState_SM_RCVSTATE_LEN_BYTE1(pHandle, rcvdByte);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_RCVSTATE_LEN_BYTE2:
-			rv = SM_ApplyState_SM_RCVSTATE_LEN_BYTE2(pHandle, rcvdByte);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_RCVSTATE_LEN_BYTE3:
-			rv = SM_ApplyState_SM_RCVSTATE_LEN_BYTE3(pHandle, rcvdByte);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_RCVSTATE_DATA:
-			rv = SM_ApplyState_SM_RCVSTATE_DATA(pHandle, rcvdByte);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_RCVSTATE_CHECK:
-			rv = SM_ApplyState_SM_RCVSTATE_CHECK(pHandle, rcvdByte);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_RCVSTATE_TRANSMITTED_ACK:
-			rv = SM_ApplyState_SM_RCVSTATE_TRANSMITTED_ACK(pHandle, rcvdByte);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_RCVSTATE_ACK_CTRL_BYTE:
-			rv = SM_ApplyState_SM_RCVSTATE_ACK_CTRL_BYTE(pHandle, rcvdByte);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_RCVSTATE_ACK_CHECK:
-			rv = SM_ApplyState_SM_RCVSTATE_ACK_CHECK(pHandle, rcvdByte);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		default:
-			return SM_ERR;
+	if(currentState >= SM_NB_RCVSTATES){
+		return SM_ERR;
 	}
 	
+	rv = SM_RcvStatesTable[currentState].apply(pHandle, rcvdByte);
+	if(rv != SM_OK) return SM_ERR;
+	
 	
 	return SM_OK;
 }
 
 
-static SM_Status SM_ApplyState_SM_RCVSTATE_INIT(SM_Handle *pHandle){
+static SM_Status SM_ApplyState_SM_RCVSTATE_INIT(SM_Handle *pHandle, uint8_t rcvdByte){
 	SM_RcvHandle *pRcvHandle;
 	
 	
@@ -1045,6 +2203,7 @@ static SM_Status SM_ApplyState_SM_RCVSTATE_INIT(SM_Handle *pHandle){
 	pRcvHandle->nbDataRcvd = 0;
 	pRcvHandle->nbDataExpected = 0;
 	pRcvHandle->currentBlockType = SM_UNKNOWN_BLOCK;
+	pRcvHandle->flagDiscardBlock = 0;
 	
 	
 	return SM_OK;
@@ -1078,8 +2237,9 @@ static SM_Status SM_ApplyState_SM_RCVSTATE_CTRL_BYTE(SM_Handle *pHandle, uint8_t
 	pRcvHandle->currentBlockType = rcvdByte;
 	
 	
-	/* If we are about to receive a data block, we prepare the buffer ...  */
-	if(rcvdByte == SM_DATA_BLOCK){
+	/* If we are about to receive a data block, we prepare the buffer ...                                   */
+	/* In windowed mode the payloads of the queued blocks are appended, the buffer is prepared by #SM_ReceiveBlock().  */
+	if((SM_DoesThisBlockCarryAPayload(rcvdByte) == SM_OK) && (SM_IsWindowedMode(pHandle) != SM_OK)){
 		/* We get a pointer on the reception buffer ...  */
 		rv = SM_GetRcptBufferPtr(pHandle, &pBuffer);
 		if(rv != SM_OK) return SM_ERR;
@@ -1089,6 +2249,48 @@ static SM_Status SM_ApplyState_SM_RCVSTATE_CTRL_BYTE(SM_Handle *pHandle, uint8_t
 			buffRv = BUFF_Init(pBuffer);
 			if(buffRv != BUFF_OK) return SM_ERR;
 		}
+		
+		if((pRcvHandle->pLinearBuffer) != NULL){
+			pRcvHandle->pLinearBuffer->size = 0;
+		}
+	}
+	
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_ApplyState_SM_RCVSTATE_SEQ(SM_Handle *pHandle, uint8_t rcvdByte){
+	SM_RcvHandle *pRcvHandle;
+	SM_Status rv;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	pRcvHandle->currentSeq = rcvdByte;
+	
+	/* An ACK (or a NACK) carries the sequence number of the last acknowledged (or expected) block, there is nothing to check here ...  */
+	if(((pRcvHandle->currentBlockType) == SM_ACK_BLOCK) || ((pRcvHandle->currentBlockType) == SM_NACK_BLOCK)){
+		return SM_OK;
+	}
+	
+	rv = SM_DoesThisBlockNeedAnAck(pRcvHandle->currentBlockType);
+	if((rv != SM_OK) && (rv != SM_NO)) return SM_ERR;
+	
+	/* Out of order blocks, blocks we have no room for and data blocks received without buffer are not acknowledged, the computer will send them again ...  */
+	if((rcvdByte != (pRcvHandle->expectedSeq)) || ((pRcvHandle->nbBlocksQueued) >= SM_MAX_WINDOW_SIZE)){
+		pRcvHandle->flagDiscardBlock = 1;
+	}
+	
+	/* The application does not keep up, we ask the computer to pause until a block is released ...  */
+	if((pRcvHandle->nbBlocksQueued) >= SM_MAX_WINDOW_SIZE){
+		pRcvHandle->flagNoRoom = 1;
+		
+		rv = SM_UpdateFlowCtrl(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	
+	if((SM_DoesThisBlockCarryAPayload(pRcvHandle->currentBlockType) == SM_OK) && ((pRcvHandle->pBuffer) == NULL)){
+		pRcvHandle->flagDiscardBlock = 1;
 	}
 	
 	
@@ -1119,10 +2321,39 @@ static SM_Status SM_ApplyState_SM_RCVSTATE_LEN_BYTE2(SM_Handle *pHandle, uint8_t
 
 static SM_Status SM_ApplyState_SM_RCVSTATE_LEN_BYTE3(SM_Handle *pHandle, uint8_t rcvdByte){
 	SM_RcvHandle *pRcvHandle;
+	BUFF_Status buffRv;
+	uint32_t currentSize;
+	SM_Status rv;
+	
 	
 	pRcvHandle = &(pHandle->rcvHandle);
 	pRcvHandle->nbDataExpected += ((uint32_t)(rcvdByte)) & (uint32_t)(0x000000FF);
 	
+	/* In windowed mode, we check that the whole payload fits behind the already queued ones ...  */
+	if((SM_IsWindowedMode(pHandle) == SM_OK) && ((pRcvHandle->flagDiscardBlock) == 0)){
+		buffRv = BUFF_GetCurrentSize(pRcvHandle->pBuffer, &currentSize);
+		if(buffRv != BUFF_OK) return SM_ERR;
+		
+		if((pRcvHandle->nbDataExpected) > (BUFF_MAX_SIZE - currentSize)){
+			pRcvHandle->flagDiscardBlock = 1;
+			pRcvHandle->flagNoRoom = 1;
+			
+			rv = SM_UpdateFlowCtrl(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+		}
+	}
+	
+	/* A linear buffer can not wrap, the whole payload has to fit in the remaining room ...  */
+	if((pRcvHandle->pLinearBuffer) != NULL){
+		if((pRcvHandle->nbDataExpected) > ((pRcvHandle->pLinearBuffer->maxSize) - (pRcvHandle->pLinearBuffer->size))) return SM_ERR;
+	}
+	
+	/* The payload of a data block starts with the next byte, the application may start using it before the end of the block ...  */
+	if(((pRcvHandle->currentBlockType) == SM_DATA_BLOCK) && ((pRcvHandle->nbDataExpected) != 0) && ((pRcvHandle->flagDiscardBlock) == 0)){
+		rv = SM_DataPayloadStartedCallback(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	
 	return SM_OK;
 }
 
@@ -1136,16 +2367,36 @@ static SM_Status SM_ApplyState_SM_RCVSTATE_DATA(SM_Handle *pHandle, uint8_t rcvd
 	
 	pRcvHandle = &(pHandle->rcvHandle);
 	
+	/* The bytes of a discarded block are only counted (and checked) ...  */
+	if((pRcvHandle->flagDiscardBlock) != 0){
+		pRcvHandle->nbDataRcvd ++;
+		
+		if((pHandle->checkType) != SM_CHECK_NONE){
+			SM_UpdateCheck(pHandle, &(pRcvHandle->checkValue), &rcvdByte, 1);
+		}
+		
+		return SM_OK;
+	}
 	
-	/* We get a pointer on the reception buffer ...  */
-	rv = SM_GetRcptBufferPtr(pHandle, &pBuffer);
-	if(rv != SM_OK) return SM_ERR;
-	
-	buffRv = BUFF_Enqueue(pBuffer, rcvdByte);
-	if(buffRv != BUFF_OK) return SM_ERR;
+	if((pRcvHandle->pLinearBuffer) != NULL){
+		pRcvHandle->pLinearBuffer->pData[pRcvHandle->pLinearBuffer->size] = rcvdByte;
+		pRcvHandle->pLinearBuffer->size ++;
+	}
+	else{
+		/* We get a pointer on the reception buffer ...  */
+		rv = SM_GetRcptBufferPtr(pHandle, &pBuffer);
+		if(rv != SM_OK) return SM_ERR;
+		
+		buffRv = BUFF_Enqueue(pBuffer, rcvdByte);
+		if(buffRv != BUFF_OK) return SM_ERR;
+	}
 	
 	pRcvHandle->nbDataRcvd ++;
 	
+	if((pHandle->checkType) != SM_CHECK_NONE){
+		SM_UpdateCheck(pHandle, &(pRcvHandle->checkValue), &rcvdByte, 1);
+	}
+	
 	
 	return SM_OK;
 }
@@ -1155,7 +2406,28 @@ static SM_Status SM_ApplyState_SM_RCVSTATE_CHECK(SM_Handle *pHandle, uint8_t rcv
 	SM_Status rv, rv2;
 	
 	
-	/* TODO checking integrity ... */
+	/* The integrity of the block has already been verified when entering this state (see #SM_ProcessRcvdByte()) ...  */
+	
+	/* In windowed mode, the block is queued and the state machine is immediately ready for the next one ...  */
+	if(SM_IsWindowedMode(pHandle) == SM_OK){
+		rv = SM_EndWindowedBlockRcv(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+		
+		return SM_OK;
+	}
+	
+	/* A NACK asks for the last sent block again, it does not end the reception process, we wait for the next block ...  */
+	if((pHandle->rcvHandle.currentBlockType) == SM_NACK_BLOCK){
+		rv = Apply_SM_NACK_BLOCK_Received(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+		
+		pHandle->rcvHandle.currentState = SM_RCVSTATE_INIT;
+		
+		rv = SM_ApplyRcvState(pHandle, 0x00);
+		if(rv != SM_OK) return SM_ERR;
+		
+		return SM_OK;
+	}
 
 	/* Checking if we are in the last step of the transsmission process (are we expecting to receive an ACK ?) ...  */
 	rv = SM_DoesThisBlockNeedAnAck(pHandle->rcvHandle.currentBlockType);
@@ -1197,10 +2469,19 @@ static SM_Status SM_ApplyState_SM_RCVSTATE_ACK_CTRL_BYTE(SM_Handle *pHandle, uin
 	/* TODO : improve the verification of the ACK byte */
 	
 	
-	if(rcvdByte != SM_ACK_BLOCK){
+	if((rcvdByte != SM_ACK_BLOCK) && (rcvdByte != SM_NACK_BLOCK)){
 		return SM_ERR;
 	}
 	
+	pHandle->rcvHandle.chainedBlockType = rcvdByte;
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_ApplyState_SM_RCVSTATE_CHECK_MSB(SM_Handle *pHandle, uint8_t rcvdByte){
+	pHandle->rcvHandle.rcvdCheckMsb = rcvdByte;
+	
 	return SM_OK;
 }
 
@@ -1209,7 +2490,15 @@ static SM_Status SM_ApplyState_SM_RCVSTATE_ACK_CHECK(SM_Handle *pHandle, uint8_t
 	SM_Status rv;
 	
 	
-	/* TODO : LRC verification of the received ACK ...  */
+	/* The computer asks for our last block again, we keep waiting for its ACK ...  */
+	if((pHandle->rcvHandle.chainedBlockType) == SM_NACK_BLOCK){
+		rv = Apply_SM_NACK_BLOCK_Received(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+		
+		pHandle->rcvHandle.currentState = SM_RCVSTATE_CHECK;
+		
+		return SM_OK;
+	}
 	
 	rv = Apply_SM_ACK_BLOCK_Received(pHandle);
 	if(rv != SM_OK) return SM_ERR;
@@ -1235,76 +2524,48 @@ static SM_Status SM_ApplyState_SM_RCVSTATE_ACK_CHECK(SM_Handle *pHandle, uint8_t
 
 
 static SM_Status SM_ApplySendState(SM_Handle *pHandle, uint8_t *pByteToSend){
-	SM_SendHandle *pSendHandle;
+	SM_SendState currentState;
 	SM_Status rv;
 	
 	
-	pSendHandle = &(pHandle->sendHandle);
+	currentState = pHandle->sendHandle.currentState;
 	
-	switch(pSendHandle->currentState){
-		case SM_SENDSTATE_INIT:
-			rv = SM_ApplyState_SM_SENDSTATE_INIT(pHandle);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_SENDSTATE_CTRL_BYTE:
-			rv = SM_ApplyState_SM_SENDSTATE_CTRL_BYTE(pHandle, pByteToSend);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_SENDSTATE_LEN_BYTE1:
-			rv = SM_ApplyState_SM_SENDSTATE_LEN_BYTE1(pHandle, pByteToSend);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_SENDSTATE_LEN_BYTE2:
-			rv = SM_ApplyState_SM_SENDSTATE_LEN_BYTE2(pHandle, pByteToSend);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_SENDSTATE_LEN_BYTE3:
-			rv = SM_ApplyState_SM_SENDSTATE_LEN_BYTE3(pHandle, pByteToSend);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_SENDSTATE_DATA:
-			rv = SM_ApplyState_SM_SENDSTATE_DATA(pHandle, pByteToSend);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_SENDSTATE_CHECK:
-			rv = SM_ApplyState_SM_SENDSTATE_CHECK(pHandle, pByteToSend);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_SENDSTATE_RCVD_ACK:
-			rv = SM_ApplyState_SM_SENDSTATE_RCVD_ACK(pHandle, pByteToSend);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_SENDSTATE_ACK_CTRL_BYTE:
-			rv = SM_ApplyState_SM_SENDSTATE_ACK_CTRL_BYTE(pHandle, pByteToSend);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_SENDSTATE_ACK_CHECK:
-			rv = SM_ApplyState_SM_SENDSTATE_ACK_CHECK(pHandle, pByteToSend);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		default:
-			return SM_ERR;
+	if(currentState >= SM_NB_SENDSTATES){
+		return SM_ERR;
 	}
 	
+	rv = SM_SendStatesTable[currentState].apply(pHandle, pByteToSend);
+	if(rv != SM_OK) return SM_ERR;
+	
 	
 	return SM_OK;
 }
 
 
-static SM_Status SM_ApplyState_SM_SENDSTATE_INIT(SM_Handle *pHandle){
+static SM_Status SM_ApplyState_SM_SENDSTATE_INIT(SM_Handle *pHandle, uint8_t *pByteToSend){
+	BUFF_Status buffRv;
+	
+	
 	/* Initializing flags ...  */
 	pHandle->sendHandle.flagAckReceived = 0;
 	
+	pHandle->sendHandle.nbDataSent = 0;
+	pHandle->sendHandle.flagStalled = 0;
+	SM_InitCheck(pHandle, &(pHandle->sendHandle.checkValue));
+	
+	/* The payload size of a streamed block is given by the caller, its bytes are not in the buffer yet ...  */
+	if((pHandle->sendHandle.flagStreamed) != 0){
+		return SM_OK;
+	}
+	
+	/* We remember the payload size, the block is sent again from the same buffer if the computer answers with a NACK ...  */
+	pHandle->sendHandle.nbDataToSend = 0;
+	
+	if((pHandle->sendHandle.pBuffer) != NULL){
+		buffRv = BUFF_GetCurrentSize(pHandle->sendHandle.pBuffer, &(pHandle->sendHandle.nbDataToSend));
+		if(buffRv != BUFF_OK) return SM_ERR;
+	}
+	
 	return SM_OK;
 }
 
@@ -1336,40 +2597,39 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_CTRL_BYTE(SM_Handle *pHandle, uint8_
 }
 
 
-static SM_Status SM_ApplyState_SM_SENDSTATE_LEN_BYTE1(SM_Handle *pHandle, uint8_t *pByteToSend){
-	BUFF_Status buffRv;
-	BUFF_Buffer *pBuffer;
-	SM_Status rv;
-	uint32_t dataSize;
-	
+static SM_Status SM_ApplyState_SM_SENDSTATE_SEQ(SM_Handle *pHandle, uint8_t *pByteToSend){
+	SM_SendHandle *pSendHandle;
 	
-	rv = SM_GetSendBufferPtr(pHandle, &pBuffer);
-	if(rv != SM_OK) return SM_ERR;
 	
-	buffRv = BUFF_GetCurrentSize(pBuffer, &dataSize);
-	if(buffRv != BUFF_OK) return SM_ERR;
+	pSendHandle = &(pHandle->sendHandle);
 	
-	*pByteToSend = (uint8_t)((dataSize >> 16) & (uint32_t)(0x000000FF));
+	/* An ACK carries the sequence number of the last released block (cumulative ACK) ...  */
+	if((pSendHandle->currentBlockType) == SM_ACK_BLOCK){
+		pSendHandle->ackSeqSent = pSendHandle->ackSeqToSend;
+		*pByteToSend = pSendHandle->ackSeqSent;
+	}
+	else if((pSendHandle->currentBlockType) == SM_NACK_BLOCK){
+		*pByteToSend = pSendHandle->nackSeqToSend;
+	}
+	else{
+		*pByteToSend = pSendHandle->nextSeq;
+	}
 	
 	
 	return SM_OK;
 }
 
 
-static SM_Status SM_ApplyState_SM_SENDSTATE_LEN_BYTE2(SM_Handle *pHandle, uint8_t *pByteToSend){
-	BUFF_Status buffRv;
-	BUFF_Buffer *pBuffer;
-	SM_Status rv;
-	uint32_t dataSize;
-	
-	
-	rv = SM_GetSendBufferPtr(pHandle, &pBuffer);
-	if(rv != SM_OK) return SM_ERR;
+static SM_Status SM_ApplyState_SM_SENDSTATE_LEN_BYTE1(SM_Handle *pHandle, uint8_t *pByteToSend){
+	*pByteToSend = (uint8_t)(((pHandle->sendHandle.nbDataToSend) >> 16) & (uint32_t)(0x000000FF));
 	
-	buffRv = BUFF_GetCurrentSize(pBuffer, &dataSize);
-	if(buffRv != BUFF_OK) return SM_ERR;
 	
-	*pByteToSend = (uint8_t)((dataSize >> 8) & (uint32_t)(0x000000FF));
+	return SM_OK;
+}
+
+
+static SM_Status SM_ApplyState_SM_SENDSTATE_LEN_BYTE2(SM_Handle *pHandle, uint8_t *pByteToSend){
+	*pByteToSend = (uint8_t)(((pHandle->sendHandle.nbDataToSend) >> 8) & (uint32_t)(0x000000FF));
 	
 	
 	return SM_OK;
@@ -1377,19 +2637,7 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_LEN_BYTE2(SM_Handle *pHandle, uint8_
 
 
 static SM_Status SM_ApplyState_SM_SENDSTATE_LEN_BYTE3(SM_Handle *pHandle, uint8_t *pByteToSend){
-	BUFF_Status buffRv;
-	BUFF_Buffer *pBuffer;
-	SM_Status rv;
-	uint32_t dataSize;
-	
-	
-	rv = SM_GetSendBufferPtr(pHandle, &pBuffer);
-	if(rv != SM_OK) return SM_ERR;
-		
-	buffRv = BUFF_GetCurrentSize(pBuffer, &dataSize);
-	if(buffRv != BUFF_OK) return SM_ERR;
-	
-	*pByteToSend = (uint8_t)((dataSize >> 0) & (uint32_t)(0x000000FF));
+	*pByteToSend = (uint8_t)(((pHandle->sendHandle.nbDataToSend) >> 0) & (uint32_t)(0x000000FF));
 	
 	
 	return SM_OK;
@@ -1408,6 +2656,12 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_DATA(SM_Handle *pHandle, uint8_t *pB
 	buffRv = BUFF_Dequeue(pBuffer, pByteToSend);
 	if(buffRv != BUFF_OK) return SM_ERR;
 	
+	pHandle->sendHandle.nbDataSent++;
+	
+	if((pHandle->checkType) != SM_CHECK_NONE){
+		SM_UpdateCheck(pHandle, &(pHandle->sendHandle.checkValue), pByteToSend, 1);
+	}
+	
 	
 	return SM_OK;
 }
@@ -1417,9 +2671,20 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_CHECK(SM_Handle *pHandle, uint8_t *p
 	SM_Status rv;
 	
 	
-	/* TODO : Computing LRC check ... */
+	/* Least significant byte of the check value, it is the whole check for LRC and 0x00 if the check is disabled ...  */
+	*pByteToSend = (uint8_t)(pHandle->sendHandle.checkValue);
+	
+	if((pHandle->sendHandle.currentBlockType) == SM_NACK_BLOCK){
+		pHandle->sendHandle.flagNackExpected = 0;
+	}
 	
-	*pByteToSend = 0x00;
+	/* In windowed mode, the block is over as soon as it is sent, we do not wait for its ACK ...  */
+	if(SM_IsWindowedMode(pHandle) == SM_OK){
+		rv = SM_EndWindowedBlockSend(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+		
+		return SM_OK;
+	}
 	
 	/* If we have just sent an ACK and if it was expected by the reception state machine ...  */
 	if(((pHandle->sendHandle.currentBlockType) == SM_ACK_BLOCK) && ((pHandle->sendHandle.flagAckExpected) != 0)){
@@ -1432,8 +2697,8 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_CHECK(SM_Handle *pHandle, uint8_t *p
 	if((rv != SM_OK) && (rv != SM_NO)) return SM_ERR;
 	
 	
-	/* Do we have to send an ACK ?? ...  */
-	if((pHandle->sendHandle.flagAckExpected) != 0){
+	/* Do we have to send an ACK (or a NACK) ?? ...  */
+	if(((pHandle->sendHandle.flagAckExpected) != 0) || ((pHandle->sendHandle.flagNackExpected) != 0)){
 		
 	}
 	else{
@@ -1449,6 +2714,8 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_CHECK(SM_Handle *pHandle, uint8_t *p
 			/* We do not have to send an ACK and we need to receive an ACK  ...  */
 			pHandle->rcvHandle.flagAckExpected = 1;
 			
+			SM_StartAckTimer(pHandle);
+			
 			//rv = SM_ReceiveBlockWithSameBuffer(pHandle);             /* We start a new block reception process if it is not already ongoing ...  */
 			rv = SM_ReceiveBlock(pHandle, NULL);  /* We do not need a buffer for the reception, we expect to receive an ACK. */
 			if((rv != SM_OK) && (rv != SM_BUSY)) return SM_ERR;
@@ -1461,7 +2728,22 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_CHECK(SM_Handle *pHandle, uint8_t *p
 
 
 static SM_Status SM_ApplyState_SM_SENDSTATE_ACK_CTRL_BYTE(SM_Handle *pHandle, uint8_t *pByteToSend){
-	*pByteToSend = SM_ACK_BLOCK;
+	/* A pending ACK goes first, a pending NACK is sent afterwards ...  */
+	if((pHandle->sendHandle.flagAckExpected) != 0){
+		pHandle->sendHandle.chainedBlockType = SM_ACK_BLOCK;
+	}
+	else{
+		pHandle->sendHandle.chainedBlockType = SM_NACK_BLOCK;
+	}
+	
+	*pByteToSend = pHandle->sendHandle.chainedBlockType;
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_ApplyState_SM_SENDSTATE_CHECK_MSB(SM_Handle *pHandle, uint8_t *pByteToSend){
+	*pByteToSend = (uint8_t)((pHandle->sendHandle.checkValue) >> 8);
 	
 	return SM_OK;
 }
@@ -1469,16 +2751,26 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_ACK_CTRL_BYTE(SM_Handle *pHandle, ui
 
 static SM_Status SM_ApplyState_SM_SENDSTATE_ACK_CHECK(SM_Handle *pHandle, uint8_t *pByteToSend){
 	SM_Status rv;
-	/* TODO implement LRC */
 	
-	*pByteToSend = 0x00;
+	
+	*pByteToSend = (uint8_t)(pHandle->sendHandle.checkValue);
+	
+	if((pHandle->sendHandle.chainedBlockType) == SM_NACK_BLOCK){
+		pHandle->sendHandle.flagNackExpected = 0;
+	}
+	else{
+		rv = Apply_SM_ACK_BLOCK_Transmitted(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	
+	/* A NACK is still waiting to be sent after this ACK, we go through the ACK branch again ...  */
+	if((pHandle->sendHandle.flagNackExpected) != 0){
+		return SM_OK;
+	}
 	
 	/* We set the flag indicating that we have no more data to be sent ...  */
 	pHandle->sendHandle.flagEmpty = 1;
 	
-	rv = Apply_SM_ACK_BLOCK_Transmitted(pHandle);
-	if(rv != SM_OK) return SM_ERR;
-	
 	
 	rv = SM_DoesThisBlockNeedAnAck(pHandle->sendHandle.currentBlockType);
 	if((rv != SM_OK) && (rv != SM_NO)) return SM_ERR;
@@ -1487,6 +2779,8 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_ACK_CHECK(SM_Handle *pHandle, uint8_
 	if(rv == SM_OK){
 		pHandle->rcvHandle.flagAckExpected = 1;
 		
+		SM_StartAckTimer(pHandle);
+		
 		rv = SM_ReceiveBlock(pHandle, NULL);
 		if((rv != SM_OK) && (rv != SM_BUSY)) return SM_ERR;   /* TODO : Behavior to have if it is busy ? */
 	}
@@ -1500,67 +2794,19 @@ static SM_Status SM_ApplyState_SM_SENDSTATE_ACK_CHECK(SM_Handle *pHandle, uint8_
 
 
 static SM_Status SM_ComputeNextSendState(SM_Handle *pHandle, SM_SendState *pNextState){
-	SM_SendHandle *pSendHandle;
+	SM_SendState currentState;
 	SM_Status rv;
 	
 	
-	pSendHandle = &(pHandle->sendHandle);
+	currentState = pHandle->sendHandle.currentState;
 	
-	switch(pSendHandle->currentState){
-		case SM_SENDSTATE_INIT:
-			rv = SM_ComputeNextStateFrom_SM_SENDSTATE_INIT(pHandle, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_SENDSTATE_CTRL_BYTE:
-			rv = SM_ComputeNextStateFrom_SM_SENDSTATE_CTRL_BYTE(pHandle, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_SENDSTATE_LEN_BYTE1:
-			rv = SM_ComputeNextStateFrom_SM_SENDSTATE_LEN_BYTE1(pHandle, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_SENDSTATE_LEN_BYTE2:
-			rv = SM_ComputeNextStateFrom_SM_SENDSTATE_LEN_BYTE2(pHandle, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_SENDSTATE_LEN_BYTE3:
-			rv = SM_ComputeNextStateFrom_SM_SENDSTATE_LEN_BYTE3(pHandle, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_SENDSTATE_DATA:
-			rv = SM_ComputeNextStateFrom_SM_SENDSTATE_DATA(pHandle, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		case SM_SENDSTATE_CHECK:
-			rv = SM_ComputeNextStateFrom_SM_SENDSTATE_CHECK(pHandle, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_SENDSTATE_ACK_CTRL_BYTE:
-			rv = SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CTRL_BYTE(pHandle, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_SENDSTATE_ACK_CHECK:
-			rv = SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CHECK(pHandle, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-			
-		case SM_SENDSTATE_RCVD_ACK:
-			rv = SM_ComputeNextStateFrom_SM_SENDSTATE_RCVD_ACK(pHandle, pNextState);
-			if(rv != SM_OK) return SM_ERR;
-			break;
-		
-		default:
-			return SM_ERR;
+	if(currentState >= SM_NB_SENDSTATES){
+		return SM_ERR;
 	}
 	
+	rv = SM_SendStatesTable[currentState].computeNext(pHandle, pNextState);
+	if(rv != SM_OK) return SM_ERR;
+	
 	
 	return SM_OK;
 }
@@ -1588,21 +2834,63 @@ static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_CTRL_BYTE(SM_Handle *pHand
 	pSendHandle = &(pHandle->sendHandle);
 	type = pSendHandle->currentBlockType;
 	
+	/* In windowed mode, the sequence number is sent right after the control byte ...  */
+	if((SM_IsWindowedMode(pHandle) == SM_OK) && (SM_DoesThisBlockCarryASeq(type) == SM_OK)){
+		*pNextState = SM_SENDSTATE_SEQ;
+		return SM_OK;
+	}
+	
 	switch(type){
 		case SM_DATA_BLOCK:
 			*pNextState = SM_SENDSTATE_LEN_BYTE1;
 			break;
 		
+		case SM_SEQUENCE_BLOCK:
+			*pNextState = SM_SENDSTATE_LEN_BYTE1;
+			break;
+		
+		case SM_HELLO_BLOCK:
+			*pNextState = SM_SENDSTATE_LEN_BYTE1;
+			break;
+		
+		case SM_BAUD_BLOCK:
+			*pNextState = SM_SENDSTATE_LEN_BYTE1;
+			break;
+		
+		case SM_TIMING_BLOCK:
+			*pNextState = SM_SENDSTATE_LEN_BYTE1;
+			break;
+		
+		case SM_ATR_BLOCK:
+			*pNextState = SM_SENDSTATE_LEN_BYTE1;
+			break;
+		
+		case SM_CLOCK_BLOCK:
+			*pNextState = SM_SENDSTATE_LEN_BYTE1;
+			break;
+		
 		case SM_COLD_RST_BLOCK:
-			*pNextState = SM_SENDSTATE_CHECK;
+			*pNextState = SM_GetSendCheckEntryState(pHandle, SM_SENDSTATE_CHECK);
+			break;
+		
+		case SM_WARM_RST_BLOCK:
+			*pNextState = SM_GetSendCheckEntryState(pHandle, SM_SENDSTATE_CHECK);
 			break;
 			
 		case SM_BUSY_BLOCK:
-			*pNextState = SM_SENDSTATE_CHECK;
+			*pNextState = SM_GetSendCheckEntryState(pHandle, SM_SENDSTATE_CHECK);
+			break;
+		
+		case SM_READY_BLOCK:
+			*pNextState = SM_GetSendCheckEntryState(pHandle, SM_SENDSTATE_CHECK);
 			break;
 		
 		case SM_ACK_BLOCK:
-			*pNextState = SM_SENDSTATE_CHECK;
+			*pNextState = SM_GetSendCheckEntryState(pHandle, SM_SENDSTATE_CHECK);
+			break;
+		
+		case SM_NACK_BLOCK:
+			*pNextState = SM_GetSendCheckEntryState(pHandle, SM_SENDSTATE_CHECK);
 			break;
 		
 		case SM_UNKNOWN_BLOCK:
@@ -1618,6 +2906,19 @@ static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_CTRL_BYTE(SM_Handle *pHand
 }
 
 
+static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_SEQ(SM_Handle *pHandle, SM_SendState *pNextState){
+	if(SM_DoesThisBlockCarryAPayload(pHandle->sendHandle.currentBlockType) == SM_OK){
+		*pNextState = SM_SENDSTATE_LEN_BYTE1;
+	}
+	else{
+		*pNextState = SM_GetSendCheckEntryState(pHandle, SM_SENDSTATE_CHECK);
+	}
+	
+	
+	return SM_OK;
+}
+
+
 static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_LEN_BYTE1(SM_Handle *pHandle, SM_SendState *pNextState){
 	*pNextState = SM_SENDSTATE_LEN_BYTE2;
 	
@@ -1633,22 +2934,12 @@ static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_LEN_BYTE2(SM_Handle *pHand
 
 
 static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_LEN_BYTE3(SM_Handle *pHandle, SM_SendState *pNextState){
-	BUFF_Status buffRv;
-	BUFF_Buffer *pBuffer;
-	SM_Status rv;
-	
-	
-	rv = SM_GetSendBufferPtr(pHandle, &pBuffer);
-	if(rv != SM_OK) return SM_ERR;
-	
-	buffRv = BUFF_IsEmpty(pBuffer);
-	if((buffRv != BUFF_OK) && (buffRv != BUFF_NO)) return SM_ERR;
-	
-	if(buffRv == BUFF_OK){
-		*pNextState = SM_SENDSTATE_CHECK;
+	/* The DATA state is skipped when the block has an empty payload ...  */
+	if((pHandle->sendHandle.nbDataSent) < (pHandle->sendHandle.nbDataToSend)){
+		*pNextState = SM_SENDSTATE_DATA;
 	}
 	else{
-		*pNextState = SM_SENDSTATE_DATA;
+		*pNextState = SM_GetSendCheckEntryState(pHandle, SM_SENDSTATE_CHECK);
 	}
 	
 	
@@ -1657,25 +2948,15 @@ static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_LEN_BYTE3(SM_Handle *pHand
 
 
 static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_DATA(SM_Handle *pHandle, SM_SendState *pNextState){
-	BUFF_Status buffRv;
-	BUFF_Buffer *pBuffer;
-	SM_Status rv;
-	
-	
-	rv = SM_GetSendBufferPtr(pHandle, &pBuffer);
-	if(rv != SM_OK) return SM_ERR;
-	
-	buffRv = BUFF_IsEmpty(pBuffer);
-	if((buffRv != BUFF_OK) && (buffRv != BUFF_NO)) return SM_ERR;
-	
-	/* If the buffer containing the payload data to be sent is not empty */
-	if(buffRv == BUFF_NO){
+	/* We stay in the DATA state until the whole payload announced in the LEN bytes has been sent ...  */
+	if((pHandle->sendHandle.nbDataSent) < (pHandle->sendHandle.nbDataToSend)){
 		*pNextState = SM_SENDSTATE_DATA;
 	}
 	else{
-		*pNextState = SM_SENDSTATE_CHECK;
+		*pNextState = SM_GetSendCheckEntryState(pHandle, SM_SENDSTATE_CHECK);
 	}
 	
+	
 	return SM_OK;
 }
 
@@ -1691,6 +2972,9 @@ static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_CHECK(SM_Handle *pHandle,
 	if((pHandle->sendHandle.flagAckExpected) != 0){   /* If we have to send an ACK, we go straight to the send ACK branch ...  */
 		*pNextState = SM_SENDSTATE_ACK_CTRL_BYTE;
 	}
+	else if(((pHandle->sendHandle.flagNackExpected) != 0) && ((pHandle->sendHandle.flagEmpty) == 0)){   /* Same thing for a NACK (see #SM_SendNack()) ...  */
+		*pNextState = SM_SENDSTATE_ACK_CTRL_BYTE;
+	}
 	else{
 		if(rv == SM_OK){                             /* Else, if we received an ACK and it was expected ...                   */
 			if((pHandle->sendHandle.flagAckReceived) != 0){ 
@@ -1711,6 +2995,20 @@ static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_CHECK(SM_Handle *pHandle,
 
 
 static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CTRL_BYTE(SM_Handle *pHandle, SM_SendState *pNextState){
+	*pNextState = SM_GetSendCheckEntryState(pHandle, SM_SENDSTATE_ACK_CHECK);
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_CHECK_MSB(SM_Handle *pHandle, SM_SendState *pNextState){
+	*pNextState = SM_SENDSTATE_CHECK;
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CHECK_MSB(SM_Handle *pHandle, SM_SendState *pNextState){
 	*pNextState = SM_SENDSTATE_ACK_CHECK;
 	
 	return SM_OK;
@@ -1721,6 +3019,12 @@ static SM_Status SM_ComputeNextStateFrom_SM_SENDSTATE_ACK_CHECK(SM_Handle *pHand
 	SM_Status rv;
 	
 	
+	/* A NACK is still waiting to be sent (see #SM_SendNack()), we go through the ACK branch again ...  */
+	if(((pHandle->sendHandle.flagNackExpected) != 0) && ((pHandle->sendHandle.flagEmpty) == 0)){
+		*pNextState = SM_SENDSTATE_ACK_CTRL_BYTE;
+		return SM_OK;
+	}
+	
 	/* We see if we need to receive an ACK ...  */
 	rv = SM_DoesThisBlockNeedAnAck(pHandle->sendHandle.currentBlockType);
 	if((rv != SM_OK) && (rv != SM_NO)) return SM_ERR;
@@ -1765,19 +3069,1008 @@ static SM_Status SM_DoesThisBlockNeedAnAck(SM_CtrlBlockType type){
 			return SM_OK;
 			break;
 		
+		case SM_SEQUENCE_BLOCK:
+			return SM_OK;
+			break;
+		
+		case SM_HELLO_BLOCK:
+			return SM_OK;
+			break;
+		
+		case SM_BAUD_BLOCK:
+			return SM_OK;
+			break;
+		
+		case SM_TIMING_BLOCK:
+			return SM_OK;
+			break;
+		
+		case SM_ATR_BLOCK:
+			return SM_OK;
+			break;
+		
+		case SM_CLOCK_BLOCK:
+			return SM_OK;
+			break;
+		
 		case SM_COLD_RST_BLOCK:
 			return SM_OK;
 			break;
+		
+		case SM_WARM_RST_BLOCK:
+			return SM_OK;
+			break;
 			
 		case SM_BUSY_BLOCK:
 			return SM_NO;
 			break;
 			
+		case SM_READY_BLOCK:
+			return SM_NO;
+			break;
+			
 		case SM_ACK_BLOCK:
 			return SM_NO;
 			break;
+			
+		case SM_NACK_BLOCK:
+			return SM_NO;
+			break;
 		
 		default:
 			return SM_ERR;
 	}
 }
+
+
+/**
+ * \fn static SM_Status SM_EndWindowedBlockRcv(SM_Handle *pHandle)
+ * \brief Perform all the necessary actions when a block has been completely received in windowed mode.
+ * \param *pHandle Is a pointer on a #SM_Handle struct containing the current communication context.
+ * \return This function returns an #SM_Status error code to indicate if the function behaved as expected or not.
+ * 
+ * Unlike #SM_EndBlockRcvProcess(), the reception process is not ended : the block is queued (see #SM_GetRcvdBlockInfo()) and the state machine goes back to its initial state to receive the next block.
+ * The block is acknowledged later, when it is released by #SM_ReleaseRcvdBlock().
+ */
+static SM_Status SM_EndWindowedBlockRcv(SM_Handle *pHandle){
+	SM_RcvHandle *pRcvHandle;
+	SM_RcvdBlockInfo *pInfo;
+	SM_CtrlBlockType type;
+	SM_Status rv;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	type = pRcvHandle->currentBlockType;
+	
+	if(type == SM_ACK_BLOCK){
+		rv = Apply_SM_ACK_BLOCK_ReceivedCumulative(pHandle, pRcvHandle->currentSeq);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	else if(type == SM_NACK_BLOCK){
+		/* A NACK carries the sequence number of the block the computer expects, all the previous ones are acknowledged ...  */
+		rv = Apply_SM_ACK_BLOCK_ReceivedCumulative(pHandle, (uint8_t)((pRcvHandle->currentSeq) - 1));
+		if(rv != SM_OK) return SM_ERR;
+	}
+	else if((pRcvHandle->flagDiscardBlock) == 0){
+		rv = SM_DoesThisBlockNeedAnAck(type);
+		if((rv != SM_OK) && (rv != SM_NO)) return SM_ERR;
+		
+		/* We queue the block until the caller releases it ...  */
+		if(rv == SM_OK){
+			pInfo = &(pRcvHandle->blocksQueue[(pRcvHandle->blocksQueueHead + pRcvHandle->nbBlocksQueued) % SM_MAX_WINDOW_SIZE]);
+			pInfo->type = type;
+			pInfo->seq = pRcvHandle->currentSeq;
+			pInfo->size = pRcvHandle->nbDataRcvd;
+			
+			pRcvHandle->nbBlocksQueued++;
+			pRcvHandle->expectedSeq++;
+		}
+		
+		rv = SM_CallRcvdBlockCallbacks(pHandle, type);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	
+	/* We are ready for the next block ...  */
+	pRcvHandle->currentState = SM_RCVSTATE_INIT;
+	
+	rv = SM_ApplyRcvState(pHandle, 0x00);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn static SM_Status Apply_SM_ACK_BLOCK_ReceivedCumulative(SM_Handle *pHandle, uint8_t ackSeq)
+ * \brief Frees the window slots of all the blocks acknowledged by a received cumulative ACK (windowed mode).
+ * \param *pHandle Is a pointer on a #SM_Handle struct containing the current communication context.
+ * \param ackSeq is the sequence number carried by the ACK, it is the sequence number of the last acknowledged block.
+ * \return This function returns an #SM_Status error code to indicate if the function behaved as expected or not.
+ * 
+ * Duplicated or outdated ACKs are silently ignored.
+ */
+static SM_Status Apply_SM_ACK_BLOCK_ReceivedCumulative(SM_Handle *pHandle, uint8_t ackSeq){
+	SM_SendHandle *pSendHandle;
+	uint8_t firstSeq;
+	uint32_t nbAcked;
+	SM_Status rv;
+	
+	
+	pSendHandle = &(pHandle->sendHandle);
+	
+	if((pSendHandle->nbBlocksInFlight) == 0){
+		return SM_OK;
+	}
+	
+	/* Sequence number of the oldest unacknowledged block ...  */
+	firstSeq = (uint8_t)((pSendHandle->nextSeq) - (pSendHandle->nbBlocksInFlight));
+	nbAcked = (uint32_t)((uint8_t)(ackSeq - firstSeq)) + 1;
+	
+	if(nbAcked > (pSendHandle->nbBlocksInFlight)){
+		return SM_OK;
+	}
+	
+	pSendHandle->nbBlocksInFlight -= nbAcked;
+	
+	/* The timer now covers the oldest block still in flight, if any ...  */
+	SM_StopAckTimer(pHandle);
+	
+	if((pSendHandle->nbBlocksInFlight) == 0){
+		pHandle->rcvHandle.flagAckExpected = 0;
+	}
+	else{
+		SM_StartAckTimer(pHandle);
+	}
+	
+	pHandle->rcvHandle.flagAckRcptOccurred = 1;
+	
+	rv = SM_ACK_BLOCK_ReceivedCallback(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn static SM_Status SM_EndWindowedBlockSend(SM_Handle *pHandle)
+ * \brief Perform all the necessary actions when the last byte of a block has been sent in windowed mode.
+ * \param *pHandle Is a pointer on a #SM_Handle struct containing the current communication context.
+ * \return This function returns an #SM_Status error code to indicate if the function behaved as expected or not.
+ * 
+ * A block needing an ACK takes a slot in the window until it is acknowledged, the transmission state machine is released anyway.
+ * If some blocks have been released while an ACK was being sent, a new (cumulative) ACK is chained by #SM_EndBlockSendProcess().
+ */
+static SM_Status SM_EndWindowedBlockSend(SM_Handle *pHandle){
+	SM_SendHandle *pSendHandle;
+	SM_Status rv;
+	
+	
+	pSendHandle = &(pHandle->sendHandle);
+	
+	if((pSendHandle->currentBlockType) == SM_ACK_BLOCK){
+		if((pSendHandle->ackSeqSent) == (pSendHandle->ackSeqToSend)){
+			pSendHandle->flagAckExpected = 0;
+		}
+	}
+	else{
+		rv = SM_DoesThisBlockNeedAnAck(pSendHandle->currentBlockType);
+		if((rv != SM_OK) && (rv != SM_NO)) return SM_ERR;
+		
+		if(rv == SM_OK){
+			pSendHandle->nextSeq++;
+			pSendHandle->nbBlocksInFlight++;
+			pHandle->rcvHandle.flagAckExpected = 1;
+			
+			SM_StartAckTimer(pHandle);
+			
+			/* We make sure that the reception state machine is listening for the ACK ...  */
+			rv = SM_ReceiveBlock(pHandle, NULL);
+			if((rv != SM_OK) && (rv != SM_BUSY)) return SM_ERR;
+		}
+	}
+	
+	/* We set the flag indicating that we have no more data to be sent ...  */
+	pSendHandle->flagEmpty = 1;
+	
+	rv = SM_EndBlockSendProcess(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_DoesThisBlockCarryASeq(SM_CtrlBlockType type){
+	SM_Status rv;
+	
+	
+	if((type == SM_ACK_BLOCK) || (type == SM_NACK_BLOCK)){
+		return SM_OK;
+	}
+	
+	rv = SM_DoesThisBlockNeedAnAck(type);
+	if(rv == SM_OK){
+		return SM_OK;
+	}
+	
+	
+	return SM_NO;
+}
+
+
+/**
+ * \fn static SM_Status SM_DoesThisBlockCarryAPayload(SM_CtrlBlockType type)
+ * \param type is a #SM_CtrlBlockType value indicating the type of the block.
+ * \return This function returns #SM_OK if a block of this type has a LEN field followed by payload bytes. It returns #SM_NO otherwise.
+ */
+static SM_Status SM_DoesThisBlockCarryAPayload(SM_CtrlBlockType type){
+	if((type == SM_DATA_BLOCK) || (type == SM_SEQUENCE_BLOCK) || (type == SM_HELLO_BLOCK) || (type == SM_BAUD_BLOCK) || (type == SM_TIMING_BLOCK) || (type == SM_ATR_BLOCK) || (type == SM_CLOCK_BLOCK)){
+		return SM_OK;
+	}
+	
+	
+	return SM_NO;
+}
+
+
+static SM_Status SM_IsWindowedMode(SM_Handle *pHandle){
+	if((pHandle->windowSize) > 1){
+		return SM_OK;
+	}
+	
+	return SM_NO;
+}
+
+
+/* Tells if the transmission has to wait for the next payload bytes of a streamed block ...  */
+static SM_Status SM_IsSendStalled(SM_Handle *pHandle){
+	SM_SendHandle *pSendHandle;
+	
+	
+	pSendHandle = &(pHandle->sendHandle);
+	
+	if((pSendHandle->flagStreamed) == 0){
+		return SM_NO;
+	}
+	
+	if(((pSendHandle->currentState) != SM_SENDSTATE_LEN_BYTE3) && ((pSendHandle->currentState) != SM_SENDSTATE_DATA)){
+		return SM_NO;
+	}
+	
+	if(((pSendHandle->nbDataSent) < (pSendHandle->nbDataToSend)) && ((pSendHandle->pBuffer->currentSize) == 0)){
+		return SM_OK;
+	}
+	
+	return SM_NO;
+}
+
+
+static SM_Status SM_ResetWindow(SM_Handle *pHandle){
+	SM_RcvHandle *pRcvHandle;
+	SM_SendHandle *pSendHandle;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	pSendHandle = &(pHandle->sendHandle);
+	
+	pRcvHandle->currentSeq = 0;
+	pRcvHandle->expectedSeq = 0;
+	pRcvHandle->flagDiscardBlock = 0;
+	pRcvHandle->blocksQueueHead = 0;
+	pRcvHandle->nbBlocksQueued = 0;
+	
+	pSendHandle->nextSeq = 0;
+	pSendHandle->nbBlocksInFlight = 0;
+	pSendHandle->ackSeqToSend = 0;
+	pSendHandle->ackSeqSent = 0;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn static SM_Status SM_RetransmitLastBlock(SM_Handle *pHandle)
+ * \brief Starts again the transmission of the last sent block, because the computer answered with a NACK or because its ACK timer expired (legacy mode only).
+ * \param *pHandle Is a pointer on a #SM_Handle struct containing the current communication context.
+ * \return This function returns an #SM_Status error code to indicate if the function behaved as expected or not.
+ * 
+ * The block is sent again only if it has been completely sent and if we are still waiting for its ACK.
+ * Once the block has been sent #SM_MAX_NB_RETRIES times again, the transmission is given up (see #SM_AbortBlockSend()).
+ * The payload is sent again from the same buffer, its bytes are still in there because the caller does not modify the buffer until the transmission process is over (see #SM_SendBlock()).
+ */
+static SM_Status SM_RetransmitLastBlock(SM_Handle *pHandle){
+	SM_SendHandle *pSendHandle;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	uint32_t currentSize;
+	uint8_t dummy;
+	
+	
+	pSendHandle = &(pHandle->sendHandle);
+	
+	if(((pSendHandle->flagSendOngoing) == 0) || ((pSendHandle->flagEmpty) == 0) || ((pSendHandle->flagAckReceived) != 0)){
+		return SM_OK;
+	}
+	
+	rv = SM_DoesThisBlockNeedAnAck(pSendHandle->currentBlockType);
+	if((rv != SM_OK) && (rv != SM_NO)) return SM_ERR;
+	
+	if(rv == SM_NO){
+		return SM_OK;
+	}
+	
+	if((pHandle->ackTimer.nbRetries) >= SM_MAX_NB_RETRIES){
+		rv = SM_AbortBlockSend(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+		
+		return SM_OK;
+	}
+	
+	pHandle->ackTimer.nbRetries++;
+	pHandle->ackTimer.flagRetransmitted = 1;
+	pHandle->ackTimer.flagArmed = 0;
+	
+	/* We give back to the buffer the payload bytes already sent ...  */
+	if((pSendHandle->pBuffer) != NULL){
+		buffRv = BUFF_GetCurrentSize(pSendHandle->pBuffer, &currentSize);
+		if(buffRv != BUFF_OK) return SM_ERR;
+		
+		buffRv = BUFF_Rewind(pSendHandle->pBuffer, (pSendHandle->nbDataToSend) - currentSize);
+		if(buffRv != BUFF_OK) return SM_ERR;
+	}
+	
+	pSendHandle->currentState = SM_SENDSTATE_INIT;
+	
+	rv = SM_ApplySendState(pHandle, &dummy);
+	if(rv != SM_OK) return SM_ERR;
+	
+	pSendHandle->flagEmpty = 0;
+	
+	rv = SM_EnableTxeInterrupt_Callback(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/* Accumulates in the check value the header bytes of the block being received and verifies the check when entering the CHECK states. Returns SM_NO if the block is corrupted ...  */
+static SM_Status SM_UpdateRcvCheck(SM_Handle *pHandle, SM_RcvState nextState, uint8_t rcvdByte){
+	SM_RcvHandle *pRcvHandle;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	
+	switch(nextState){
+		case SM_RCVSTATE_CTRL_BYTE:
+		case SM_RCVSTATE_ACK_CTRL_BYTE:
+			SM_InitCheck(pHandle, &(pRcvHandle->checkValue));
+			SM_UpdateCheck(pHandle, &(pRcvHandle->checkValue), &rcvdByte, 1);
+			break;
+			
+		case SM_RCVSTATE_SEQ:
+		case SM_RCVSTATE_LEN_BYTE1:
+		case SM_RCVSTATE_LEN_BYTE2:
+		case SM_RCVSTATE_LEN_BYTE3:
+			SM_UpdateCheck(pHandle, &(pRcvHandle->checkValue), &rcvdByte, 1);
+			break;
+			
+		case SM_RCVSTATE_CHECK:
+			/* Staying in the CHECK state (or coming back to it from the ACK branch) does not mean a new block ...  */
+			if(((pRcvHandle->currentState) == SM_RCVSTATE_CHECK) || ((pRcvHandle->currentState) == SM_RCVSTATE_ACK_CHECK)){
+				break;
+			}
+			return SM_IsRcvdCheckValid(pHandle, rcvdByte);
+			
+		case SM_RCVSTATE_ACK_CHECK:
+			if((pRcvHandle->currentState) == SM_RCVSTATE_ACK_CHECK){
+				break;
+			}
+			return SM_IsRcvdCheckValid(pHandle, rcvdByte);
+			
+		default:
+			break;
+	}
+	
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_IsRcvdCheckValid(SM_Handle *pHandle, uint8_t rcvdByte){
+	SM_RcvHandle *pRcvHandle;
+	uint16_t rcvdCheck;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	
+	switch(pHandle->checkType){
+		case SM_CHECK_LRC:
+			rcvdCheck = (uint16_t)(rcvdByte);
+			break;
+			
+		case SM_CHECK_CRC16:
+			rcvdCheck = (uint16_t)(((uint16_t)(pRcvHandle->rcvdCheckMsb) << 8) | (uint16_t)(rcvdByte));
+			break;
+			
+		default:
+			return SM_OK;
+	}
+	
+	if(rcvdCheck != (pRcvHandle->checkValue)){
+		return SM_NO;
+	}
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn static SM_Status SM_RejectRcvdBlock(SM_Handle *pHandle, SM_RcvState checkState)
+ * \brief Drops the block being received because its check is wrong.
+ * \param *pHandle Is a pointer on a #SM_Handle struct containing the current communication context.
+ * \param checkState is the CHECK state we were about to enter (#SM_RCVSTATE_CHECK or #SM_RCVSTATE_ACK_CHECK).
+ * \return This function returns an #SM_Status error code to indicate if the function behaved as expected or not.
+ * 
+ * The payload bytes of a corrupted data block are removed from the reception buffer and a NACK is sent to the computer, the reception process goes on with the next block.
+ * A corrupted ACK or NACK is only dropped, we keep waiting for the ACK.
+ */
+static SM_Status SM_RejectRcvdBlock(SM_Handle *pHandle, SM_RcvState checkState){
+	SM_RcvHandle *pRcvHandle;
+	SM_CtrlBlockType type;
+	SM_Status rv;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	type = pRcvHandle->currentBlockType;
+	
+	/* A corrupted ACK received right after a block, we go back to the CHECK state of this block to wait for the ACK ...  */
+	if(checkState == SM_RCVSTATE_ACK_CHECK){
+		pRcvHandle->currentState = SM_RCVSTATE_CHECK;
+		return SM_OK;
+	}
+	
+	rv = SM_DropRcvdPayload(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	if((type != SM_ACK_BLOCK) && (type != SM_NACK_BLOCK)){
+		rv = SM_SendNack(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	
+	/* We are ready for the next block ...  */
+	pRcvHandle->currentState = SM_RCVSTATE_INIT;
+	
+	rv = SM_ApplyRcvState(pHandle, 0x00);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/**
+ * \fn static SM_Status SM_SendNack(SM_Handle *pHandle)
+ * \brief Asks the computer to send again the block which has just been received corrupted.
+ * \param *pHandle Is a pointer on a #SM_Handle struct containing the current communication context.
+ * \return This function returns an #SM_Status error code to indicate if the function behaved as expected or not.
+ * 
+ * As for the ACKs, if the transmission state machine is busy the NACK is chained after the current block (see #SM_EndBlockSendProcess()).
+ * In legacy mode, if the transmission state machine is only waiting for the ACK of its last block, it is woken up to send the NACK through its ACK branch.
+ */
+static SM_Status SM_SendNack(SM_Handle *pHandle){
+	SM_SendHandle *pSendHandle;
+	SM_Status rv;
+	
+	
+	pSendHandle = &(pHandle->sendHandle);
+	
+	pSendHandle->flagNackExpected = 1;
+	pSendHandle->nackSeqToSend = pHandle->rcvHandle.expectedSeq;
+	
+	rv = SM_SendBlock(pHandle, NULL, SM_NACK_BLOCK);
+	if((rv != SM_OK) && (rv != SM_BUSY)) return SM_ERR;
+	
+	if((rv == SM_BUSY) && (SM_IsWindowedMode(pHandle) != SM_OK) && ((pSendHandle->flagSendOngoing) != 0) && ((pSendHandle->flagEmpty) != 0)){
+		pSendHandle->flagEmpty = 0;
+		
+		rv = SM_EnableTxeInterrupt_Callback(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	
+	
+	return SM_OK;
+}
+
+
+/* Accumulates in the check value the header bytes of the block being sent, the payload bytes are accumulated by the DATA state ...  */
+static SM_Status SM_UpdateSendCheck(SM_Handle *pHandle, uint8_t sentByte){
+	SM_SendHandle *pSendHandle;
+	
+	
+	pSendHandle = &(pHandle->sendHandle);
+	
+	switch(pSendHandle->currentState){
+		case SM_SENDSTATE_CTRL_BYTE:
+		case SM_SENDSTATE_ACK_CTRL_BYTE:
+			SM_InitCheck(pHandle, &(pSendHandle->checkValue));
+			SM_UpdateCheck(pHandle, &(pSendHandle->checkValue), &sentByte, 1);
+			break;
+			
+		case SM_SENDSTATE_SEQ:
+		case SM_SENDSTATE_LEN_BYTE1:
+		case SM_SENDSTATE_LEN_BYTE2:
+		case SM_SENDSTATE_LEN_BYTE3:
+			SM_UpdateCheck(pHandle, &(pSendHandle->checkValue), &sentByte, 1);
+			break;
+			
+		default:
+			break;
+	}
+	
+	
+	return SM_OK;
+}
+
+
+/* With a CRC-16 the CHECK field is two bytes long, we go through the additional state receiving the most significant byte ...  */
+static SM_RcvState SM_GetRcvCheckEntryState(SM_Handle *pHandle, SM_RcvState checkState){
+	if((pHandle->checkType) != SM_CHECK_CRC16){
+		return checkState;
+	}
+	
+	if(checkState == SM_RCVSTATE_ACK_CHECK){
+		return SM_RCVSTATE_ACK_CHECK_MSB;
+	}
+	
+	return SM_RCVSTATE_CHECK_MSB;
+}
+
+
+static SM_SendState SM_GetSendCheckEntryState(SM_Handle *pHandle, SM_SendState checkState){
+	if((pHandle->checkType) != SM_CHECK_CRC16){
+		return checkState;
+	}
+	
+	if(checkState == SM_SENDSTATE_ACK_CHECK){
+		return SM_SENDSTATE_ACK_CHECK_MSB;
+	}
+	
+	return SM_SENDSTATE_CHECK_MSB;
+}
+
+
+static void SM_InitCheck(SM_Handle *pHandle, uint16_t *pCheck){
+	if((pHandle->checkType) == SM_CHECK_CRC16){
+		*pCheck = (uint16_t)(0xFFFF);
+	}
+	else{
+		*pCheck = (uint16_t)(0x0000);
+	}
+}
+
+
+/* Table driven CRC-16/CCITT (one lookup per byte) or LRC ...  */
+static void SM_UpdateCheck(SM_Handle *pHandle, uint16_t *pCheck, const uint8_t *pBytes, uint32_t nbBytes){
+	uint16_t check;
+	uint32_t i;
+	
+	
+	check = *pCheck;
+	
+	if((pHandle->checkType) == SM_CHECK_CRC16){
+		for(i=0; i<nbBytes; i++){
+			check = (uint16_t)((uint16_t)(check << 8) ^ SM_Crc16Table[((check >> 8) ^ pBytes[i]) & 0xFF]);
+		}
+	}
+	else{
+		for(i=0; i<nbBytes; i++){
+			check ^= (uint16_t)(pBytes[i]);
+		}
+	}
+	
+	*pCheck = check;
+}
+
+
+/**
+ * \fn static SM_Status SM_AbortBlockSend(SM_Handle *pHandle)
+ * \brief Gives up the blocks waiting for an ACK and releases the contexts locked for them.
+ * \param *pHandle Is a pointer on a #SM_Handle struct containing the current communication context.
+ * \return This function returns an #SM_Status error code to indicate if the function behaved as expected or not.
+ * 
+ * In legacy mode, the transmission process of the last block is ended without calling #SM_BlockSentCallback(), and so is the reception process started only to receive its ACK.
+ * In windowed mode, all the window slots are freed.
+ * The application is then notified with #SM_AckTimeoutCallback().
+ */
+static SM_Status SM_AbortBlockSend(SM_Handle *pHandle){
+	SM_RcvHandle *pRcvHandle;
+	SM_SendHandle *pSendHandle;
+	SEM_Status mutexRv;
+	SM_Status rv;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	pSendHandle = &(pHandle->sendHandle);
+	
+	pHandle->ackTimer.flagArmed = 0;
+	pHandle->ackTimer.nbRetries = 0;
+	
+	pRcvHandle->flagAckExpected = 0;
+	
+	if(SM_IsWindowedMode(pHandle) == SM_OK){
+		pSendHandle->nbBlocksInFlight = 0;
+	}
+	else{
+		/* A reception process without buffer has been started only to receive the ACK ...  */
+		if(((pRcvHandle->flagRcptOngoing) != 0) && ((pRcvHandle->pBuffer) == NULL) && ((pRcvHandle->pLinearBuffer) == NULL)){
+			mutexRv = SEM_Release(&(pRcvHandle->rcptProcessMutex));
+			if(mutexRv != SEM_OK) return SM_ERR;
+			
+			pRcvHandle->flagRcptOngoing = 0;
+			
+			rv = SM_DisableRxneInterrupt_Callback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+		}
+		
+		if((pSendHandle->flagSendOngoing) != 0){
+			pSendHandle->flagEmpty = 1;
+			
+			rv = SM_DisableTxeInterrupt_Callback(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			
+			mutexRv = SEM_Release(&(pSendHandle->sendProcessMutex));
+			if(mutexRv != SEM_OK) return SM_ERR;
+			
+			pSendHandle->flagSendOngoing = 0;
+			
+			/* An ACK or a NACK may have been waiting for the transmission state machine ...  */
+			if((pSendHandle->flagAckExpected) != 0){
+				rv = SM_SendBlock(pHandle, NULL, SM_ACK_BLOCK);
+				if(rv != SM_OK) return SM_ERR;
+			}
+			else if((pSendHandle->flagNackExpected) != 0){
+				rv = SM_SendBlock(pHandle, NULL, SM_NACK_BLOCK);
+				if(rv != SM_OK) return SM_ERR;
+			}
+			else{
+				rv = SM_SendPendingFlowCtrlBlock(pHandle);
+				if(rv != SM_OK) return SM_ERR;
+			}
+		}
+	}
+	
+	rv = SM_AckTimeoutCallback(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+static void SM_InitAckTimer(SM_Handle *pHandle){
+	SM_AckTimer *pTimer;
+	
+	
+	pTimer = &(pHandle->ackTimer);
+	
+	pHandle->currentTime = 0;
+	
+	pTimer->flagArmed = 0;
+	pTimer->startTime = 0;
+	pTimer->timeout = SM_INITIAL_ACK_TIMEOUT;
+	pTimer->nbRetries = 0;
+	pTimer->flagRetransmitted = 0;
+	pTimer->flagRttMeasured = 0;
+	pTimer->srtt = 0;
+	pTimer->rttvar = 0;
+	pTimer->flagStartOnCompletion = 0;
+}
+
+
+/* Arms the ACK timer, it keeps running if it is already armed (the oldest unacknowledged block is the one timed) ...  */
+static void SM_StartAckTimer(SM_Handle *pHandle){
+	if((pHandle->ackTimer.flagArmed) != 0){
+		return;
+	}
+	
+	pHandle->ackTimer.startTime = pHandle->currentTime;
+	pHandle->ackTimer.flagArmed = 1;
+}
+
+
+/* Disarms the ACK timer when an ACK is received, the round trip time is measured only if the block has not been sent again (Karn's algorithm) ...  */
+static void SM_StopAckTimer(SM_Handle *pHandle){
+	SM_AckTimer *pTimer;
+	
+	
+	pTimer = &(pHandle->ackTimer);
+	
+	if(((pTimer->flagArmed) != 0) && ((pTimer->flagRetransmitted) == 0)){
+		SM_UpdateAckTimeout(pHandle, (pHandle->currentTime) - (pTimer->startTime));
+	}
+	
+	pTimer->flagArmed = 0;
+	pTimer->flagRetransmitted = 0;
+	pTimer->nbRetries = 0;
+	pTimer->flagStartOnCompletion = 0;
+}
+
+
+/* Updates the smoothed round trip time and its variation with a new measure, then derives the retransmission timeout (RFC 6298, Jacobson's algorithm with scaled integers) ...  */
+static void SM_UpdateAckTimeout(SM_Handle *pHandle, uint32_t rtt){
+	SM_AckTimer *pTimer;
+	int32_t err;
+	uint32_t timeout;
+	
+	
+	pTimer = &(pHandle->ackTimer);
+	
+	if((pTimer->flagRttMeasured) == 0){
+		pTimer->srtt = rtt << 3;
+		pTimer->rttvar = rtt << 1;
+		pTimer->flagRttMeasured = 1;
+	}
+	else{
+		err = (int32_t)(rtt) - (int32_t)((pTimer->srtt) >> 3);
+		pTimer->srtt = (uint32_t)((int32_t)(pTimer->srtt) + err);
+		
+		if(err < 0){
+			err = -err;
+		}
+		
+		err -= (int32_t)((pTimer->rttvar) >> 2);
+		pTimer->rttvar = (uint32_t)((int32_t)(pTimer->rttvar) + err);
+	}
+	
+	/* SRTT + 4 * RTTVAR ...  */
+	timeout = ((pTimer->srtt) >> 3) + (pTimer->rttvar);
+	
+	if(timeout < SM_MIN_ACK_TIMEOUT){
+		timeout = SM_MIN_ACK_TIMEOUT;
+	}
+	else if(timeout > SM_MAX_ACK_TIMEOUT){
+		timeout = SM_MAX_ACK_TIMEOUT;
+	}
+	
+	pTimer->timeout = timeout;
+}
+
+
+/* Tells which timer events are due according to the current time base (see SM_AdvanceTime()) ...  */
+static void SM_GetDueTimerEvents(SM_Handle *pHandle, uint32_t *pFlagAckTimeout, uint32_t *pFlagResume){
+	*pFlagAckTimeout = ((pHandle->ackTimer.flagArmed) != 0) && (((pHandle->currentTime) - (pHandle->ackTimer.startTime)) >= (pHandle->ackTimer.timeout));
+	*pFlagResume = ((pHandle->rcvHandle.flagPaused) != 0) && (((pHandle->currentTime) - (pHandle->rcvHandle.lastDropTime)) >= SM_RESUME_QUIET_TIME);
+}
+
+
+/* Called by SM_ProcessTimerEvents() with both contexts locked when no ACK came within the retransmission timeout ...  */
+static SM_Status SM_ProcessAckTimeout(SM_Handle *pHandle){
+	SM_AckTimer *pTimer;
+	SM_Status rv;
+	
+	
+	pTimer = &(pHandle->ackTimer);
+	
+	pTimer->flagArmed = 0;
+	pTimer->flagRetransmitted = 1;
+	
+	/* Exponential backoff, the next measures will bring it back to the round trip time estimation ...  */
+	pTimer->timeout = (pTimer->timeout) << 1;
+	if((pTimer->timeout) > SM_MAX_ACK_TIMEOUT){
+		pTimer->timeout = SM_MAX_ACK_TIMEOUT;
+	}
+	
+	if((pHandle->rcvHandle.flagAckExpected) == 0){
+		return SM_OK;
+	}
+	
+	/* In windowed mode the payloads are not kept, we only wait longer for the cumulative ACK ...  */
+	if(SM_IsWindowedMode(pHandle) == SM_OK){
+		if((pTimer->nbRetries) >= SM_MAX_NB_RETRIES){
+			rv = SM_AbortBlockSend(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			
+			return SM_OK;
+		}
+		
+		pTimer->nbRetries++;
+		SM_StartAckTimer(pHandle);
+		
+		return SM_OK;
+	}
+	
+	rv = SM_RetransmitLastBlock(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/* Counts the bytes which could not be processed and asks the computer to pause. Called with or without the reception context locked, it only touches the flow control fields ...  */
+static SM_Status SM_DropRcvdBytes(SM_Handle *pHandle, uint32_t nbBytes){
+	SM_RcvHandle *pRcvHandle;
+	SM_Status rv;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	
+	pRcvHandle->nbDroppedBytes += nbBytes;
+	pRcvHandle->lastDropTime = pHandle->currentTime;
+	
+	if((pRcvHandle->flagPaused) == 0){
+		pRcvHandle->flagPaused = 1;
+		
+		rv = SM_UpdateFlowCtrl(pHandle);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	
+	
+	return SM_OK;
+}
+
+
+/* Drops the block being currently received after some of its bytes have been lost, the state machine waits for the block to be sent again ...  */
+static SM_Status SM_DiscardPartialBlock(SM_Handle *pHandle){
+	SM_RcvHandle *pRcvHandle;
+	SM_Status rv;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	
+	if((pRcvHandle->flagRcptOngoing) == 0){
+		return SM_OK;
+	}
+	
+	switch(pRcvHandle->currentState){
+		case SM_RCVSTATE_ACK_CTRL_BYTE:
+		case SM_RCVSTATE_ACK_CHECK_MSB:
+			/* A partial ACK received right after a block, we wait for the ACK again ...  */
+			pRcvHandle->currentState = SM_RCVSTATE_CHECK;
+			break;
+			
+		case SM_RCVSTATE_CTRL_BYTE:
+		case SM_RCVSTATE_SEQ:
+		case SM_RCVSTATE_LEN_BYTE1:
+		case SM_RCVSTATE_LEN_BYTE2:
+		case SM_RCVSTATE_LEN_BYTE3:
+		case SM_RCVSTATE_DATA:
+		case SM_RCVSTATE_CHECK_MSB:
+			rv = SM_DropRcvdPayload(pHandle);
+			if(rv != SM_OK) return SM_ERR;
+			
+			pRcvHandle->currentState = SM_RCVSTATE_INIT;
+			
+			rv = SM_ApplyRcvState(pHandle, 0x00);
+			if(rv != SM_OK) return SM_ERR;
+			break;
+			
+		default:
+			break;
+	}
+	
+	
+	return SM_OK;
+}
+
+
+/* Sends a BUSY block when one of the pause conditions appears and a READY block when all of them are gone ...  */
+static SM_Status SM_UpdateFlowCtrl(SM_Handle *pHandle){
+	SM_RcvHandle *pRcvHandle;
+	uint32_t flagPause;
+	SM_Status rv;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	
+	flagPause = ((pRcvHandle->flagPaused) != 0) || ((pRcvHandle->flagPauseRequested) != 0) || ((pRcvHandle->flagNoRoom) != 0);
+	
+	if((flagPause != 0) && ((pRcvHandle->flagHostPaused) == 0)){
+		pRcvHandle->flagHostPaused = 1;
+		
+		rv = SM_SendFlowCtrlBlock(pHandle, SM_BUSY_BLOCK);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	else if((flagPause == 0) && ((pRcvHandle->flagHostPaused) != 0)){
+		pRcvHandle->flagHostPaused = 0;
+		
+		rv = SM_SendFlowCtrlBlock(pHandle, SM_READY_BLOCK);
+		if(rv != SM_OK) return SM_ERR;
+	}
+	
+	
+	return SM_OK;
+}
+
+
+/* The flow control state is shared with the reception interrupt (see SM_DropRcvdBytes()), it is only changed with the reception context locked ...  */
+static SM_Status SM_SetPauseRequested(SM_Handle *pHandle, uint32_t flagPauseRequested){
+	SEM_Status mutexRv;
+	SM_Status rv;
+	
+	
+	mutexRv = SEM_TryLock(&(pHandle->rcvHandle.contextAccessMutex));
+	if((mutexRv != SEM_LOCKED) && (mutexRv != SEM_UNLOCKED)) return SM_ERR;
+	
+	if(mutexRv == SEM_LOCKED){
+		return SM_BUSY;
+	}
+	
+	pHandle->rcvHandle.flagPauseRequested = flagPauseRequested;
+	
+	rv = SM_UpdateFlowCtrl(pHandle);
+	
+	mutexRv = SEM_Release(&(pHandle->rcvHandle.contextAccessMutex));
+	if(mutexRv != SEM_OK) return SM_ERR;
+	
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+/* Sends a BUSY or READY block now, or as soon as the transmission state machine is free. Only the last requested one is kept ...  */
+static SM_Status SM_SendFlowCtrlBlock(SM_Handle *pHandle, SM_CtrlBlockType type){
+	SM_Status rv;
+	
+	
+	pHandle->sendHandle.flowCtrlBlockToSend = type;
+	pHandle->sendHandle.flagFlowCtrlExpected = 1;
+	
+	rv = SM_SendPendingFlowCtrlBlock(pHandle);
+	if(rv != SM_OK) return SM_ERR;
+	
+	
+	return SM_OK;
+}
+
+
+static SM_Status SM_SendPendingFlowCtrlBlock(SM_Handle *pHandle){
+	SM_Status rv;
+	
+	
+	if((pHandle->sendHandle.flagFlowCtrlExpected) == 0){
+		return SM_OK;
+	}
+	
+	rv = SM_SendBlock(pHandle, NULL, pHandle->sendHandle.flowCtrlBlockToSend);
+	if((rv != SM_OK) && (rv != SM_BUSY)) return SM_ERR;
+	
+	if(rv == SM_OK){
+		pHandle->sendHandle.flagFlowCtrlExpected = 0;
+	}
+	
+	
+	return SM_OK;
+}
+
+
+/* Removes from the reception buffer the payload bytes already stored for the current (rejected or partial) data block ...  */
+static SM_Status SM_DropRcvdPayload(SM_Handle *pHandle){
+	SM_RcvHandle *pRcvHandle;
+	BUFF_Status buffRv;
+	
+	
+	pRcvHandle = &(pHandle->rcvHandle);
+	
+	if((SM_DoesThisBlockCarryAPayload(pRcvHandle->currentBlockType) != SM_OK) || ((pRcvHandle->flagDiscardBlock) != 0)){
+		return SM_OK;
+	}
+	
+	if((pRcvHandle->pLinearBuffer) != NULL){
+		pRcvHandle->pLinearBuffer->size -= pRcvHandle->nbDataRcvd;
+	}
+	else if((pRcvHandle->pBuffer) != NULL){
+		buffRv = BUFF_DropLast(pRcvHandle->pBuffer, pRcvHandle->nbDataRcvd);
+		if(buffRv != BUFF_OK) return SM_ERR;
+	}
+	
+	
+	return SM_OK;
+}
@@ -16,6 +16,7 @@ static void UART_EndRxTransfer(UART_HandleTypeDef *huart);
 static HAL_StatusTypeDef UART_EndTransmit_IT(UART_HandleTypeDef *huart);
 static HAL_StatusTypeDef UART_Transmit_IT(UART_HandleTypeDef *huart);
 static HAL_StatusTypeDef UART_Transmit_IT_continuous(UART_HandleTypeDef *huart);
+static void UART_DMARxEvent_continuous(DMA_HandleTypeDef *hdma);
 
 
 
@@ -67,6 +68,104 @@ HAL_StatusTypeDef HAL_UART_Receive_IT_continuous(UART_HandleTypeDef *huart)
 
 
 
+/**
+  * @brief  Receives continuously in a circular DMA buffer.
+  *         HAL_UART_RxEventCallback_continuous() is called on DMA half and full
+  *         transfer and when the line goes idle, the user reads the new bytes
+  *         up to the position given by the DMA counter (NDTR).
+  * @note   The DMA stream linked to huart->hdmarx has to be configured in
+  *         circular mode. Reception errors do not stop the transfer.
+  * @param  huart pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @param  pData Pointer to the circular buffer
+  * @param  Size Size of the circular buffer
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_Receive_DMA_continuous(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size)
+{
+  /* Check that a Rx process is not already ongoing */ 
+  if(huart->RxState == HAL_UART_STATE_READY)
+  {
+    if((pData == NULL) || (Size == 0U) || (huart->hdmarx == NULL))
+    {
+      return HAL_ERROR;
+    }
+    
+    /* Process Locked */
+    __HAL_LOCK(huart);
+    
+    huart->pRxBuffPtr = pData;
+    huart->RxXferSize = Size;
+    huart->RxXferCount = Size;
+    
+    huart->ErrorCode = HAL_UART_ERROR_NONE;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    
+    /* The half and full transfer events are both reported as a reception event */
+    huart->hdmarx->XferCpltCallback = UART_DMARxEvent_continuous;
+    huart->hdmarx->XferHalfCpltCallback = UART_DMARxEvent_continuous;
+    huart->hdmarx->XferErrorCallback = UART_DMAAbortOnError;
+    huart->hdmarx->XferAbortCallback = NULL;
+    
+    HAL_DMA_Start_IT(huart->hdmarx, (uint32_t)&huart->Instance->DR, (uint32_t)pData, Size);
+    
+    /* Clear the flags of a previous reception (read SR then DR) */
+    __HAL_UART_CLEAR_PEFLAG(huart);
+    
+    /* Process Unlocked */
+    __HAL_UNLOCK(huart);
+    
+    /* Enable the UART Error Interrupt and the Idle line Interrupt */
+    SET_BIT(huart->Instance->CR3, USART_CR3_EIE);
+    SET_BIT(huart->Instance->CR1, USART_CR1_IDLEIE);
+    
+    /* Enable the DMA transfer for the receiver request */
+    SET_BIT(huart->Instance->CR3, USART_CR3_DMAR);
+    
+    return HAL_OK;
+  }
+  else
+  {
+    return HAL_BUSY; 
+  }
+}
+
+
+
+/**
+  * @brief  Stops a reception started with HAL_UART_Receive_DMA_continuous().
+  *         The bytes not yet read from the circular buffer are lost.
+  * @param  huart pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_UART_AbortReceive_DMA_continuous(UART_HandleTypeDef *huart)
+{
+  /* Disable the Idle line, PE and ERR (Frame error, noise error, overrun error) interrupts */
+  CLEAR_BIT(huart->Instance->CR1, (USART_CR1_IDLEIE | USART_CR1_PEIE));
+  CLEAR_BIT(huart->Instance->CR3, USART_CR3_EIE);
+  
+  /* Disable the DMA transfer for the receiver request */
+  if(HAL_IS_BIT_SET(huart->Instance->CR3, USART_CR3_DMAR))
+  {
+    CLEAR_BIT(huart->Instance->CR3, USART_CR3_DMAR);
+    
+    if(huart->hdmarx != NULL)
+    {
+      huart->hdmarx->XferAbortCallback = NULL;
+      HAL_DMA_Abort(huart->hdmarx);
+    }
+  }
+  
+  huart->RxXferCount = 0U;
+  huart->RxState = HAL_UART_STATE_READY;
+  
+  return HAL_OK;
+}
+
+
+
+
 
 
 
@@ -96,6 +195,19 @@ void HAL_UART_IRQHandler_continuous(UART_HandleTypeDef *huart)
     }
   }  
 
+  /* UART in mode circular DMA Receiver -----------------------------------*/
+  /* The bytes are moved by the DMA, the line going idle ends a burst. The   */
+  /* user pends this interrupt to get the bytes received while it masked it. */
+  if(((cr3its & USART_CR3_DMAR) != RESET) && ((cr1its & USART_CR1_IDLEIE) != RESET))
+  {
+    if((isrflags & USART_SR_IDLE) != RESET)
+    {
+      __HAL_UART_CLEAR_IDLEFLAG(huart);
+    }
+    
+    HAL_UART_RxEventCallback_continuous(huart);
+  }
+
   /* If some errors occur */
   if((errorflags != RESET) && (((cr3its & USART_CR3_EIE) != RESET) || ((cr1its & (USART_CR1_RXNEIE | USART_CR1_PEIE)) != RESET)))
   {
@@ -135,7 +247,27 @@ void HAL_UART_IRQHandler_continuous(UART_HandleTypeDef *huart)
       /* If Overrun error occurs, or if any error occurs in DMA mode reception,
          consider error as blocking */
       dmarequest = HAL_IS_BIT_SET(huart->Instance->CR3, USART_CR3_DMAR);
-      if(((huart->ErrorCode & HAL_UART_ERROR_ORE) != RESET) || dmarequest)
+      if(dmarequest && (huart->hdmarx != NULL) && (huart->hdmarx->XferHalfCpltCallback == UART_DMARxEvent_continuous))
+      {
+        /* Circular DMA reception : the error flags are cleared (read SR then DR) 
+           and the transfer goes on, the protocol recovers from the lost bytes */
+        __HAL_UART_CLEAR_PEFLAG(huart);
+        HAL_UART_ErrorCallback(huart);
+        huart->ErrorCode = HAL_UART_ERROR_NONE;
+      }
+      else if(((cr1its & USART_CR1_RXNEIE) != RESET) && (huart->RxState == HAL_UART_STATE_BUSY_RX))
+      {
+        /* Continuous interrupt reception : the byte in error has been read above,
+           which clears the flags (read SR then DR). Otherwise they are cleared here.
+           The reception goes on, the error is only reported */
+        if((isrflags & USART_SR_RXNE) == RESET)
+        {
+          __HAL_UART_CLEAR_PEFLAG(huart);
+        }
+        HAL_UART_ErrorCallback(huart);
+        huart->ErrorCode = HAL_UART_ERROR_NONE;
+      }
+      else if(((huart->ErrorCode & HAL_UART_ERROR_ORE) != RESET) || dmarequest)
       {
         /* Blocking error : transfer is aborted
            Set the UART state ready to be able to start again the process,
@@ -468,6 +600,38 @@ __weak void HAL_UART_RxCpltCallback_continuous(UART_HandleTypeDef *huart, uint16
 
 
 
+/**
+  * @brief  Rx event callback of the circular DMA reception (half transfer,
+  *         full transfer or idle line), see HAL_UART_Receive_DMA_continuous().
+  * @param  huart pointer to a UART_HandleTypeDef structure that contains
+  *                the configuration information for the specified UART module.
+  * @retval None
+  */
+__weak void HAL_UART_RxEventCallback_continuous(UART_HandleTypeDef *huart)
+{
+  /* Prevent unused argument(s) compilation warning */
+  UNUSED(huart);
+  /* NOTE: This function Should not be modified, when the callback is needed,
+           the HAL_UART_RxEventCallback_continuous could be implemented in the user file
+   */
+}
+
+
+
+/**
+  * @brief  DMA UART half and full transfer callback of the circular reception.
+  * @param  hdma DMA handle.
+  * @retval None
+  */
+static void UART_DMARxEvent_continuous(DMA_HandleTypeDef *hdma)
+{
+  UART_HandleTypeDef* huart = ( UART_HandleTypeDef* )((DMA_HandleTypeDef* )hdma)->Parent;
+  
+  HAL_UART_RxEventCallback_continuous(huart);
+}
+
+
+
 
 
 /**
@@ -0,0 +1,265 @@
+/**
+ * \file bench_state_machine.c
+ * \copyright This file is part of the Card-Stalker project and is distributed under the GPLv3 license. See LICENSE file in the root directory of the project.
+ * Host benchmark of the serial link protocol state machine.
+ *
+ * It measures the average time (in nanoseconds) spent in the state machine for each byte of a data block, both in reception and in transmission.
+ * It is a rough indication of the maximum baudrate the interrupt routines can sustain, run it before and after any change on the per-byte path.
+ * Build and run it with "make bench".
+ */
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "state_machine.h"
+#include "bytes_buffer.h"
+
+
+
+#define BENCH_NB_ITERATIONS          ((uint32_t)(20000))
+#define BENCH_PAYLOAD_SIZE           ((uint32_t)(512))
+
+
+
+static uint64_t BENCH_GetTimeNs(void){
+	struct timespec ts;
+	
+	
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	
+	return ((uint64_t)(ts.tv_sec) * 1000000000ULL) + (uint64_t)(ts.tv_nsec);
+}
+
+
+static int BENCH_Check(SM_Status rv){
+	if(rv != SM_OK){
+		printf("Unexpected state machine error.\n");
+		return 1;
+	}
+	
+	return 0;
+}
+
+
+/* Reception of a data block followed by the transmission of its ACK ...  */
+static int BENCH_Reception(double *pNsPerByte){
+	SM_Handle handle;
+	BUFF_Buffer rcvBuffer;
+	uint64_t start, total;
+	uint32_t i, j;
+	uint8_t byte;
+	
+	
+	total = 0;
+	
+	for(i=0; i<BENCH_NB_ITERATIONS; i++){
+		if(BENCH_Check(SM_Init(&handle))) return 1;
+		if(BENCH_Check(SM_ReceiveBlock(&handle, &rcvBuffer))) return 1;
+		
+		start = BENCH_GetTimeNs();
+		
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, SM_DATA_BLOCK))) return 1;
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, (uint8_t)(BENCH_PAYLOAD_SIZE >> 16)))) return 1;
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, (uint8_t)(BENCH_PAYLOAD_SIZE >> 8)))) return 1;
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, (uint8_t)(BENCH_PAYLOAD_SIZE)))) return 1;
+		
+		for(j=0; j<BENCH_PAYLOAD_SIZE; j++){
+			if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, (uint8_t)(j)))) return 1;
+		}
+		
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, 0x00))) return 1;
+		
+		while((handle.sendHandle.flagSendOngoing) != 0){
+			if(BENCH_Check(SM_EvolveStateOnByteTransmission(&handle, &byte))) return 1;
+		}
+		
+		total += BENCH_GetTimeNs() - start;
+	}
+	
+	*pNsPerByte = (double)(total) / ((double)(BENCH_NB_ITERATIONS) * (double)(BENCH_PAYLOAD_SIZE));
+	
+	return 0;
+}
+
+
+/* Same as BENCH_LinearReception() but the payload is received in a linear buffer (see SM_ReceiveBlockLinear()) ...  */
+static int BENCH_LinearReception(double *pNsPerByte){
+	SM_Handle handle;
+	SM_LinearBuffer rcvBlock;
+	uint8_t array[BENCH_PAYLOAD_SIZE];
+	uint64_t start, total;
+	uint32_t i, j;
+	uint8_t byte;
+	
+	
+	rcvBlock.pData = array;
+	rcvBlock.maxSize = sizeof(array);
+	total = 0;
+	
+	for(i=0; i<BENCH_NB_ITERATIONS; i++){
+		if(BENCH_Check(SM_Init(&handle))) return 1;
+		if(BENCH_Check(SM_ReceiveBlockLinear(&handle, &rcvBlock))) return 1;
+		
+		start = BENCH_GetTimeNs();
+		
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, SM_DATA_BLOCK))) return 1;
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, (uint8_t)(BENCH_PAYLOAD_SIZE >> 16)))) return 1;
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, (uint8_t)(BENCH_PAYLOAD_SIZE >> 8)))) return 1;
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, (uint8_t)(BENCH_PAYLOAD_SIZE)))) return 1;
+		
+		for(j=0; j<BENCH_PAYLOAD_SIZE; j++){
+			if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, (uint8_t)(j)))) return 1;
+		}
+		
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, 0x00))) return 1;
+		
+		while((handle.sendHandle.flagSendOngoing) != 0){
+			if(BENCH_Check(SM_EvolveStateOnByteTransmission(&handle, &byte))) return 1;
+		}
+		
+		total += BENCH_GetTimeNs() - start;
+	}
+	
+	*pNsPerByte = (double)(total) / ((double)(BENCH_NB_ITERATIONS) * (double)(BENCH_PAYLOAD_SIZE));
+	
+	return 0;
+}
+
+
+/* Same as BENCH_Reception() but the whole frame is given in a single chunk ...  */
+static int BENCH_ChunkedReception(double *pNsPerByte){
+	SM_Handle handle;
+	BUFF_Buffer rcvBuffer;
+	uint64_t start, total;
+	uint32_t i;
+	uint8_t byte, frame[BENCH_PAYLOAD_SIZE + 5];
+	
+	
+	frame[0] = SM_DATA_BLOCK;
+	frame[1] = (uint8_t)(BENCH_PAYLOAD_SIZE >> 16);
+	frame[2] = (uint8_t)(BENCH_PAYLOAD_SIZE >> 8);
+	frame[3] = (uint8_t)(BENCH_PAYLOAD_SIZE);
+	for(i=0; i<BENCH_PAYLOAD_SIZE; i++){
+		frame[4 + i] = (uint8_t)(i);
+	}
+	frame[BENCH_PAYLOAD_SIZE + 4] = 0x00;
+	
+	total = 0;
+	
+	for(i=0; i<BENCH_NB_ITERATIONS; i++){
+		if(BENCH_Check(SM_Init(&handle))) return 1;
+		if(BENCH_Check(SM_ReceiveBlock(&handle, &rcvBuffer))) return 1;
+		
+		start = BENCH_GetTimeNs();
+		
+		if(BENCH_Check(SM_EvolveStateOnBytesReception(&handle, frame, sizeof(frame)))) return 1;
+		
+		while((handle.sendHandle.flagSendOngoing) != 0){
+			if(BENCH_Check(SM_EvolveStateOnByteTransmission(&handle, &byte))) return 1;
+		}
+		
+		total += BENCH_GetTimeNs() - start;
+	}
+	
+	*pNsPerByte = (double)(total) / ((double)(BENCH_NB_ITERATIONS) * (double)(BENCH_PAYLOAD_SIZE));
+	
+	return 0;
+}
+
+
+/* Transmission of a data block followed by the reception of its ACK ...  */
+static int BENCH_Transmission(double *pNsPerByte){
+	SM_Handle handle;
+	BUFF_Buffer sendBuffer;
+	uint64_t start, total;
+	uint32_t i, j;
+	uint8_t byte;
+	
+	
+	total = 0;
+	
+	for(i=0; i<BENCH_NB_ITERATIONS; i++){
+		BUFF_Init(&sendBuffer);
+		for(j=0; j<BENCH_PAYLOAD_SIZE; j++){
+			BUFF_Enqueue(&sendBuffer, (uint8_t)(j));
+		}
+		
+		if(BENCH_Check(SM_Init(&handle))) return 1;
+		if(BENCH_Check(SM_SendBlock(&handle, &sendBuffer, SM_DATA_BLOCK))) return 1;
+		
+		start = BENCH_GetTimeNs();
+		
+		while((handle.sendHandle.flagEmpty) == 0){
+			if(BENCH_Check(SM_EvolveStateOnByteTransmission(&handle, &byte))) return 1;
+		}
+		
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, SM_ACK_BLOCK))) return 1;
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, 0x00))) return 1;
+		
+		total += BENCH_GetTimeNs() - start;
+	}
+	
+	*pNsPerByte = (double)(total) / ((double)(BENCH_NB_ITERATIONS) * (double)(BENCH_PAYLOAD_SIZE));
+	
+	return 0;
+}
+
+
+/* Same as BENCH_Transmission() but the whole frame is produced in a single chunk ...  */
+static int BENCH_ChunkedTransmission(double *pNsPerByte){
+	SM_Handle handle;
+	BUFF_Buffer sendBuffer;
+	uint64_t start, total;
+	uint32_t i, j, nbBytes;
+	uint8_t frame[BENCH_PAYLOAD_SIZE + 5];
+	
+	
+	total = 0;
+	
+	for(i=0; i<BENCH_NB_ITERATIONS; i++){
+		BUFF_Init(&sendBuffer);
+		for(j=0; j<BENCH_PAYLOAD_SIZE; j++){
+			BUFF_Enqueue(&sendBuffer, (uint8_t)(j));
+		}
+		
+		if(BENCH_Check(SM_Init(&handle))) return 1;
+		if(BENCH_Check(SM_SendBlock(&handle, &sendBuffer, SM_DATA_BLOCK))) return 1;
+		
+		start = BENCH_GetTimeNs();
+		
+		if(BENCH_Check(SM_EvolveStateOnBytesTransmission(&handle, frame, sizeof(frame), &nbBytes))) return 1;
+		
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, SM_ACK_BLOCK))) return 1;
+		if(BENCH_Check(SM_EvolveStateOnByteReception(&handle, 0x00))) return 1;
+		
+		total += BENCH_GetTimeNs() - start;
+	}
+	
+	*pNsPerByte = (double)(total) / ((double)(BENCH_NB_ITERATIONS) * (double)(BENCH_PAYLOAD_SIZE));
+	
+	return 0;
+}
+
+
+int main(int argc, char *argv[]){
+	double rcvNsPerByte, linearRcvNsPerByte, chunkRcvNsPerByte, sendNsPerByte, chunkSendNsPerByte;
+	
+	
+	if(BENCH_Reception(&rcvNsPerByte)) return 1;
+	if(BENCH_LinearReception(&linearRcvNsPerByte)) return 1;
+	if(BENCH_ChunkedReception(&chunkRcvNsPerByte)) return 1;
+	if(BENCH_Transmission(&sendNsPerByte)) return 1;
+	if(BENCH_ChunkedTransmission(&chunkSendNsPerByte)) return 1;
+	
+	printf("Payload of %u bytes, %u iterations.\n", (unsigned)(BENCH_PAYLOAD_SIZE), (unsigned)(BENCH_NB_ITERATIONS));
+	printf("Reception    : %.2f ns/byte\n", rcvNsPerByte);
+	printf("Reception    : %.2f ns/byte (linear buffer)\n", linearRcvNsPerByte);
+	printf("Reception    : %.2f ns/byte (single chunk)\n", chunkRcvNsPerByte);
+	printf("Transmission : %.2f ns/byte\n", sendNsPerByte);
+	printf("Transmission : %.2f ns/byte (single chunk)\n", chunkSendNsPerByte);
+	
+	
+	return 0;
+}
@@ -23,6 +23,11 @@
 
 uint32_t globalFlagRxne;
 uint32_t globalFlagTxe;
+uint32_t globalComputerBaudrate;
+uint32_t globalFlagRts;
+uint32_t globalNbRtsDeassertions;
+uint32_t globalNbProcessingRequests;
+uint32_t globalFlagProcessOnRequest;
 
 
 
@@ -44,6 +49,25 @@ int main(void){
 	RUN_TEST(test_BRIDGE2_dataBlockNoAnswerFromCard);
 	RUN_TEST(test_BRIDGE2_coldReset);
 	RUN_TEST(test_BRIDGE2_TwoProcessesInARow_Case01);
+	RUN_TEST(test_BRIDGE2_sequenceBlockShouldWork);
+	RUN_TEST(test_BRIDGE2_helloBlockShouldNegotiateLink);
+	RUN_TEST(test_BRIDGE2_baudBlockShouldSwitchBaudrate);
+	RUN_TEST(test_BRIDGE2_baudBlockShouldRevertWithoutConfirmation);
+	RUN_TEST(test_BRIDGE2_rxBytesShouldWork);
+	RUN_TEST(test_BRIDGE2_rtsShouldHoldComputerDuringCardExchange);
+	RUN_TEST(test_BRIDGE2_rxErrorShouldDropPartialBlock);
+	RUN_TEST(test_BRIDGE2_rxRingShouldWork);
+	RUN_TEST(test_BRIDGE2_rcvdBlockShouldRequestProcessing);
+	RUN_TEST(test_BRIDGE2_cardT1FramingShouldEndAnswer);
+	RUN_TEST(test_BRIDGE2_atrShouldSetCardTiming);
+	RUN_TEST(test_BRIDGE2_cutThroughShouldForwardPayloadWhileReceiving);
+	RUN_TEST(test_BRIDGE2_answerStreamingShouldSendAnnouncedSize);
+	RUN_TEST(test_BRIDGE2_warmResetShouldAnswerWithAtr);
+	RUN_TEST(test_BRIDGE2_autoPpsShouldSwitchToTa1Rates);
+	RUN_TEST(test_BRIDGE2_clockBlockShouldLimitToFmax);
+	RUN_TEST(test_BRIDGE2_answerShouldBeQueuedWhileSendIsBusy);
+	RUN_TEST(test_BRIDGE2_receptionShouldBeRetriedWhenBusy);
+	RUN_TEST(test_BRIDGE2_malformedAtrShouldBeReceivedUntilSilence);
 	
 	return UNITY_END();
 }
@@ -81,6 +105,37 @@ BRIDGE2_Status BRIDGE2_DisableRxneInterrupt_Callback(void){
 }
 
 
+BRIDGE2_Status BRIDGE2_SetComputerBaudrate_Callback(uint32_t baudrate){
+	globalComputerBaudrate = baudrate;
+	
+	return BRIDGE2_OK;
+}
+
+
+BRIDGE2_Status BRIDGE2_SetRts_Callback(uint32_t flagReady){
+	globalFlagRts = flagReady;
+	
+	if(flagReady == 0){
+		globalNbRtsDeassertions++;
+	}
+	
+	return BRIDGE2_OK;
+}
+
+
+BRIDGE2_Status BRIDGE2_RequestProcessing_Callback(void){
+	globalNbProcessingRequests++;
+	
+	/* Emulates a processing interrupt which preempts the routine requesting it ...  */
+	if(globalFlagProcessOnRequest != 0){
+		globalFlagProcessOnRequest = 0;
+		return BRIDGE2_ProcessTimerInterrupt();
+	}
+	
+	return BRIDGE2_OK;
+}
+
+
 
 
 
@@ -452,7 +507,9 @@ void test_BRIDGE2_coldReset(void){
 	READER_HAL_CommSettings settings;
 	READER_Status readerRv;
 	BRIDGE2_Status rv;
+	uint32_t nbBytes;
 	uint8_t byte;
+	uint8_t bytes[32];
 	
 	
 	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
@@ -470,6 +527,8 @@ void test_BRIDGE2_coldReset(void){
 	
 	/* Setting up the expected behaviour from the reader side, preparing mocks ...  */
 	READER_HAL_DoColdReset_ExpectAndReturn(READER_OK);
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);  /* Silent card, no ATR */
+	READER_HAL_GetTick_IgnoreAndReturn(0);
 	
 	
 	/* Testing bridge behaviour ...  */
@@ -496,10 +555,21 @@ void test_BRIDGE2_coldReset(void){
 	
 	
 	/* The control block should be processed by the bridge now ...                         */
-	/* The bridge is expected to send the data to the card and get back the answer ...  */
+	/* The bridge is expected to reset the card and to answer with an ATR block reporting a silent card and the default waiting times ...  */
+	uint8_t expectedAnswerFrame[] = {SM_ATR_BLOCK, 0x00, 0x00, 0x15, BRIDGE2_RST_NO_ATR, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x64, 0x11, 0x0D, 0x04, 0x00, BRIDGE2_PPS_NONE, 0x01, 0x74, 0x01, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
 	rv = BRIDGE2_ProcessTimerInterrupt();
 	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
 	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
 	rv = BRIDGE2_ProcessTimerInterrupt();
 	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
 }
@@ -838,3 +908,1636 @@ void test_BRIDGE2_TwoProcessesInARow_Case01(void){
 // 2 in a row
 // check empty return
 // checking the interruot enable/disable callbacks
+
+
+
+void test_BRIDGE2_sequenceBlockShouldWork(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t i;
+	uint8_t byte;
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* Two commands, the card answers the first one only. The third command is truncated ...  */
+	uint8_t sequenceFrame[] = {SM_SEQUENCE_BLOCK, 0x00, 0x00, 0x0A, 0x00, 0x02, 0x00, 0xA4, 0x00, 0x01, 0xB0, 0x00, 0x05, 0xFF, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_SEQUENCE_BLOCK, 0x00, 0x00, 0x0B, BRIDGE2_SEQ_OK, 0x00, 0x02, 0x90, 0x00, BRIDGE2_SEQ_NO_ANSWER, 0x00, 0x00, BRIDGE2_SEQ_MALFORMED, 0x00, 0x00, 0x00};
+	
+	/* Setting up the expected behaviour from the reader side, preparing mocks ...  */
+	uint8_t expectedSentFrame[] = {0x00, 0xA4, 0xB0};
+	set_expected_CharFrame(expectedSentFrame, 3);
+	
+	uint8_t rcvdBytesFromCard[] = {0x90, 0x00};
+	emulate_RcvCharFrame(rcvdBytesFromCard, 2);
+	
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	
+	/* Testing bridge behaviour ...  */
+	for(i=0; i<sizeof(sequenceFrame); i++){
+		rv = BRIDGE2_ProcessRxneInterrupt(sequenceFrame[i]);
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	}
+	
+	/* Sequence block is received, the bridge should answer an ACK to the computer ...  */
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CTRL BYTE */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, byte);
+	
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CHECK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(0x00, byte);
+	
+	/* All the commands are executed and the answers are sent back in a single block ...  */
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	for(i=0; i<sizeof(expectedAnswerFrame); i++){
+		rv = BRIDGE2_ProcessTxeInterrupt(&byte);
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		TEST_ASSERT_EQUAL_UINT8(expectedAnswerFrame[i], byte);
+	}
+	
+	
+	/* The computer sends back an ACK ... */
+	rv = BRIDGE2_ProcessRxneInterrupt(SM_ACK_BLOCK);  /* Control block = ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessRxneInterrupt(0x00);  /* CHECK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+
+void test_BRIDGE2_helloBlockShouldNegotiateLink(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t i;
+	uint8_t byte;
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The computer asks for the LRC check and keeps the stop-and-wait mode ...  */
+	uint8_t helloFrame[] = {SM_HELLO_BLOCK, 0x00, 0x00, 0x03, BRIDGE2_PROTOCOL_VERSION, SM_CHECK_LRC, BRIDGE2_HELLO_KEEP, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_HELLO_BLOCK, 0x00, 0x00, 0x0C, BRIDGE2_PROTOCOL_VERSION, 0x00, (uint8_t)(BUFF_MAX_SIZE >> 8), (uint8_t)(BUFF_MAX_SIZE), 0x07, SM_MAX_WINDOW_SIZE, 0x00, 0x00, (uint8_t)(BRIDGE2_DEFAULT_COMPUTER_BAUDRATE >> 8), (uint8_t)(BRIDGE2_DEFAULT_COMPUTER_BAUDRATE), SM_CHECK_LRC, 0x01, 0x00};
+	
+	for(i=0; i<sizeof(helloFrame); i++){
+		rv = BRIDGE2_ProcessRxneInterrupt(helloFrame[i]);
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	}
+	
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CTRL BYTE */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, byte);
+	
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CHECK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(0x00, byte);
+	
+	/* The answer still uses the current link parameters ...  */
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	for(i=0; i<sizeof(expectedAnswerFrame); i++){
+		rv = BRIDGE2_ProcessTxeInterrupt(&byte);
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		TEST_ASSERT_EQUAL_UINT8(expectedAnswerFrame[i], byte);
+	}
+	
+	rv = BRIDGE2_ProcessRxneInterrupt(SM_ACK_BLOCK);  /* Control block = ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessRxneInterrupt(0x00);  /* CHECK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	/* The new parameters are applied once the answer has been acknowledged ...  */
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The next block carries an LRC, and so does its ACK ...  */
+	READER_HAL_DoColdReset_ExpectAndReturn(READER_OK);
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);  /* Silent card, no ATR */
+	READER_HAL_GetTick_IgnoreAndReturn(0);
+	
+	rv = BRIDGE2_ProcessRxneInterrupt(SM_COLD_RST_BLOCK);  /* Control block = cold reset */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessRxneInterrupt(SM_COLD_RST_BLOCK);  /* LRC */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CTRL BYTE */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, byte);
+	
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK LRC */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, byte);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+
+void test_BRIDGE2_baudBlockShouldSwitchBaudrate(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t i, j;
+	uint8_t byte;
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	globalComputerBaudrate = 0;
+	
+	
+	/* The computer asks for 115200 bauds, and sends the same block again at the new baudrate to confirm it ...  */
+	uint8_t baudFrame[] = {SM_BAUD_BLOCK, 0x00, 0x00, 0x04, 0x00, 0x01, 0xC2, 0x00, 0x00};
+	
+	for(j=0; j<2; j++){
+		for(i=0; i<sizeof(baudFrame); i++){
+			rv = BRIDGE2_ProcessRxneInterrupt(baudFrame[i]);
+			TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		}
+		
+		rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CTRL BYTE */
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, byte);
+		
+		rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CHECK */
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		TEST_ASSERT_EQUAL_UINT8(0x00, byte);
+		
+		/* The answer carries the baudrate used after its acknowledgement ...  */
+		rv = BRIDGE2_ProcessTimerInterrupt();
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		
+		for(i=0; i<sizeof(baudFrame); i++){
+			rv = BRIDGE2_ProcessTxeInterrupt(&byte);
+			TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+			TEST_ASSERT_EQUAL_UINT8(baudFrame[i], byte);
+		}
+		
+		rv = BRIDGE2_ProcessRxneInterrupt(SM_ACK_BLOCK);  /* Control block = ACK */
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		
+		rv = BRIDGE2_ProcessRxneInterrupt(0x00);  /* CHECK */
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		
+		rv = BRIDGE2_ProcessTimerInterrupt();
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		
+		TEST_ASSERT_EQUAL_UINT32(115200, globalComputerBaudrate);
+		
+		/* A byte sent by the computer at the previous baudrate is not an error until the switch is confirmed ...  */
+		if(j == 0){
+			rv = BRIDGE2_ProcessRxneInterrupt(0xEE);
+			TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		}
+	}
+	
+	/* The new baudrate has been confirmed, it is kept ...  */
+	rv = BRIDGE2_ProcessTick(BRIDGE2_BAUD_CONFIRM_TIMEOUT);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	TEST_ASSERT_EQUAL_UINT32(115200, globalComputerBaudrate);
+}
+
+
+
+void test_BRIDGE2_baudBlockShouldRevertWithoutConfirmation(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t i;
+	uint8_t byte;
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetComputerBaudrate(57600);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(57600, globalComputerBaudrate);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The computer asks for 2 Mbauds ...  */
+	uint8_t baudFrame[] = {SM_BAUD_BLOCK, 0x00, 0x00, 0x04, 0x00, 0x1E, 0x84, 0x80, 0x00};
+	
+	for(i=0; i<sizeof(baudFrame); i++){
+		rv = BRIDGE2_ProcessRxneInterrupt(baudFrame[i]);
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	}
+	
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CTRL BYTE */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CHECK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	for(i=0; i<sizeof(baudFrame); i++){
+		rv = BRIDGE2_ProcessTxeInterrupt(&byte);
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+		TEST_ASSERT_EQUAL_UINT8(baudFrame[i], byte);
+	}
+	
+	rv = BRIDGE2_ProcessRxneInterrupt(SM_ACK_BLOCK);  /* Control block = ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessRxneInterrupt(0x00);  /* CHECK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	TEST_ASSERT_EQUAL_UINT32(2000000, globalComputerBaudrate);
+	
+	
+	/* The computer never talks at the new baudrate, only a partial block is received ...  */
+	rv = BRIDGE2_ProcessRxneInterrupt(SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTick(BRIDGE2_BAUD_CONFIRM_TIMEOUT - 1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(2000000, globalComputerBaudrate);
+	
+	/* The tick does not touch the UART, the previous baudrate is restored by the processing it requests ...  */
+	globalNbProcessingRequests = 0;
+	
+	rv = BRIDGE2_ProcessTick(1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(2000000, globalComputerBaudrate);
+	TEST_ASSERT_TRUE(globalNbProcessingRequests > 0);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(57600, globalComputerBaudrate);
+	
+	
+	/* The partial block has been dropped, the bridge waits for a new block at the previous baudrate ...  */
+	READER_HAL_DoColdReset_ExpectAndReturn(READER_OK);
+	
+	rv = BRIDGE2_ProcessRxneInterrupt(SM_COLD_RST_BLOCK);  /* Control block = cold reset */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessRxneInterrupt(0x00);  /* CHECK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CTRL BYTE */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, byte);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+
+void test_BRIDGE2_rxBytesShouldWork(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t bytes[16];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* Setting up the expected behaviour from the reader side, preparing mocks ...  */
+	uint8_t expectedSentFrame[] = {0xAB, 0xCD};
+	set_expected_CharFrame(expectedSentFrame, 2);
+	
+	uint8_t rcvdBytesFromCard[] = {0x90, 0x00};
+	emulate_RcvCharFrame(rcvdBytesFromCard, 2);
+	
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	
+	/* The data block is delivered in two spans, as with a circular DMA buffer wrapping around ...  */
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0x90, 0x00, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(frame, 5);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessRxBytes(frame + 5, sizeof(frame) - 5);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(ackFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(ackFrame, bytes, sizeof(ackFrame));
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	/* The computer sends back an ACK ... */
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+void test_BRIDGE2_rtsShouldHoldComputerDuringCardExchange(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t bytes[16];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	globalFlagRts = 0;
+	globalNbRtsDeassertions = 0;
+	
+	/* The computer is allowed to send as soon as the flow control is enabled ...  */
+	rv = BRIDGE2_SetRtsFlowCtrl(1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_TRUE(globalFlagRts == 1);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetRtsFlowCtrl(0);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_ERR);
+	
+	
+	/* Setting up the expected behaviour from the reader side, preparing mocks ...  */
+	uint8_t expectedSentFrame[] = {0xAB, 0xCD};
+	set_expected_CharFrame(expectedSentFrame, 2);
+	
+	uint8_t rcvdBytesFromCard[] = {0x90, 0x00};
+	emulate_RcvCharFrame(rcvdBytesFromCard, 2);
+	
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_TRUE(globalFlagRts == 1);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	/* RTS is deasserted during the exchange with the card and asserted again afterwards ...  */
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(1, globalNbRtsDeassertions);
+	TEST_ASSERT_TRUE(globalFlagRts == 1);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(1, globalNbRtsDeassertions);
+}
+
+
+void test_BRIDGE2_rxErrorShouldDropPartialBlock(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	BRIDGE2_RxErrorCounters counters;
+	uint32_t nbBytes;
+	uint8_t bytes[16];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* Setting up the expected behaviour from the reader side, preparing mocks ...  */
+	uint8_t expectedSentFrame[] = {0xAB, 0xCD};
+	set_expected_CharFrame(expectedSentFrame, 2);
+	
+	uint8_t rcvdBytesFromCard[] = {0x90, 0x00};
+	emulate_RcvCharFrame(rcvdBytesFromCard, 2);
+	
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	
+	/* A framing error happens in the middle of a first block, the partial block is dropped ...  */
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0x90, 0x00, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(frame, 5);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessRxError(BRIDGE2_RX_ERR_FRAMING);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_GetRxErrorCounters(&counters);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(1, counters.nbFramingErrors);
+	TEST_ASSERT_EQUAL_UINT32(0, counters.nbParityErrors);
+	TEST_ASSERT_EQUAL_UINT32(1, counters.nbResyncs);
+	
+	/* The computer sends the whole block again, it is processed as usual ...  */
+	rv = BRIDGE2_ProcessRxBytes(frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(ackFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(ackFrame, bytes, sizeof(ackFrame));
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+void test_BRIDGE2_rxRingShouldWork(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	BRIDGE2_RxErrorCounters counters;
+	uint32_t nbBytes, i;
+	uint8_t bytes[16];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* Too many bytes for the ring, the lost byte costs the block being received ...  */
+	for(i=0; i<BRIDGE2_RX_RING_SIZE + 8; i++){
+		rv = BRIDGE2_PushRxByte(0xFF);
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	}
+	
+	rv = BRIDGE2_ProcessRxRing(0);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_GetRxErrorCounters(&counters);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(1, counters.nbOverrunErrors);
+	
+	
+	/* Setting up the expected behaviour from the reader side, preparing mocks ...  */
+	uint8_t expectedSentFrame[] = {0xAB, 0xCD};
+	set_expected_CharFrame(expectedSentFrame, 2);
+	
+	uint8_t rcvdBytesFromCard[] = {0x90, 0x00};
+	emulate_RcvCharFrame(rcvdBytesFromCard, 2);
+	
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	
+	/* The bytes are pushed by the reception interrupt and parsed by batches of 3 bytes ...  */
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0x90, 0x00, 0x00};
+	
+	for(i=0; i<sizeof(frame); i++){
+		rv = BRIDGE2_PushRxByte(frame[i]);
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	}
+	
+	rv = BRIDGE2_ProcessRxRing(3);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_NO);
+	
+	rv = BRIDGE2_ProcessRxRing(3);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_NO);
+	
+	rv = BRIDGE2_ProcessRxRing(3);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(ackFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(ackFrame, bytes, sizeof(ackFrame));
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	for(i=0; i<sizeof(ackFrame); i++){
+		rv = BRIDGE2_PushRxByte(ackFrame[i]);
+		TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	}
+	
+	rv = BRIDGE2_ProcessRxRing(0);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+void test_BRIDGE2_rcvdBlockShouldRequestProcessing(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t bytes[16];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	globalNbProcessingRequests = 0;
+	
+	
+	/* Setting up the expected behaviour from the reader side, preparing mocks ...  */
+	uint8_t expectedSentFrame[] = {0xAB, 0xCD};
+	set_expected_CharFrame(expectedSentFrame, 2);
+	
+	uint8_t rcvdBytesFromCard[] = {0x90, 0x00};
+	emulate_RcvCharFrame(rcvdBytesFromCard, 2);
+	
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	
+	/* The processing is woken up once the block is complete and acknowledged, not before ...  */
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(frame, sizeof(frame) - 1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(0, globalNbProcessingRequests);
+	
+	rv = BRIDGE2_ProcessRxBytes(frame + sizeof(frame) - 1, 1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(1, globalNbProcessingRequests);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	/* The acknowledgement of the answer wakes up the processing to start a new reception ...  */
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(2, globalNbProcessingRequests);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+void test_BRIDGE2_cardT1FramingShouldEndAnswer(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t bytes[16];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetCardFraming(BRIDGE2_CARD_FRAMING_T1_LRC);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetCardFraming(BRIDGE2_CARD_FRAMING_NONE);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_ERR);
+	
+	
+	/* Setting up the expected behaviour from the reader side, preparing mocks ...  */
+	/* The card answers with a complete T=1 block, the bridge does not wait for the silence timeout (no READER_TIMEOUT is expected) ...  */
+	uint8_t expectedSentFrame[] = {0x00, 0x00, 0x02, 0xAB, 0xCD, 0x66};
+	set_expected_CharFrame(expectedSentFrame, sizeof(expectedSentFrame));
+	
+	uint8_t rcvdBytesFromCard[] = {0x00, 0x00, 0x02, 0x90, 0x00, 0x92};
+	emulate_RcvCharFrame(rcvdBytesFromCard, sizeof(rcvdBytesFromCard));
+	
+	
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x06, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0x66, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x06, 0x00, 0x00, 0x02, 0x90, 0x00, 0x92, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+
+void test_BRIDGE2_atrShouldSetCardTiming(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	BRIDGE2_CardTiming timing;
+	uint32_t nbBytes;
+	uint8_t bytes[32];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The card answers the cold reset with an ATR offering T=1 with CWI=5 and BWI=4 in TB3 ...  */
+	/* The ATR is complete with its TCK byte, the bridge does not wait for the silence timeout ...  */
+	READER_HAL_DoColdReset_ExpectAndReturn(READER_OK);
+	
+	uint8_t atr[] = {0x3B, 0x80, 0x81, 0x21, 0x45, 0x65};
+	emulate_RcvCharFrame(atr, sizeof(atr));
+	
+	READER_HAL_GetFreq_IgnoreAndReturn(4000000);
+	READER_HAL_GetFi_IgnoreAndReturn(372);
+	READER_HAL_GetDi_IgnoreAndReturn(1);
+	READER_HAL_GetTick_IgnoreAndReturn(0);
+	
+	uint8_t resetFrame[] = {SM_COLD_RST_BLOCK, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(resetFrame, sizeof(resetFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	/* The ATR block carries the status, the duration of the reset, the waiting times now in use and the ATR ...  */
+	uint8_t expectedResetAnswer[] = {SM_ATR_BLOCK, 0x00, 0x00, 0x1B, BRIDGE2_RST_OK, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x97, 0x00, 0x00, 0x00, 0x05, 0x11, 0x05, 0x04, 0x01, BRIDGE2_PPS_NONE, 0x01, 0x74, 0x01, 0x3B, 0x80, 0x81, 0x21, 0x45, 0x65, 0x00};
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedResetAnswer), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedResetAnswer, bytes, sizeof(expectedResetAnswer));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	/* CWT = (11 + 2^5) x 372 / 4MHz = 4ms, BWT = (11 x 372 + 2^4 x 960 x 372) / 4MHz = 1430ms, plus 1ms of margin each ...  */
+	rv = BRIDGE2_GetCardTiming(&timing);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(1, timing.flagAtrParsed);
+	TEST_ASSERT_EQUAL_UINT8(5, timing.cwi);
+	TEST_ASSERT_EQUAL_UINT8(4, timing.bwi);
+	TEST_ASSERT_EQUAL_UINT32(1431, timing.firstByteTimeout);
+	TEST_ASSERT_EQUAL_UINT32(5, timing.interByteTimeout);
+	
+	
+	/* The computer reads the waiting times with an empty timing block ...  */
+	uint8_t queryFrame[] = {SM_TIMING_BLOCK, 0x00, 0x00, 0x00, 0x00};
+	uint8_t expectedQueryAnswer[] = {SM_TIMING_BLOCK, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x05, 0x97, 0x00, 0x00, 0x00, 0x05, 0x11, 0x05, 0x04, 0x01, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(queryFrame, sizeof(queryFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedQueryAnswer), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedQueryAnswer, bytes, sizeof(expectedQueryAnswer));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The computer overrides the wait for the first byte only, the inter-byte wait is kept ...  */
+	uint8_t overrideFrame[] = {SM_TIMING_BLOCK, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x32, 0x00, 0x00, 0x00, 0x00, 0x00};
+	uint8_t expectedOverrideAnswer[] = {SM_TIMING_BLOCK, 0x00, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x32, 0x00, 0x00, 0x00, 0x05, 0x11, 0x05, 0x04, 0x03, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(overrideFrame, sizeof(overrideFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedOverrideAnswer), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedOverrideAnswer, bytes, sizeof(expectedOverrideAnswer));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_GetCardTiming(&timing);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(1, timing.flagOverridden);
+	TEST_ASSERT_EQUAL_UINT32(50, timing.firstByteTimeout);
+	TEST_ASSERT_EQUAL_UINT32(5, timing.interByteTimeout);
+}
+
+
+
+void test_BRIDGE2_cutThroughShouldForwardPayloadWhileReceiving(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t bytes[16];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetCutThrough(1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetCutThrough(0);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_ERR);
+	
+	
+	uint8_t firstPart[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x04, 0x00, 0xA4};
+	uint8_t secondPart[] = {0x04, 0x00, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0x90, 0x00, 0x00};
+	
+	/* The first two payload bytes are received, they are sent to the card right away (only them are expected) ...  */
+	globalNbProcessingRequests = 0;
+	
+	rv = BRIDGE2_ProcessRxBytes(firstPart, sizeof(firstPart));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_TRUE(globalNbProcessingRequests != 0);
+	
+	uint8_t expectedFirstBytes[] = {0x00, 0xA4};
+	set_expected_CharFrame(expectedFirstBytes, sizeof(expectedFirstBytes));
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The end of the block is received, only the remaining bytes are sent to the card before getting its answer ...  */
+	rv = BRIDGE2_ProcessRxBytes(secondPart, sizeof(secondPart));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	uint8_t expectedLastBytes[] = {0x04, 0x00};
+	set_expected_CharFrame(expectedLastBytes, sizeof(expectedLastBytes));
+	
+	uint8_t rcvdBytesFromCard[] = {0x90, 0x00};
+	emulate_RcvCharFrame(rcvdBytesFromCard, sizeof(rcvdBytesFromCard));
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+
+void test_BRIDGE2_answerStreamingShouldSendAnnouncedSize(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t bytes[16];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetCardFraming(BRIDGE2_CARD_FRAMING_T1_LRC);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetAnswerStreaming(1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetAnswerStreaming(0);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_ERR);
+	
+	
+	/* The card stops in the middle of its block, the size announced by its LEN byte is sent anyway ...  */
+	uint8_t expectedSentFrame[] = {0x00, 0x00, 0x02, 0xAB, 0xCD, 0x66};
+	set_expected_CharFrame(expectedSentFrame, sizeof(expectedSentFrame));
+	
+	uint8_t rcvdBytesFromCard[] = {0x00, 0x00, 0x02, 0x90};
+	emulate_RcvCharFrame(rcvdBytesFromCard, sizeof(rcvdBytesFromCard));
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x06, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0x66, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x06, 0x00, 0x00, 0x02, 0x90, 0x00, 0x00, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+
+void test_BRIDGE2_warmResetShouldAnswerWithAtr(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t bytes[32];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The RST line is pulled low then released, the card stays powered and answers with a minimal ATR (T=0 only, no TCK) ...  */
+	READER_HAL_SetRstLine_ExpectAndReturn(READER_HAL_STATE_OFF, READER_OK);
+	READER_HAL_Delay_Ignore();
+	READER_HAL_SetRstLine_ExpectAndReturn(READER_HAL_STATE_ON, READER_OK);
+	
+	uint8_t atr[] = {0x3B, 0x00};
+	emulate_RcvCharFrame(atr, sizeof(atr));
+	
+	READER_HAL_GetFreq_IgnoreAndReturn(4000000);
+	READER_HAL_GetFi_IgnoreAndReturn(372);
+	READER_HAL_GetDi_IgnoreAndReturn(1);
+	READER_HAL_GetTick_IgnoreAndReturn(0);
+	
+	uint8_t resetFrame[] = {SM_WARM_RST_BLOCK, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	/* Default CWI=13 and BWI=4 : CWT = (11 + 2^13) x 372 / 4MHz = 763ms, BWT = 1430ms, plus 1ms of margin each ...  */
+	uint8_t expectedAnswerFrame[] = {SM_ATR_BLOCK, 0x00, 0x00, 0x17, BRIDGE2_RST_OK, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x97, 0x00, 0x00, 0x02, 0xFC, 0x11, 0x0D, 0x04, 0x01, BRIDGE2_PPS_NONE, 0x01, 0x74, 0x01, 0x3B, 0x00, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(resetFrame, sizeof(resetFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);  /* ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	/* A single block tells the computer that the card came back ...  */
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The RST line can not be pulled low, the waiting times derived from the previous ATR are not used anymore ...  */
+	READER_HAL_SetRstLine_ExpectAndReturn(READER_HAL_STATE_OFF, READER_ERR);
+	
+	rv = BRIDGE2_ProcessRxBytes(resetFrame, sizeof(resetFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);  /* ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(BRIDGE2_RST_CARD_ERR, bytes[4]);
+	TEST_ASSERT_EQUAL_UINT8(BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT, bytes[4 + 5 + 3]);
+	TEST_ASSERT_EQUAL_UINT8(BRIDGE2_DEFAULT_RECEIVE_SEND_TIMEOUT, bytes[4 + 5 + 7]);
+	TEST_ASSERT_EQUAL_UINT8(0x00, bytes[4 + 5 + 11]);
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+
+void test_BRIDGE2_autoPpsShouldSwitchToTa1Rates(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t bytes[32];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetAutoPps(1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_SetAutoPps(0);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_ERR);
+	
+	
+	/* The ATR offers Fi=372 and Di=4 in TA1 (T=0 only, no TCK), the card accepts them in its PPS response ...  */
+	READER_HAL_DoColdReset_ExpectAndReturn(READER_OK);
+	
+	uint8_t atr[] = {0x3B, 0x10, 0x13};
+	emulate_RcvCharFrame(atr, sizeof(atr));
+	
+	uint8_t ppsRequest[] = {0xFF, 0x10, 0x13, 0xFC};
+	set_expected_CharFrame(ppsRequest, sizeof(ppsRequest));
+	emulate_RcvCharFrame(ppsRequest, sizeof(ppsRequest));
+	
+	READER_HAL_SetEtu_ExpectAndReturn(&settings, 372, 4, READER_OK);
+	READER_HAL_SetEtu_IgnoreArg_pSettings();
+	
+	READER_HAL_GetFreq_IgnoreAndReturn(4000000);
+	READER_HAL_GetFi_IgnoreAndReturn(372);
+	READER_HAL_GetDi_IgnoreAndReturn(4);
+	READER_HAL_GetTick_IgnoreAndReturn(0);
+	
+	uint8_t resetFrame[] = {SM_COLD_RST_BLOCK, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	/* The waiting times are derived with the new Di : CWT = (11 + 2^13) x 372 / (4 x 4MHz) = 191ms, BWT = 11 ETU + 2^4 x 960 x 372 / 4MHz = 1429ms ...  */
+	uint8_t expectedAnswerFrame[] = {SM_ATR_BLOCK, 0x00, 0x00, 0x18, BRIDGE2_RST_OK, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x96, 0x00, 0x00, 0x00, 0xC0, 0x13, 0x0D, 0x04, 0x01, BRIDGE2_PPS_OK, 0x01, 0x74, 0x04, 0x3B, 0x10, 0x13, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(resetFrame, sizeof(resetFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);  /* ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The default rates are restored before the next reset, the card answers it with them ...  */
+	READER_HAL_SetEtu_ExpectAndReturn(&settings, 372, 1, READER_OK);
+	READER_HAL_SetEtu_IgnoreArg_pSettings();
+	READER_HAL_DoColdReset_ExpectAndReturn(READER_OK);
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);  /* Silent card, no ATR */
+	
+	rv = BRIDGE2_ProcessRxBytes(resetFrame, sizeof(resetFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);  /* ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(BRIDGE2_RST_NO_ATR, bytes[4]);
+	TEST_ASSERT_EQUAL_UINT8(BRIDGE2_PPS_NONE, bytes[4 + 5 + BRIDGE2_TIMING_ANSWER_SIZE]);
+	TEST_ASSERT_EQUAL_UINT8(0x01, bytes[4 + 8 + BRIDGE2_TIMING_ANSWER_SIZE]);
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The card does not answer the PPS request, it is reset again and kept at the default rates ...  */
+	READER_HAL_DoColdReset_ExpectAndReturn(READER_OK);
+	emulate_RcvCharFrame(atr, sizeof(atr));
+	set_expected_CharFrame(ppsRequest, sizeof(ppsRequest));
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	READER_HAL_SetRstLine_ExpectAndReturn(READER_HAL_STATE_OFF, READER_OK);
+	READER_HAL_Delay_Ignore();
+	READER_HAL_SetRstLine_ExpectAndReturn(READER_HAL_STATE_ON, READER_OK);
+	emulate_RcvCharFrame(atr, sizeof(atr));
+	
+	rv = BRIDGE2_ProcessRxBytes(resetFrame, sizeof(resetFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);  /* ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(BRIDGE2_RST_OK, bytes[4]);
+	TEST_ASSERT_EQUAL_UINT8(BRIDGE2_PPS_FAILED, bytes[4 + 5 + BRIDGE2_TIMING_ANSWER_SIZE]);
+	TEST_ASSERT_EQUAL_UINT8(0x01, bytes[4 + 8 + BRIDGE2_TIMING_ANSWER_SIZE]);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(atr, bytes + 4 + 9 + BRIDGE2_TIMING_ANSWER_SIZE, sizeof(atr));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+
+void test_BRIDGE2_clockBlockShouldLimitToFmax(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t bytes[32];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	READER_HAL_GetFreq_IgnoreAndReturn(5000000);
+	READER_HAL_GetFi_IgnoreAndReturn(372);
+	READER_HAL_GetDi_IgnoreAndReturn(1);
+	
+	/* Without ATR the card is limited to the default 5MHz, 8MHz is not applied ...  */
+	READER_HAL_SetFreq_ExpectAndReturn(&settings, 5000000, READER_OK);
+	READER_HAL_SetFreq_IgnoreArg_pSettings();
+	
+	uint8_t clockFrame[] = {SM_CLOCK_BLOCK, 0x00, 0x00, 0x04, 0x00, 0x7A, 0x12, 0x00, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	/* The answer reports the clock in use, the maximum one and an ETU of 372 / 5MHz = 74400ns ...  */
+	uint8_t expectedAnswerFrame[] = {SM_CLOCK_BLOCK, 0x00, 0x00, 0x0C, 0x00, 0x4C, 0x4B, 0x40, 0x00, 0x4C, 0x4B, 0x40, 0x00, 0x01, 0x22, 0xA0, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(clockFrame, sizeof(clockFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);  /* ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The clock set by the reader library is restored before the next reset ...  */
+	READER_HAL_SetFreq_ExpectAndReturn(&settings, 5000000, READER_OK);
+	READER_HAL_SetFreq_IgnoreArg_pSettings();
+	READER_HAL_DoColdReset_ExpectAndReturn(READER_OK);
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);  /* Silent card, no ATR */
+	READER_HAL_GetTick_IgnoreAndReturn(0);
+	
+	uint8_t resetFrame[] = {SM_COLD_RST_BLOCK, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(resetFrame, sizeof(resetFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);  /* ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_ATR_BLOCK, bytes[0]);
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+
+void test_BRIDGE2_answerShouldBeQueuedWhileSendIsBusy(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t byte, bytes[16];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* Setting up the expected behaviour from the reader side, preparing mocks ...  */
+	uint8_t expectedSentFrame[] = {0xAB, 0xCD};
+	set_expected_CharFrame(expectedSentFrame, 2);
+	
+	uint8_t rcvdBytesFromCard[] = {0x90, 0x00};
+	emulate_RcvCharFrame(rcvdBytesFromCard, 2);
+	
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0x90, 0x00, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CTRL BYTE */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, byte);
+	
+	
+	/* The block is processed as soon as it is requested, while the ACK is still being sent: the answer is ready before the state machine is free ...  */
+	globalNbProcessingRequests = 0;
+	globalFlagProcessOnRequest = 1;
+	
+	rv = BRIDGE2_ProcessTxeInterrupt(&byte);  /* ACK CHECK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT8(0x00, byte);
+	TEST_ASSERT_EQUAL_UINT32(0, globalFlagProcessOnRequest);
+	
+	/* The answer has been queued, not sent. The end of the ACK asks for another processing to send it ...  */
+	TEST_ASSERT_EQUAL_UINT32(0, globalFlagTxe);
+	TEST_ASSERT_EQUAL_UINT32(2, globalNbProcessingRequests);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(1, globalFlagTxe);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	
+	/* The ACK is expected from the moment the queued answer has been started, its reception starts the next block reception ...  */
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	set_expected_CharFrame(expectedSentFrame, 2);
+	emulate_RcvCharFrame(rcvdBytesFromCard, 2);
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	rv = BRIDGE2_ProcessRxBytes(frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(ackFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(ackFrame, bytes, sizeof(ackFrame));
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
+
+
+
+void test_BRIDGE2_receptionShouldBeRetriedWhenBusy(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	uint32_t nbBytes;
+	uint8_t bytes[16];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The bridge is started again while the previous reception is still waiting for a block, the new one can not be started ...  */
+	rv = BRIDGE2_Stop();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	/* The tick keeps asking for processing while the reception is pending ...  */
+	globalNbProcessingRequests = 0;
+	
+	rv = BRIDGE2_ProcessTick(1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(1, globalNbProcessingRequests);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTick(1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(2, globalNbProcessingRequests);
+	
+	
+	/* The block is received by the reception already running, the retried one starts once the answer is acknowledged ...  */
+	uint8_t expectedSentFrame[] = {0xAB, 0xCD};
+	set_expected_CharFrame(expectedSentFrame, 2);
+	
+	uint8_t rcvdBytesFromCard[] = {0x90, 0x00};
+	emulate_RcvCharFrame(rcvdBytesFromCard, 2);
+	
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0x90, 0x00, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);  /* ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(ackFrame), nbBytes);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	/* Nothing is pending anymore, the tick does not ask for processing ...  */
+	globalNbProcessingRequests = 0;
+	
+	rv = BRIDGE2_ProcessTick(1);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(0, globalNbProcessingRequests);
+}
+
+
+
+void test_BRIDGE2_malformedAtrShouldBeReceivedUntilSilence(void){
+	READER_HAL_CommSettings settings;
+	READER_Status readerRv;
+	BRIDGE2_Status rv;
+	BRIDGE2_CardTiming timing;
+	uint32_t nbBytes;
+	uint8_t bytes[32];
+	
+	
+	READER_HAL_InitWithDefaults_ExpectAnyArgsAndReturn(READER_OK);
+	
+	/* Initialization of the advanced bridge ...  */
+	readerRv = READER_HAL_InitWithDefaults(&settings);
+	TEST_ASSERT_TRUE(readerRv == READER_OK);
+	
+	rv = BRIDGE2_Init(&settings);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_Run();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The first byte is not a valid TS, the whole ATR is nevertheless received up to the silence of the card ...  */
+	READER_HAL_DoColdReset_ExpectAndReturn(READER_OK);
+	
+	uint8_t atr[] = {0x00, 0x11, 0x22, 0x33};
+	emulate_RcvCharFrame(atr, sizeof(atr));
+	
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	READER_HAL_GetFreq_IgnoreAndReturn(4000000);
+	READER_HAL_GetFi_IgnoreAndReturn(372);
+	READER_HAL_GetDi_IgnoreAndReturn(1);
+	READER_HAL_GetTick_IgnoreAndReturn(0);
+	
+	uint8_t resetFrame[] = {SM_COLD_RST_BLOCK, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(resetFrame, sizeof(resetFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);  /* ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	/* The ATR block reports a malformed ATR and carries all of its bytes ...  */
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(4 + BRIDGE2_RESET_ANSWER_HEADER_SIZE + sizeof(atr) + 1, nbBytes);
+	TEST_ASSERT_EQUAL_UINT8(SM_ATR_BLOCK, bytes[0]);
+	TEST_ASSERT_EQUAL_UINT8(BRIDGE2_RESET_ANSWER_HEADER_SIZE + sizeof(atr), bytes[3]);
+	TEST_ASSERT_EQUAL_UINT8(BRIDGE2_RST_MALFORMED, bytes[4]);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(atr, bytes + 4 + BRIDGE2_RESET_ANSWER_HEADER_SIZE, sizeof(atr));
+	
+	rv = BRIDGE2_GetCardTiming(&timing);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(0, timing.flagAtrParsed);
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	
+	/* The answer to the next command only carries what the card sends for it ...  */
+	uint8_t expectedSentFrame[] = {0xAB, 0xCD};
+	set_expected_CharFrame(expectedSentFrame, 2);
+	
+	uint8_t rcvdBytesFromCard[] = {0x90, 0x00};
+	emulate_RcvCharFrame(rcvdBytesFromCard, 2);
+	
+	READER_HAL_RcvChar_ExpectAnyArgsAndReturn(READER_TIMEOUT);
+	
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0xAB, 0xCD, 0x00};
+	uint8_t expectedAnswerFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x02, 0x90, 0x00, 0x00};
+	
+	rv = BRIDGE2_ProcessRxBytes(frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);  /* ACK */
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTxeBytes(bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedAnswerFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedAnswerFrame, bytes, sizeof(expectedAnswerFrame));
+	
+	rv = BRIDGE2_ProcessRxBytes(ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+	
+	rv = BRIDGE2_ProcessTimerInterrupt();
+	TEST_ASSERT_TRUE(rv == BRIDGE2_OK);
+}
@@ -16,6 +16,8 @@ BRIDGE2_Status BRIDGE2_EnableTxeInterrupt_Callback(void);
 BRIDGE2_Status BRIDGE2_DisableTxeInterrupt_Callback(void);
 BRIDGE2_Status BRIDGE2_EnableRxneInterrupt_Callback(void);
 BRIDGE2_Status BRIDGE2_DisableRxneInterrupt_Callback(void);
+BRIDGE2_Status BRIDGE2_SetComputerBaudrate_Callback(uint32_t baudrate);
+BRIDGE2_Status BRIDGE2_SetRts_Callback(uint32_t flagReady);
 
 
 void test_BRIDGE2_dataBlockShouldWork_Case01(void);
@@ -23,6 +25,25 @@ void test_BRIDGE2_dataBlockShouldWork_Case02(void);
 void test_BRIDGE2_dataBlockNoAnswerFromCard(void);
 void test_BRIDGE2_coldReset(void);
 void test_BRIDGE2_TwoProcessesInARow_Case01(void);
+void test_BRIDGE2_sequenceBlockShouldWork(void);
+void test_BRIDGE2_helloBlockShouldNegotiateLink(void);
+void test_BRIDGE2_baudBlockShouldSwitchBaudrate(void);
+void test_BRIDGE2_baudBlockShouldRevertWithoutConfirmation(void);
+void test_BRIDGE2_rxBytesShouldWork(void);
+void test_BRIDGE2_rtsShouldHoldComputerDuringCardExchange(void);
+void test_BRIDGE2_rxErrorShouldDropPartialBlock(void);
+void test_BRIDGE2_rxRingShouldWork(void);
+void test_BRIDGE2_rcvdBlockShouldRequestProcessing(void);
+void test_BRIDGE2_cardT1FramingShouldEndAnswer(void);
+void test_BRIDGE2_atrShouldSetCardTiming(void);
+void test_BRIDGE2_cutThroughShouldForwardPayloadWhileReceiving(void);
+void test_BRIDGE2_answerStreamingShouldSendAnnouncedSize(void);
+void test_BRIDGE2_warmResetShouldAnswerWithAtr(void);
+void test_BRIDGE2_autoPpsShouldSwitchToTa1Rates(void);
+void test_BRIDGE2_clockBlockShouldLimitToFmax(void);
+void test_BRIDGE2_answerShouldBeQueuedWhileSendIsBusy(void);
+void test_BRIDGE2_receptionShouldBeRetriedWhenBusy(void);
+void test_BRIDGE2_malformedAtrShouldBeReceivedUntilSilence(void);
 
 
 
@@ -35,6 +35,10 @@ int main(int argc, char *argv[]){
 	RUN_TEST(test_BUFF_case01);
 	RUN_TEST(test_BUFF_IsEmpty_shouldWork);
 	RUN_TEST(test_BUFF_case02);
+	RUN_TEST(test_BUFF_EnqueueBytes_shouldWrapAround);
+	RUN_TEST(test_BUFF_DequeueBytes_shouldWrapAround);
+	RUN_TEST(test_BUFF_Rewind_shouldWork);
+	RUN_TEST(test_BUFF_DropLast_shouldWork);
 	
 	return UNITY_END();
 }
@@ -359,3 +363,178 @@ void test_BUFF_case02(void){
 	TEST_ASSERT_TRUE(retVal == BUFF_OK);
 	TEST_ASSERT_EQUAL_UINT32(0, size);
 }
+
+
+void test_BUFF_EnqueueBytes_shouldWrapAround(void){
+	BUFF_Buffer buffer;
+	BUFF_Status retVal;
+	uint8_t bytes[BUFF_MAX_SIZE];
+	uint32_t i, size;
+	uint8_t byte;
+	
+	
+	for(i=0; i<BUFF_MAX_SIZE; i++){
+		bytes[i] = (uint8_t)(i);
+	}
+	
+	retVal = BUFF_Init(&buffer);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	/* We move the indexes close to the end of the array ...  */
+	for(i=0; i<(BUFF_MAX_SIZE - 2); i++){
+		retVal = BUFF_Enqueue(&buffer, 0xFF);
+		TEST_ASSERT_TRUE(retVal == BUFF_OK);
+		
+		retVal = BUFF_Dequeue(&buffer, &byte);
+		TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	}
+	
+	retVal = BUFF_EnqueueBytes(&buffer, bytes, 5);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	retVal = BUFF_GetCurrentSize(&buffer, &size);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT32(5, size);
+	
+	for(i=0; i<5; i++){
+		retVal = BUFF_Dequeue(&buffer, &byte);
+		TEST_ASSERT_TRUE(retVal == BUFF_OK);
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)(i), byte);
+	}
+	
+	/* Nothing is enqueued if all the bytes do not fit ...  */
+	retVal = BUFF_EnqueueBytes(&buffer, bytes, BUFF_MAX_SIZE - 1);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	retVal = BUFF_EnqueueBytes(&buffer, bytes, 2);
+	TEST_ASSERT_TRUE(retVal == BUFF_FULL);
+	
+	retVal = BUFF_GetCurrentSize(&buffer, &size);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT32(BUFF_MAX_SIZE - 1, size);
+}
+
+
+
+void test_BUFF_DequeueBytes_shouldWrapAround(void){
+	BUFF_Buffer buffer;
+	BUFF_Status retVal;
+	uint8_t bytes[5];
+	uint32_t i, size;
+	uint8_t byte;
+	
+	
+	retVal = BUFF_Init(&buffer);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	/* We move the indexes close to the end of the array ...  */
+	for(i=0; i<(BUFF_MAX_SIZE - 2); i++){
+		retVal = BUFF_Enqueue(&buffer, 0xFF);
+		TEST_ASSERT_TRUE(retVal == BUFF_OK);
+		
+		retVal = BUFF_Dequeue(&buffer, &byte);
+		TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	}
+	
+	for(i=0; i<5; i++){
+		retVal = BUFF_Enqueue(&buffer, (uint8_t)(i));
+		TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	}
+	
+	/* Nothing is dequeued if there are not enough bytes ...  */
+	retVal = BUFF_DequeueBytes(&buffer, bytes, 6);
+	TEST_ASSERT_TRUE(retVal == BUFF_EMPTY);
+	
+	retVal = BUFF_DequeueBytes(&buffer, bytes, 5);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	for(i=0; i<5; i++){
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)(i), bytes[i]);
+	}
+	
+	retVal = BUFF_GetCurrentSize(&buffer, &size);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT32(0, size);
+}
+
+
+
+void test_BUFF_Rewind_shouldWork(void){
+	BUFF_Buffer buffer;
+	BUFF_Status retVal;
+	uint8_t bytes[4];
+	uint32_t i, size;
+	
+	
+	retVal = BUFF_Init(&buffer);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	for(i=0; i<4; i++){
+		retVal = BUFF_Enqueue(&buffer, (uint8_t)(0xC0 + i));
+		TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	}
+	
+	retVal = BUFF_DequeueBytes(&buffer, bytes, 4);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	/* The dequeued bytes are given back to the buffer ...  */
+	retVal = BUFF_Rewind(&buffer, 4);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	retVal = BUFF_GetCurrentSize(&buffer, &size);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT32(4, size);
+	
+	retVal = BUFF_DequeueBytes(&buffer, bytes, 4);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	for(i=0; i<4; i++){
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)(0xC0 + i), bytes[i]);
+	}
+	
+	/* The buffer can not hold more than BUFF_MAX_SIZE bytes ...  */
+	retVal = BUFF_Rewind(&buffer, BUFF_MAX_SIZE + 1);
+	TEST_ASSERT_TRUE(retVal == BUFF_ERR);
+}
+
+
+
+void test_BUFF_DropLast_shouldWork(void){
+	BUFF_Buffer buffer;
+	BUFF_Status retVal;
+	uint32_t i, size;
+	uint8_t byte;
+	
+	
+	retVal = BUFF_Init(&buffer);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	for(i=0; i<5; i++){
+		retVal = BUFF_Enqueue(&buffer, (uint8_t)(i));
+		TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	}
+	
+	retVal = BUFF_DropLast(&buffer, 6);
+	TEST_ASSERT_TRUE(retVal == BUFF_ERR);
+	
+	retVal = BUFF_DropLast(&buffer, 3);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	retVal = BUFF_GetCurrentSize(&buffer, &size);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT32(2, size);
+	
+	/* The next enqueued byte takes the place of the first dropped one ...  */
+	retVal = BUFF_Enqueue(&buffer, 0xAA);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	
+	for(i=0; i<2; i++){
+		retVal = BUFF_Dequeue(&buffer, &byte);
+		TEST_ASSERT_TRUE(retVal == BUFF_OK);
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)(i), byte);
+	}
+	
+	retVal = BUFF_Dequeue(&buffer, &byte);
+	TEST_ASSERT_TRUE(retVal == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT8(0xAA, byte);
+}
@@ -22,6 +22,10 @@ void test_BUFF_IsFull_shouldWork_Case02(void);
 void test_BUFF_case01(void);
 void test_BUFF_IsEmpty_shouldWork(void);
 void test_BUFF_case02(void);
+void test_BUFF_EnqueueBytes_shouldWrapAround(void);
+void test_BUFF_DequeueBytes_shouldWrapAround(void);
+void test_BUFF_Rewind_shouldWork(void);
+void test_BUFF_DropLast_shouldWork(void);
 
 
 
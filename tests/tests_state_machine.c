@@ -17,12 +17,14 @@ uint32_t globalFlagBlockReceived;
 uint32_t globalFlagTxe;
 uint32_t globalFlagRxne;
 uint32_t globalFlagAckCallback;
+uint32_t globalFlagAckTimeout;
 
 
 void setUp(void){
 	globalFlagBlockSent = 0;
 	globalFlagBlockReceived = 0;
 	globalFlagAckCallback = 0;
+	globalFlagAckTimeout = 0;
 }
 
 
@@ -59,6 +61,24 @@ int main(){
 	RUN_TEST(test_SM_ACK_BLOCK_ReceivedCallback_Case01);
 	RUN_TEST(test_SM_ACK_BLOCK_ReceivedCallback_Case02);
 	RUN_TEST(test_SM_ACK_BLOCK_ReceivedCallback_Case03);
+	RUN_TEST(test_SM_WindowSizeDefaultIsStopAndWait);
+	RUN_TEST(test_SM_WindowedSendThroughput);
+	RUN_TEST(test_SM_WindowedCumulativeAckShouldFreeWindow);
+	RUN_TEST(test_SM_WindowedRcvQueueAndCumulativeAck);
+	RUN_TEST(test_SM_ReceiveDataBlockByChunksShouldWork);
+	RUN_TEST(test_SM_SendDataBlockByChunksShouldWork);
+	RUN_TEST(test_SM_SendDataBlockWithCrc16ShouldWork);
+	RUN_TEST(test_SM_CorruptedBlockShouldBeNacked);
+	RUN_TEST(test_SM_NackShouldTriggerRetransmission);
+	RUN_TEST(test_SM_AckTimeoutShouldTriggerRetransmission);
+	RUN_TEST(test_SM_AckTimeoutShouldGiveUpAfterMaxRetries);
+	RUN_TEST(test_SM_AckTimeoutShouldFollowRoundTripTime);
+	RUN_TEST(test_SM_DroppedBytesShouldPauseTheComputer);
+	RUN_TEST(test_SM_PauseAndResumeReception);
+	RUN_TEST(test_SM_ReceiveDataBlockInLinearBufferShouldWork);
+	RUN_TEST(test_SM_DiscardRcvdBlockShouldResynchronize);
+	RUN_TEST(test_SM_AckTimerShouldStartOnTransmissionComplete);
+	RUN_TEST(test_SM_StreamedBlockShouldWaitForItsPayload);
 	
 	return UNITY_END();
 }
@@ -75,6 +95,13 @@ SM_Status SM_ACK_BLOCK_ReceivedCallback(SM_Handle *pHandle){
 
 
 
+SM_Status SM_AckTimeoutCallback(SM_Handle *pHandle){
+	globalFlagAckTimeout = 1;
+	
+	return SM_OK;
+}
+
+
 SM_Status SM_BlockSentCallback(SM_Handle *pHandle){
 	globalFlagBlockSent = 1;
 	
@@ -1232,13 +1259,36 @@ void test_SM_rcvMutexShouldWork(void){
 	semRv = SEM_Release(&(handle.rcvHandle.contextAccessMutex));
 	TEST_ASSERT_TRUE(semRv == SEM_OK);
 	
-	///* A BUSY block should have been send from the bridge to the computer, we check that  ...  */
-	//rv = SM_EvolveStateOnByteTransmission(&handle, &byte);
-	//TEST_ASSERT_TRUE(rv == SM_OK);
-	//TEST_ASSERT_EQUAL_UINT8(SM_BUSY_BLOCK, byte);
+	/* A BUSY block should have been send from the bridge to the computer, we check that  ...  */
+	rv = SM_EvolveStateOnByteTransmission(&handle, &byte);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_BUSY_BLOCK, byte);
+	
+	rv = SM_EvolveStateOnByteTransmission(&handle, &byte);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT8(0x00, byte);
+	
+	/* Once the computer stopped sending, the partial block is dropped and a READY block is sent ...  */
+	rv = SM_ProcessTick(&handle, SM_RESUME_QUIET_TIME);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(handle.rcvHandle.currentState == SM_RCVSTATE_INIT);
+	
+	rv = SM_EvolveStateOnByteTransmission(&handle, &byte);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_READY_BLOCK, byte);
+	
+	rv = SM_EvolveStateOnByteTransmission(&handle, &byte);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT8(0x00, byte);
+	
+	
+	/* The computer re sends the whole block ...                                         */
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);  /* Control block */
+	TEST_ASSERT_TRUE(rv == SM_OK);
 	
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);  /* LEN 1 */
+	TEST_ASSERT_TRUE(rv == SM_OK);
 	
-	/* The computer re sends the LEN 2 byte ...                                         */
 	rv = SM_EvolveStateOnByteReception(&handle, 0x00);  /* LEN 2 */
 	TEST_ASSERT_TRUE(rv == SM_OK);
 	
@@ -2179,3 +2229,1247 @@ void test_SM_ACK_BLOCK_ReceivedCallback_Case03(void){
 	/* We check that the ACK callback has been called ...  */
 	TEST_ASSERT_TRUE(globalFlagAckCallback == 1);
 }
+
+
+
+/* Transmits a whole block by emulating the TXE interrupts. Returns the number of bytes sent and puts them in pBytes ...  */
+static uint32_t SM_TestEmulateBlockTransmission(SM_Handle *pHandle, uint8_t *pBytes, uint32_t maxSize){
+	SM_Status rv;
+	uint32_t nbBytes;
+	
+	
+	nbBytes = 0;
+	
+	while((globalFlagTxe != 0) && (nbBytes < maxSize)){
+		rv = SM_EvolveStateOnByteTransmission(pHandle, pBytes + nbBytes);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		nbBytes++;
+	}
+	
+	return nbBytes;
+}
+
+
+static void SM_TestFillBuffer(BUFF_Buffer *pBuffer, uint32_t size, uint8_t firstByte){
+	BUFF_Status buffRv;
+	uint32_t i;
+	
+	
+	buffRv = BUFF_Init(pBuffer);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	
+	for(i=0; i<size; i++){
+		buffRv = BUFF_Enqueue(pBuffer, (uint8_t)(firstByte + i));
+		TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	}
+}
+
+
+void test_SM_WindowSizeDefaultIsStopAndWait(void){
+	BUFF_Buffer dataBuffer;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t windowSize;
+	uint8_t bytes[20];
+	
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_GetWindowSize(&handle, &windowSize);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(SM_DEFAULT_WINDOW_SIZE, windowSize);
+	TEST_ASSERT_EQUAL_UINT32(1, windowSize);
+	
+	/* Out of range window sizes are rejected ...  */
+	rv = SM_SetWindowSize(&handle, 0);
+	TEST_ASSERT_TRUE(rv == SM_ERR);
+	
+	rv = SM_SetWindowSize(&handle, SM_MAX_WINDOW_SIZE + 1);
+	TEST_ASSERT_TRUE(rv == SM_ERR);
+	
+	/* Legacy frame format : no sequence number after the control byte ...  */
+	SM_TestFillBuffer(&dataBuffer, 2, 0x10);
+	
+	rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	TEST_ASSERT_EQUAL_UINT32(7, SM_TestEmulateBlockTransmission(&handle, bytes, sizeof(bytes)));
+	TEST_ASSERT_EQUAL_UINT8(SM_DATA_BLOCK, bytes[0]);
+	TEST_ASSERT_EQUAL_UINT8(0x02, bytes[3]);
+	TEST_ASSERT_EQUAL_UINT8(0x10, bytes[4]);
+	
+	/* The window size can not be changed during a transmission process ...  */
+	rv = SM_SetWindowSize(&handle, 2);
+	TEST_ASSERT_TRUE(rv == SM_BUSY);
+	
+	/* We have to wait for the ACK ...  */
+	rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_BUSY);
+	
+	rv = SM_IsReadyToSend(&handle, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_NO);
+}
+
+
+void test_SM_WindowedSendThroughput(void){
+	BUFF_Buffer dataBuffer;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t windowSize, nbBlocks, nbBytes, size;
+	uint8_t bytes[20];
+	
+	
+	/* For each window size, we count how many blocks can be sent before having to wait for the first ACK ...  */
+	for(windowSize=1; windowSize<=SM_MAX_WINDOW_SIZE; windowSize++){
+		rv = SM_Init(&handle);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		rv = SM_SetWindowSize(&handle, windowSize);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		nbBlocks = 0;
+		nbBytes = 0;
+		
+		do{
+			SM_TestFillBuffer(&dataBuffer, 4, (uint8_t)(nbBlocks));
+			
+			rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+			TEST_ASSERT_TRUE((rv == SM_OK) || (rv == SM_BUSY));
+			
+			if(rv == SM_OK){
+				size = SM_TestEmulateBlockTransmission(&handle, bytes, sizeof(bytes));
+				TEST_ASSERT_EQUAL_UINT8(SM_DATA_BLOCK, bytes[0]);
+				
+				if(windowSize > 1){
+					TEST_ASSERT_EQUAL_UINT32(10, size);
+					TEST_ASSERT_EQUAL_UINT8((uint8_t)(nbBlocks), bytes[1]);   /* Sequence number */
+					TEST_ASSERT_EQUAL_UINT8((uint8_t)(nbBlocks), bytes[5]);   /* First data byte */
+				}
+				else{
+					TEST_ASSERT_EQUAL_UINT32(9, size);
+				}
+				
+				nbBlocks++;
+				nbBytes += size;
+			}
+		}while((rv == SM_OK) && (nbBlocks <= SM_MAX_WINDOW_SIZE));
+		
+		/* The number of blocks in flight is the window size ...  */
+		TEST_ASSERT_EQUAL_UINT32(windowSize, nbBlocks);
+		TEST_ASSERT_EQUAL_UINT32(windowSize * ((windowSize > 1) ? 10 : 9), nbBytes);
+		
+		/* The transmission state machine is free, only the window is full ...  */
+		if(windowSize > 1){
+			TEST_ASSERT_TRUE(globalFlagBlockSent == 1);
+			TEST_ASSERT_TRUE(SM_IsReadyToSend(&handle, SM_DATA_BLOCK) == SM_NO);
+			TEST_ASSERT_TRUE(SM_IsReadyToSend(&handle, SM_ACK_BLOCK) == SM_OK);
+		}
+	}
+}
+
+
+void test_SM_WindowedCumulativeAckShouldFreeWindow(void){
+	BUFF_Buffer dataBuffer;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t i;
+	uint8_t bytes[20];
+	
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SetWindowSize(&handle, 4);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* We fill the window (sequence numbers 0 to 3) ...  */
+	for(i=0; i<4; i++){
+		SM_TestFillBuffer(&dataBuffer, 1, 0xA0);
+		
+		rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		SM_TestEmulateBlockTransmission(&handle, bytes, sizeof(bytes));
+	}
+	
+	rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_BUSY);
+	
+	
+	/* The computer acknowledges blocks 0 and 1 with a single ACK ...  */
+	rv = SM_EvolveStateOnByteReception(&handle, SM_ACK_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnByteReception(&handle, 0x01);       /* Sequence number */
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);       /* LRC */
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	TEST_ASSERT_TRUE(globalFlagAckCallback == 1);
+	
+	
+	/* Two slots are available again ...  */
+	for(i=0; i<2; i++){
+		SM_TestFillBuffer(&dataBuffer, 1, 0xA0);
+		
+		rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		SM_TestEmulateBlockTransmission(&handle, bytes, sizeof(bytes));
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)(4 + i), bytes[1]);
+	}
+	
+	rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_BUSY);
+	
+	
+	/* An outdated ACK is ignored ...  */
+	globalFlagAckCallback = 0;
+	
+	rv = SM_EvolveStateOnByteReception(&handle, SM_ACK_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	TEST_ASSERT_TRUE(globalFlagAckCallback == 0);
+	TEST_ASSERT_TRUE(SM_IsReadyToSend(&handle, SM_DATA_BLOCK) == SM_NO);
+	
+	
+	/* The last ACK frees the whole window ...  */
+	rv = SM_EvolveStateOnByteReception(&handle, SM_ACK_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnByteReception(&handle, 0x05);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	TEST_ASSERT_TRUE(globalFlagAckCallback == 1);
+	TEST_ASSERT_TRUE(SM_IsReadyToSend(&handle, SM_DATA_BLOCK) == SM_OK);
+	TEST_ASSERT_TRUE(handle.rcvHandle.flagAckExpected == 0);
+}
+
+
+void test_SM_WindowedRcvQueueAndCumulativeAck(void){
+	BUFF_Buffer rcvBuffer;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	SM_Handle handle;
+	SM_CtrlBlockType type;
+	uint32_t size, i, j;
+	uint8_t byte, bytes[20];
+	
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SetWindowSize(&handle, 4);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlock(&handle, &rcvBuffer);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_GetRcvdBlockInfo(&handle, &type, &size);
+	TEST_ASSERT_TRUE(rv == SM_NO);
+	
+	
+	/* The computer sends three data blocks without waiting (sequence numbers 0, 1 and 2) ...  */
+	for(i=0; i<3; i++){
+		rv = SM_EvolveStateOnByteReception(&handle, SM_DATA_BLOCK);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		rv = SM_EvolveStateOnByteReception(&handle, (uint8_t)(i));     /* Sequence number */
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		rv = SM_EvolveStateOnByteReception(&handle, (uint8_t)(i + 1));  /* LEN 3 */
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		for(j=0; j<(i + 1); j++){
+			rv = SM_EvolveStateOnByteReception(&handle, (uint8_t)(0x10 * i + j));
+			TEST_ASSERT_TRUE(rv == SM_OK);
+		}
+		
+		rv = SM_EvolveStateOnByteReception(&handle, 0x00);               /* LRC */
+		TEST_ASSERT_TRUE(rv == SM_OK);
+	}
+	
+	/* A block with an unexpected sequence number is discarded ...  */
+	rv = SM_EvolveStateOnByteReception(&handle, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	rv = SM_EvolveStateOnByteReception(&handle, 0x07);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	rv = SM_EvolveStateOnByteReception(&handle, 0x01);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	rv = SM_EvolveStateOnByteReception(&handle, 0xEE);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* The reception is still running and nothing has been acknowledged yet ...  */
+	TEST_ASSERT_TRUE(globalFlagBlockReceived == 1);
+	TEST_ASSERT_TRUE(globalFlagRxne == 1);
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	
+	
+	/* We consume the first block, its release triggers the ACK ...  */
+	rv = SM_GetRcvdBlockInfo(&handle, &type, &size);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(type == SM_DATA_BLOCK);
+	TEST_ASSERT_EQUAL_UINT32(1, size);
+	
+	buffRv = BUFF_Dequeue(&rcvBuffer, &byte);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT8(0x00, byte);
+	
+	rv = SM_ReleaseRcvdBlock(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagTxe == 1);
+	
+	rv = SM_EvolveStateOnByteTransmission(&handle, &byte);   /* Control byte */
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, byte);
+	
+	rv = SM_EvolveStateOnByteTransmission(&handle, &byte);   /* Sequence number */
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT8(0x00, byte);
+	
+	
+	/* The two other blocks are released while the first ACK is being sent ...  */
+	for(i=1; i<3; i++){
+		rv = SM_GetRcvdBlockInfo(&handle, &type, &size);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		TEST_ASSERT_EQUAL_UINT32(i + 1, size);
+		
+		for(j=0; j<size; j++){
+			buffRv = BUFF_Dequeue(&rcvBuffer, &byte);
+			TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+			TEST_ASSERT_EQUAL_UINT8((uint8_t)(0x10 * i + j), byte);
+		}
+		
+		rv = SM_ReleaseRcvdBlock(&handle);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+	}
+	
+	rv = SM_GetRcvdBlockInfo(&handle, &type, &size);
+	TEST_ASSERT_TRUE(rv == SM_NO);
+	
+	rv = SM_ReleaseRcvdBlock(&handle);
+	TEST_ASSERT_TRUE(rv == SM_NO);
+	
+	/* The discarded block did not reach the buffer ...  */
+	TEST_ASSERT_TRUE(BUFF_IsEmpty(&rcvBuffer) == BUFF_OK);
+	
+	rv = SM_EvolveStateOnByteTransmission(&handle, &byte);   /* LRC */
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT8(0x00, byte);
+	
+	
+	/* A single cumulative ACK is chained for the blocks 1 and 2 ...  */
+	TEST_ASSERT_TRUE(globalFlagTxe == 1);
+	TEST_ASSERT_EQUAL_UINT32(3, SM_TestEmulateBlockTransmission(&handle, bytes, sizeof(bytes)));
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, bytes[0]);
+	TEST_ASSERT_EQUAL_UINT8(0x02, bytes[1]);
+	TEST_ASSERT_EQUAL_UINT8(0x00, bytes[2]);
+	
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	TEST_ASSERT_TRUE(handle.sendHandle.flagAckExpected == 0);
+}
+
+
+
+void test_SM_ReceiveDataBlockByChunksShouldWork(void){
+	BUFF_Buffer rcvBuffer;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	SM_Handle handle;
+	SM_CtrlBlockType type;
+	uint32_t size, i;
+	uint8_t byte;
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x06, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0x00};
+	uint8_t windowedFrames[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x00, 0x02, 0xB0, 0xB1, 0x00, SM_DATA_BLOCK, 0x01, 0x00, 0x00, 0x03, 0xC0, 0xC1, 0xC2, 0x00};
+	
+	
+	/* Stop and wait mode, the chunks are overlapping the header, the payload and the LRC ...  */
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlock(&handle, &rcvBuffer);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, frame, 2);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, frame + 2, 5);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, frame + 7, 4);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnByteTransmission(&handle, &byte);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, byte);
+	
+	rv = SM_EvolveStateOnByteTransmission(&handle, &byte);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT8(0x00, byte);
+	
+	TEST_ASSERT_TRUE(globalFlagBlockReceived == 1);
+	buffRv = BUFF_GetCurrentSize(&rcvBuffer, &size);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT32(6, size);
+	
+	for(i=0; i<6; i++){
+		buffRv = BUFF_Dequeue(&rcvBuffer, &byte);
+		TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)(0xA0 + i), byte);
+	}
+	
+	/* The reception process is over, the bytes can not be processed ...  */
+	rv = SM_EvolveStateOnBytesReception(&handle, frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == SM_ERR);
+	
+	
+	/* Windowed mode, two blocks in a single span ...  */
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SetWindowSize(&handle, 4);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlock(&handle, &rcvBuffer);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, windowedFrames, sizeof(windowedFrames));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_GetRcvdBlockInfo(&handle, &type, &size);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(type == SM_DATA_BLOCK);
+	TEST_ASSERT_EQUAL_UINT32(2, size);
+	
+	rv = SM_ReleaseRcvdBlock(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_GetRcvdBlockInfo(&handle, &type, &size);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(3, size);
+	
+	buffRv = BUFF_GetCurrentSize(&rcvBuffer, &size);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT32(5, size);
+	
+	for(i=0; i<2; i++){
+		buffRv = BUFF_Dequeue(&rcvBuffer, &byte);
+		TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)(0xB0 + i), byte);
+	}
+	
+	for(i=0; i<3; i++){
+		buffRv = BUFF_Dequeue(&rcvBuffer, &byte);
+		TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)(0xC0 + i), byte);
+	}
+}
+
+
+
+void test_SM_SendDataBlockByChunksShouldWork(void){
+	BUFF_Buffer dataBuffer;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t i, nbBytes;
+	uint8_t bytes[32];
+	uint8_t expectedFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x06, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5, 0x00};
+	
+	
+	buffRv = BUFF_Init(&dataBuffer);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	
+	for(i=0; i<6; i++){
+		buffRv = BUFF_Enqueue(&dataBuffer, (uint8_t)(0xA0 + i));
+		TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	}
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	
+	/* The first chunk stops in the middle of the payload ...  */
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, 6, &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(6, nbBytes);
+	TEST_ASSERT_TRUE(globalFlagTxe == 1);
+	
+	/* The second one is bigger than what remains, it stops at the end of the frame ...  */
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes + 6, sizeof(bytes) - 6, &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(5, nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedFrame, bytes, sizeof(expectedFrame));
+	
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	TEST_ASSERT_TRUE(globalFlagBlockSent == 0);
+	
+	
+	/* We emulate the reception of an ACK block + LRC ...  */
+	rv = SM_EvolveStateOnByteReception(&handle, SM_ACK_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	TEST_ASSERT_TRUE(globalFlagBlockSent == 1);
+}
+
+
+
+
+void test_SM_SendDataBlockWithCrc16ShouldWork(void){
+	BUFF_Buffer dataBuffer;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t i, nbBytes;
+	uint8_t bytes[32];
+	uint8_t expectedFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x03, 0x11, 0x22, 0x33, 0x78, 0xF5};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0xB1, 0x55};
+	
+	
+	buffRv = BUFF_Init(&dataBuffer);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	
+	for(i=0; i<3; i++){
+		buffRv = BUFF_Enqueue(&dataBuffer, (uint8_t)(0x11 * (i + 1)));
+		TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	}
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SetCheckType(&handle, SM_CHECK_CRC16);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* The check type can not be changed while a block is being sent ...  */
+	rv = SM_SetCheckType(&handle, SM_CHECK_LRC);
+	TEST_ASSERT_TRUE(rv == SM_BUSY);
+	
+	/* The CRC is sent most significant byte first ...  */
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedFrame, bytes, sizeof(expectedFrame));
+	
+	/* The ACK carries its own CRC ...  */
+	rv = SM_EvolveStateOnBytesReception(&handle, ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	TEST_ASSERT_TRUE(globalFlagBlockSent == 1);
+}
+
+
+
+void test_SM_CorruptedBlockShouldBeNacked(void){
+	BUFF_Buffer rcvBuffer;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t i, size, nbBytes;
+	uint8_t bytes[8];
+	uint8_t corruptedFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x03, 0x11, 0x22, 0x37, 0x03};
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x03, 0x11, 0x22, 0x33, 0x03};
+	uint8_t nackFrame[] = {SM_NACK_BLOCK, SM_NACK_BLOCK};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, SM_ACK_BLOCK};
+	
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SetCheckType(&handle, SM_CHECK_LRC);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlock(&handle, &rcvBuffer);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* The LRC of the first frame is wrong, it is answered with a NACK ...  */
+	rv = SM_EvolveStateOnBytesReception(&handle, corruptedFrame, sizeof(corruptedFrame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagBlockReceived == 0);
+	TEST_ASSERT_TRUE(globalFlagTxe == 1);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(nackFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(nackFrame, bytes, sizeof(nackFrame));
+	
+	buffRv = BUFF_GetCurrentSize(&rcvBuffer, &size);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT32(0, size);
+	
+	/* The same reception process goes on with the block sent again by the computer ...  */
+	rv = SM_EvolveStateOnBytesReception(&handle, frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(ackFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(ackFrame, bytes, sizeof(ackFrame));
+	
+	TEST_ASSERT_TRUE(globalFlagBlockReceived == 1);
+	
+	buffRv = BUFF_GetCurrentSize(&rcvBuffer, &size);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT32(3, size);
+	
+	for(i=0; i<3; i++){
+		TEST_ASSERT_EQUAL_UINT8(frame[4 + i], rcvBuffer.array[i]);
+	}
+}
+
+
+
+void test_SM_NackShouldTriggerRetransmission(void){
+	BUFF_Buffer dataBuffer;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t i, nbBytes;
+	uint8_t bytes[16];
+	uint8_t expectedFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x03, 0x11, 0x22, 0x33, 0x03};
+	uint8_t nackFrame[] = {SM_NACK_BLOCK, SM_NACK_BLOCK};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, SM_ACK_BLOCK};
+	
+	
+	buffRv = BUFF_Init(&dataBuffer);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	
+	for(i=0; i<3; i++){
+		buffRv = BUFF_Enqueue(&dataBuffer, (uint8_t)(0x11 * (i + 1)));
+		TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	}
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SetCheckType(&handle, SM_CHECK_LRC);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedFrame, bytes, sizeof(expectedFrame));
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	
+	/* The computer did not get the block right, it is sent again ...  */
+	rv = SM_EvolveStateOnBytesReception(&handle, nackFrame, sizeof(nackFrame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagTxe == 1);
+	TEST_ASSERT_TRUE(globalFlagBlockSent == 0);
+	
+	for(i=0; i<sizeof(bytes); i++){
+		bytes[i] = 0x00;
+	}
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedFrame, bytes, sizeof(expectedFrame));
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	TEST_ASSERT_TRUE(globalFlagBlockSent == 1);
+}
+
+
+void test_SM_AckTimeoutShouldTriggerRetransmission(void){
+	BUFF_Buffer dataBuffer;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t i, nbBytes, timeout;
+	uint8_t bytes[16];
+	uint8_t expectedFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x03, 0x11, 0x22, 0x33, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	
+	buffRv = BUFF_Init(&dataBuffer);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	
+	for(i=0; i<3; i++){
+		buffRv = BUFF_Enqueue(&dataBuffer, (uint8_t)(0x11 * (i + 1)));
+		TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	}
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_GetAckTimeout(&handle, &timeout);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(SM_INITIAL_ACK_TIMEOUT, timeout);
+	
+	rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedFrame), nbBytes);
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	
+	/* Nothing happens before the timeout ...  */
+	rv = SM_ProcessTick(&handle, timeout - 1);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	
+	/* The ACK is lost, the block is sent again and the timeout is doubled ...  */
+	rv = SM_ProcessTick(&handle, 1);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagTxe == 1);
+	TEST_ASSERT_TRUE(globalFlagBlockSent == 0);
+	
+	rv = SM_GetAckTimeout(&handle, &timeout);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(2 * SM_INITIAL_ACK_TIMEOUT, timeout);
+	
+	for(i=0; i<sizeof(bytes); i++){
+		bytes[i] = 0x00;
+	}
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(expectedFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedFrame, bytes, sizeof(expectedFrame));
+	
+	rv = SM_ProcessTick(&handle, 10);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagBlockSent == 1);
+	TEST_ASSERT_TRUE(globalFlagAckTimeout == 0);
+	
+	/* The ACK of a block sent again is not used to measure the round trip time ...  */
+	rv = SM_GetAckTimeout(&handle, &timeout);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(2 * SM_INITIAL_ACK_TIMEOUT, timeout);
+}
+
+
+void test_SM_AckTimeoutShouldGiveUpAfterMaxRetries(void){
+	BUFF_Buffer dataBuffer, rcvBuffer;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t i, nbBytes;
+	uint8_t bytes[16];
+	
+	
+	buffRv = BUFF_Init(&dataBuffer);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	
+	buffRv = BUFF_Enqueue(&dataBuffer, 0x42);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* Every attempt times out ...  */
+	for(i=0; i<SM_MAX_NB_RETRIES; i++){
+		rv = SM_ProcessTick(&handle, SM_MAX_ACK_TIMEOUT);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		TEST_ASSERT_TRUE(globalFlagTxe == 1);
+		TEST_ASSERT_TRUE(globalFlagAckTimeout == 0);
+		
+		rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		TEST_ASSERT_EQUAL_UINT32(6, nbBytes);
+	}
+	
+	rv = SM_ProcessTick(&handle, SM_MAX_ACK_TIMEOUT);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	TEST_ASSERT_TRUE(globalFlagAckTimeout == 1);
+	TEST_ASSERT_TRUE(globalFlagBlockSent == 0);
+	
+	/* Both state machines have been released ...  */
+	TEST_ASSERT_TRUE(handle.sendHandle.flagSendOngoing == 0);
+	TEST_ASSERT_TRUE(handle.rcvHandle.flagRcptOngoing == 0);
+	TEST_ASSERT_TRUE(handle.rcvHandle.flagAckExpected == 0);
+	
+	rv = SM_ReceiveBlock(&handle, &rcvBuffer);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SendBlock(&handle, NULL, SM_BUSY_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+}
+
+
+void test_SM_AckTimeoutShouldFollowRoundTripTime(void){
+	BUFF_Buffer dataBuffer;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t i, nbBytes, timeout;
+	uint8_t bytes[16];
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	for(i=0; i<16; i++){
+		buffRv = BUFF_Init(&dataBuffer);
+		TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+		
+		buffRv = BUFF_Enqueue(&dataBuffer, (uint8_t)(i));
+		TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+		
+		rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		/* The computer always answers within 30ms ...  */
+		rv = SM_ProcessTick(&handle, 30);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		rv = SM_EvolveStateOnBytesReception(&handle, ackFrame, sizeof(ackFrame));
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		TEST_ASSERT_TRUE(globalFlagBlockSent == 1);
+		
+		globalFlagBlockSent = 0;
+	}
+	
+	/* First measure gives SRTT + 4 * RTTVAR = 3 * RTT, then the variation fades away ...  */
+	rv = SM_GetAckTimeout(&handle, &timeout);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(timeout >= 30);
+	TEST_ASSERT_TRUE(timeout < 40);
+	TEST_ASSERT_TRUE(globalFlagAckTimeout == 0);
+}
+
+
+void test_SM_DroppedBytesShouldPauseTheComputer(void){
+	SM_Status rv;
+	BUFF_Status buffRv;
+	SM_Handle handle;
+	BUFF_Buffer rcptBuffer;
+	SEM_Status semRv;
+	uint32_t nbBytes, nbDroppedBytes;
+	uint8_t bytes[8];
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x01, 0x42, 0x00};
+	uint8_t busyFrame[] = {SM_BUSY_BLOCK, 0x00};
+	uint8_t readyFrame[] = {SM_READY_BLOCK, 0x00};
+	
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlock(&handle, &rcptBuffer);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, frame, 2);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* The context is locked, the byte is dropped and the computer is asked to pause ...  */
+	semRv = SEM_Lock(&(handle.rcvHandle.contextAccessMutex));
+	TEST_ASSERT_TRUE(semRv == SEM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, frame + 2, 1);
+	TEST_ASSERT_TRUE(rv == SM_BUSY);
+	
+	semRv = SEM_Release(&(handle.rcvHandle.contextAccessMutex));
+	TEST_ASSERT_TRUE(semRv == SEM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(busyFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(busyFrame, bytes, sizeof(busyFrame));
+	
+	/* The bytes still on their way are dropped too, and they delay the end of the pause ...  */
+	rv = SM_ProcessTick(&handle, SM_RESUME_QUIET_TIME - 1);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, frame + 3, 3);
+	TEST_ASSERT_TRUE(rv == SM_BUSY);
+	
+	rv = SM_ProcessTick(&handle, SM_RESUME_QUIET_TIME - 1);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	
+	rv = SM_GetNbDroppedBytes(&handle, &nbDroppedBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(4, nbDroppedBytes);
+	
+	rv = SM_ProcessTick(&handle, 1);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagTxe == 1);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(readyFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(readyFrame, bytes, sizeof(readyFrame));
+	
+	/* The computer sends the whole block again ...  */
+	rv = SM_EvolveStateOnBytesReception(&handle, frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(2, nbBytes);
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, bytes[0]);
+	TEST_ASSERT_TRUE(globalFlagBlockReceived == 1);
+	
+	/* Only the payload of the second attempt is in the buffer ...  */
+	buffRv = BUFF_GetCurrentSize(&rcptBuffer, &nbBytes);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT32(1, nbBytes);
+	
+	buffRv = BUFF_Dequeue(&rcptBuffer, bytes);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	TEST_ASSERT_EQUAL_UINT8(0x42, bytes[0]);
+}
+
+
+void test_SM_PauseAndResumeReception(void){
+	SM_Status rv;
+	SM_Handle handle;
+	BUFF_Buffer rcptBuffer;
+	SEM_Status semRv;
+	uint32_t nbBytes, nbDroppedBytes;
+	uint8_t bytes[8];
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x01, 0x42, 0x00};
+	
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlock(&handle, &rcptBuffer);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* The reception context is being used, nothing is changed ...  */
+	semRv = SEM_Lock(&(handle.rcvHandle.contextAccessMutex));
+	TEST_ASSERT_TRUE(semRv == SEM_OK);
+	
+	rv = SM_PauseReception(&handle);
+	TEST_ASSERT_TRUE(rv == SM_BUSY);
+	TEST_ASSERT_TRUE(handle.rcvHandle.flagPauseRequested == 0);
+	
+	semRv = SEM_Release(&(handle.rcvHandle.contextAccessMutex));
+	TEST_ASSERT_TRUE(semRv == SEM_OK);
+	
+	rv = SM_PauseReception(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* Pausing twice does not send a second BUSY block ...  */
+	rv = SM_PauseReception(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(2, nbBytes);
+	TEST_ASSERT_EQUAL_UINT8(SM_BUSY_BLOCK, bytes[0]);
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	
+	/* A block already on its way is still received ...  */
+	rv = SM_EvolveStateOnBytesReception(&handle, frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_GetNbDroppedBytes(&handle, &nbDroppedBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(0, nbDroppedBytes);
+	
+	/* The READY block is chained after the ACK of this block ...  */
+	rv = SM_ResumeReception(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(4, nbBytes);
+	TEST_ASSERT_EQUAL_UINT8(SM_ACK_BLOCK, bytes[0]);
+	TEST_ASSERT_EQUAL_UINT8(SM_READY_BLOCK, bytes[2]);
+	TEST_ASSERT_TRUE(globalFlagBlockReceived == 1);
+}
+
+
+
+void test_SM_ReceiveDataBlockInLinearBufferShouldWork(void){
+	SM_LinearBuffer rcvBlock;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t i, nbBytes;
+	uint8_t array[8];
+	uint8_t bytes[8];
+	uint8_t corruptedFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x03, 0x11, 0x22, 0x37, 0x03};
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x03, 0x11, 0x22, 0x33, 0x03};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, SM_ACK_BLOCK};
+	uint8_t tooLongFrame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x09};
+	
+	
+	rcvBlock.pData = array;
+	rcvBlock.maxSize = sizeof(array);
+	
+	/* Byte by byte, the payload lands contiguously in the array ...  */
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlockLinear(&handle, &rcvBlock);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(0, rcvBlock.size);
+	
+	rv = SM_EvolveStateOnByteReception(&handle, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	rv = SM_EvolveStateOnByteReception(&handle, 0x08);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	for(i=0; i<8; i++){
+		rv = SM_EvolveStateOnByteReception(&handle, (uint8_t)(0xA0 + i));
+		TEST_ASSERT_TRUE(rv == SM_OK);
+		
+		rv = SM_IsDataAvail(&handle);
+		TEST_ASSERT_TRUE(rv == SM_OK);
+	}
+	
+	rv = SM_EvolveStateOnByteReception(&handle, 0x00);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(2, nbBytes);
+	
+	TEST_ASSERT_TRUE(globalFlagBlockReceived == 1);
+	TEST_ASSERT_EQUAL_UINT32(8, rcvBlock.size);
+	
+	for(i=0; i<8; i++){
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)(0xA0 + i), array[i]);
+	}
+	
+	
+	/* By chunks, the payload of a rejected block is dropped from the array ...  */
+	globalFlagBlockReceived = 0;
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SetCheckType(&handle, SM_CHECK_LRC);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlockLinear(&handle, &rcvBlock);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, corruptedFrame, sizeof(corruptedFrame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagBlockReceived == 0);
+	TEST_ASSERT_EQUAL_UINT32(0, rcvBlock.size);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(ackFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(ackFrame, bytes, sizeof(ackFrame));
+	
+	TEST_ASSERT_TRUE(globalFlagBlockReceived == 1);
+	TEST_ASSERT_EQUAL_UINT32(3, rcvBlock.size);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(frame + 4, array, 3);
+	
+	
+	/* A payload which does not fit in the array is an error ...  */
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlockLinear(&handle, &rcvBlock);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, tooLongFrame, sizeof(tooLongFrame));
+	TEST_ASSERT_TRUE(rv == SM_ERR);
+	
+	
+	/* The windowed mode requires a circular buffer ...  */
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SetWindowSize(&handle, 4);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlockLinear(&handle, &rcvBlock);
+	TEST_ASSERT_TRUE(rv == SM_ERR);
+}
+
+
+
+void test_SM_DiscardRcvdBlockShouldResynchronize(void){
+	BUFF_Buffer rcvBuffer;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t nbBytes;
+	uint8_t bytes[8];
+	uint8_t garbage[] = {0xEE, 0x12};
+	uint8_t frame[] = {SM_DATA_BLOCK, 0x00, 0x00, 0x01, 0x42, 0x00};
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	
+	globalFlagBlockReceived = 0;
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_ReceiveBlock(&handle, &rcvBuffer);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* Bytes which can not be part of a block are an error, the reception context is left unlocked ...  */
+	rv = SM_EvolveStateOnBytesReception(&handle, garbage, sizeof(garbage));
+	TEST_ASSERT_TRUE(rv == SM_ERR);
+	
+	rv = SM_DiscardRcvdBlock(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* The next block is received normally ...  */
+	rv = SM_EvolveStateOnBytesReception(&handle, frame, sizeof(frame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(ackFrame), nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(ackFrame, bytes, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(globalFlagBlockReceived == 1);
+}
+
+
+void test_SM_AckTimerShouldStartOnTransmissionComplete(void){
+	BUFF_Buffer dataBuffer;
+	BUFF_Status buffRv;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t nbBytes, timeout;
+	uint8_t bytes[16];
+	uint8_t ackFrame[] = {SM_ACK_BLOCK, 0x00};
+	
+	
+	buffRv = BUFF_Init(&dataBuffer);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	
+	buffRv = BUFF_Enqueue(&dataBuffer, 0x42);
+	TEST_ASSERT_TRUE(buffRv == BUFF_OK);
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_SendBlock(&handle, &dataBuffer, SM_DATA_BLOCK);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* The whole frame is staged at once, it takes some time to get out of the transmitter ...  */
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	
+	rv = SM_ProcessTick(&handle, SM_INITIAL_ACK_TIMEOUT - 1);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	rv = SM_EvolveStateOnTransmissionComplete(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* The timeout is counted from the end of the transfer ...  */
+	rv = SM_ProcessTick(&handle, SM_INITIAL_ACK_TIMEOUT - 1);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	
+	rv = SM_EvolveStateOnBytesReception(&handle, ackFrame, sizeof(ackFrame));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagBlockSent == 1);
+	
+	/* Only the time spent after the transfer is measured as round trip time ...  */
+	rv = SM_GetAckTimeout(&handle, &timeout);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(3 * (SM_INITIAL_ACK_TIMEOUT - 1), timeout);
+}
+
+
+void test_SM_StreamedBlockShouldWaitForItsPayload(void){
+	BUFF_Buffer dataBuffer;
+	SM_Status rv;
+	SM_Handle handle;
+	uint32_t nbBytes;
+	uint8_t bytes[16];
+	uint8_t nextBytes[] = {0x12, 0x13};
+	
+	
+	rv = SM_Init(&handle);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	SM_TestFillBuffer(&dataBuffer, 2, 0x10);
+	
+	/* Pushing bytes is only possible in a streamed block ...  */
+	rv = SM_StreamBytes(&handle, nextBytes, sizeof(nextBytes));
+	TEST_ASSERT_TRUE(rv == SM_ERR);
+	
+	rv = SM_SendBlockStreamed(&handle, &dataBuffer, SM_DATA_BLOCK, 4);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	
+	/* The header announces the whole payload, the transmission stops after the available bytes ...  */
+	TEST_ASSERT_EQUAL_UINT32(6, SM_TestEmulateBlockTransmission(&handle, bytes, sizeof(bytes)));
+	TEST_ASSERT_EQUAL_UINT8(SM_DATA_BLOCK, bytes[0]);
+	TEST_ASSERT_EQUAL_UINT8(0x04, bytes[3]);
+	TEST_ASSERT_EQUAL_UINT8(0x11, bytes[5]);
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(0, nbBytes);
+	
+	rv = SM_StreamBytes(&handle, nextBytes, sizeof(nextBytes));
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_TRUE(globalFlagTxe == 1);
+	
+	/* No more than the announced payload, the bytes already pushed are still sent ...  */
+	rv = SM_StreamBytes(&handle, nextBytes, 1);
+	TEST_ASSERT_TRUE(rv == SM_ERR);
+	TEST_ASSERT_TRUE(globalFlagTxe == 1);
+	
+	rv = SM_EvolveStateOnBytesTransmission(&handle, bytes, sizeof(bytes), &nbBytes);
+	TEST_ASSERT_TRUE(rv == SM_OK);
+	TEST_ASSERT_EQUAL_UINT32(3, nbBytes);
+	TEST_ASSERT_EQUAL_UINT8_ARRAY(nextBytes, bytes, sizeof(nextBytes));
+	TEST_ASSERT_TRUE(globalFlagTxe == 0);
+}
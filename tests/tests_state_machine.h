@@ -44,6 +44,24 @@ void test_SM_EvolveStateOnByteTransmission_shouldResetTxeWhenDone(void);
 void test_SM_ACK_BLOCK_ReceivedCallback_Case01(void);
 void test_SM_ACK_BLOCK_ReceivedCallback_Case02(void);
 void test_SM_ACK_BLOCK_ReceivedCallback_Case03(void);
+void test_SM_WindowSizeDefaultIsStopAndWait(void);
+void test_SM_WindowedSendThroughput(void);
+void test_SM_WindowedCumulativeAckShouldFreeWindow(void);
+void test_SM_WindowedRcvQueueAndCumulativeAck(void);
+void test_SM_ReceiveDataBlockByChunksShouldWork(void);
+void test_SM_SendDataBlockByChunksShouldWork(void);
+void test_SM_SendDataBlockWithCrc16ShouldWork(void);
+void test_SM_CorruptedBlockShouldBeNacked(void);
+void test_SM_NackShouldTriggerRetransmission(void);
+void test_SM_AckTimeoutShouldTriggerRetransmission(void);
+void test_SM_AckTimeoutShouldGiveUpAfterMaxRetries(void);
+void test_SM_AckTimeoutShouldFollowRoundTripTime(void);
+void test_SM_DroppedBytesShouldPauseTheComputer(void);
+void test_SM_PauseAndResumeReception(void);
+void test_SM_ReceiveDataBlockInLinearBufferShouldWork(void);
+void test_SM_DiscardRcvdBlockShouldResynchronize(void);
+void test_SM_AckTimerShouldStartOnTransmissionComplete(void);
+void test_SM_StreamedBlockShouldWaitForItsPayload(void);
 
 
 